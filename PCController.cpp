@@ -74,55 +74,55 @@ SCBoolean PCController::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PCController::EvProcessCreate(const SCProcess*, const SCProcess*) 
+void PCController::EvProcessCreate(const PEEvent &) 
 {
   numProcesses++;
 }
 
 
-void PCController::EvProcessDelete(const SCProcess*)
+void PCController::EvProcessDelete(const PEEvent &)
 {
   numProcesses--;
 }
 
 
-void PCController::EvMachineCreate(const SCMachine*) 
+void PCController::EvMachineCreate(const PEEvent &) 
 {
   numMachines++;
 }
 
 
-void PCController::EvMachineDelete(const SCMachine*) 
+void PCController::EvMachineDelete(const PEEvent &) 
 {
   numMachines--;
 }
 
 
-void PCController::EvSignalConsume(const SCProcess*, const SCSignal*)
+void PCController::EvSignalConsume(const PEEvent &)
 {
   numSignals--;
 }
 
 
-void PCController::EvSignalDrop(const SCProcess*, const SCSignal*)
+void PCController::EvSignalDrop(const PEEvent &)
 {
   numSignals--;
 }
 
 
-void PCController::EvSignalReceive(const SCProcess*, const SCSignal*)
+void PCController::EvSignalReceive(const PEEvent &)
 {
   numSignals++;
 }
 
 
-void PCController::EvServiceRequest(const SCMachine*, const SCRequest*) 
+void PCController::EvServiceRequest(const PEEvent &) 
 {
   numRequests++;
 }
 
  
-void PCController::EvServiceFinish(const SCMachine*, const SCRequest*) 
+void PCController::EvServiceFinish(const PEEvent &) 
 {
   numRequests--;
 }
@@ -159,6 +159,7 @@ void PCController::Paint(void)
 
   // Hintergrund
   // ----------
+  ClearArea(0, 0, GetWidth(), GetHeight());
   DrawRaised(0, 0, GetWidth(), 40);             // Oben
   DrawRaised(0, 40, 168, GetHeight() - 40);    // Links
   DrawRaised(168, 40, 94, GetHeight() - 40);  // Rechts
@@ -174,7 +175,7 @@ void PCController::Paint(void)
   {
     int len = strlen(Label[i]);
     XSetForeground(xDpy, xGC, mForeground); 
-    XDrawImageString(xDpy, xWin, xGC, 
+    XDrawImageString(xDpy, xBuf, xGC, 
                      AlignVert -  XTextWidth(mMedium, Label[i], len) - 4,
                      y + 15,
                      Label[i], len);
@@ -189,7 +190,7 @@ void PCController::Paint(void)
   XSetFont(xDpy, xGC, mBold->fid);
   XSetForeground(xDpy, xGC, mForeground);
   XSetBackground(xDpy, xGC, mBackground);
-  XDrawImageString(xDpy, xWin, xGC, 31, 25, SimTime, strlen(SimTime));
+  XDrawImageString(xDpy, xBuf, xGC, 31, 25, SimTime, strlen(SimTime));
   DrawSimTime();
 
   // Pushbuttons zeichnen
@@ -217,11 +218,12 @@ void PCController::DrawSimTime(void)
 
   sprintf(Buffer, "%#.8g", Now());
   XSetForeground(xDpy, xGC, mSelected);
-  XFillRectangle(xDpy, xWin, xGC, x, y, w, h);
+  XFillRectangle(xDpy, xBuf, xGC, x, y, w, h);
   XSetForeground(xDpy, xGC, mForeground);
   XSetBackground(xDpy, xGC, mSelected);
   XSetFont(xDpy, xGC, BigFont->fid);
   DrawCenteredString(BigFont, Buffer, tx, ty + 6);
+  Invalidate(x, y, w, h);
 }
 
 void PCController::DrawCounters(void)
@@ -237,30 +239,32 @@ void PCController::DrawCounters(void)
 
   sprintf(Buffer, "%i", numProcesses);
   XSetForeground(xDpy, xGC, mSelected);
-  XFillRectangle(xDpy, xWin, xGC, x, y, w, h);
+  XFillRectangle(xDpy, xBuf, xGC, x, y, w, h);
   XSetForeground(xDpy, xGC, mForeground);
   DrawCenteredString(mBold, Buffer, AlignValueX, y + t);
 
   y += 29;
   sprintf(Buffer, "%i", numSignals);
   XSetForeground(xDpy, xGC, mSelected);
-  XFillRectangle(xDpy, xWin, xGC, x, y, w, h);
+  XFillRectangle(xDpy, xBuf, xGC, x, y, w, h);
   XSetForeground(xDpy, xGC, mForeground);
   DrawCenteredString(mBold, Buffer, AlignValueX, y + t);
 
   y += 29;
   sprintf(Buffer, "%i", numMachines);
   XSetForeground(xDpy, xGC, mSelected);
-  XFillRectangle(xDpy, xWin, xGC, x, y, w, h);
+  XFillRectangle(xDpy, xBuf, xGC, x, y, w, h);
   XSetForeground(xDpy, xGC, mForeground);
   DrawCenteredString(mBold, Buffer, AlignValueX, y + t);
   
   y += 29;
   sprintf(Buffer, "%i", numRequests);
   XSetForeground(xDpy, xGC, mSelected);
-  XFillRectangle(xDpy, xWin, xGC, x, y, w, h);
+  XFillRectangle(xDpy, xBuf, xGC, x, y, w, h);
   XSetForeground(xDpy, xGC, mForeground);
   DrawCenteredString(mBold, Buffer, AlignValueX, y + t);
+
+  Invalidate(x, 54, w, y + h - 54);
 }
 
 
@@ -285,13 +289,15 @@ void PCController::DrawButton(const XPoint& Pos, const char * Caption,
     XSetForeground(xDpy, xGC, mForeground);
     DrawCenteredString(mBold, Caption, Pos.x + Offset, Pos.y + TxMarg);
   }  
+  Invalidate(Pos.x, Pos.y, bWidth + 2, bHeight + 2);
 }
 
 
 void PCController::ClearButton(const XPoint& Button)
 {
   XSetForeground(xDpy, xGC, mBackground);
-  XFillRectangle(xDpy, xWin, xGC, Button.x, Button.y, bWidth, bHeight);
+  XFillRectangle(xDpy, xBuf, xGC, Button.x, Button.y, bWidth, bHeight);
+  Invalidate(Button.x, Button.y, bWidth, bHeight);
 }  
 
 
@@ -345,6 +351,9 @@ void PCController::Default(XEvent& ev)
                 {
                   xEventDispatcher.WaitForEvent();
                   xEventDispatcher.DoEvents();
+                  // Die Auswertung ruht (DoXEvents wartet vorher auf sie),
+                  // wieder sichtbare Displays koennen sofort gezeichnet werden
+                  if (xEventDispatcher.Revealed()) xEventDispatcher.UpdateDisplays();
                 }
                 pressed = bStop;
               }
@@ -38,15 +38,15 @@ class PCController: public PESensor, public PVDisplay
     // --------------------------------
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
     
-    void EvProcessCreate(const SCProcess*, const SCProcess*); 
-    void EvProcessDelete(const SCProcess*);
-    void EvMachineCreate(const SCMachine*); 
-    void EvMachineDelete(const SCMachine*);
-    void EvSignalConsume(const SCProcess*, const SCSignal*); 
-    void EvSignalReceive(const SCProcess*, const SCSignal*);
-    void EvSignalDrop(const SCProcess*, const SCSignal*);
-    void EvServiceRequest(const SCMachine*, const SCRequest*);
-    void EvServiceFinish(const SCMachine*, const SCRequest*);
+    void EvProcessCreate(const PEEvent &); 
+    void EvProcessDelete(const PEEvent &);
+    void EvMachineCreate(const PEEvent &); 
+    void EvMachineDelete(const PEEvent &);
+    void EvSignalConsume(const PEEvent &); 
+    void EvSignalReceive(const PEEvent &);
+    void EvSignalDrop(const PEEvent &);
+    void EvServiceRequest(const PEEvent &);
+    void EvServiceFinish(const PEEvent &);
      
     void   Reset(void)             {}          // Der Controller braucht 
     double GetValue(int) const     {return 0;} // diese Sensor- 
@@ -6,6 +6,14 @@
  Status: Verbessert von MD
 \******************************************************************************/   
 
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <iostream>
+
 #include "PCUpdater.h"
 
 #if _SC_DMALLOC
@@ -24,9 +32,11 @@ SCStream& operator<< (SCStream& pStream, const PCUpdater&)
 PCCurveUpdater::PCCurveUpdater(PDCurve *        Curve,
                                const PESensor * Sensor,
                                int              ValIndex) :
-  curve    (Curve),
-  sensor   (Sensor),
-  valIndex (ValIndex)
+  curve     (Curve),
+  sensor    (Sensor),
+  valIndex  (ValIndex),
+  lastTime  (0.0),
+  lastValue (-1.0)
 {
 }
 
@@ -34,9 +44,13 @@ PCCurveUpdater::PCCurveUpdater(PDCurve *        Curve,
 void PCCurveUpdater::Update(void)
 {
   double Value = sensor->GetValue(valIndex);
+  SCTime Now = sensor->Now();
 
-  if (Value >= 0)
-    curve->AddPoint(sensor->Now(), Value);
+  if (Value < 0 || (Value == lastValue && Now == lastTime))
+    return;                     // nichts Neues
+  curve->AddPoint(Now, Value);
+  lastTime = Now;
+  lastValue = Value;
 }
 
 
@@ -59,3 +73,338 @@ void PCFreqUpdater::Update(void)
   // ist die ganze Arbeit macht. freq ist in Zeiger
   // auf dieses enthaltene Objekt. MD
 }
+
+
+/******************************************************************************\
+ PCShmUpdater: Werte aller Sensoren im Shared Memory (Seqlock)
+\******************************************************************************/
+
+static const char shmMagic[8] = {'P', 'E', 'V', 'S', 'H', 'M', 'E', 'M'};
+
+enum { shmVersion = 1, shmPageSize = 4096 };
+
+
+PCShmUpdater::PCShmUpdater(const char * Name, SCList<PESensor> & Sensors) :
+  header     (NULL),
+  size       (0),
+  sensors    (Sensors),
+  numColumns (0),
+  maxColumns (16),
+  sources    (NULL),
+  counts     (NULL),
+  numSources (0),
+  current    (NULL)
+{
+  shmName = new char[strlen(Name) + 1];
+  strcpy(shmName, Name);
+  columns = new PCColumn[maxColumns];
+  values = new double[maxColumns];
+  namesSize = 1024;
+  namesUsed = 0;
+  names = new char[namesSize];
+
+  if ((fd = shm_open(shmName, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+  {
+    std::cerr << "Cannot create shared memory " << shmName << "!\n";
+    abort();
+  }
+  Resize(shmPageSize);
+  memcpy(header->magic, shmMagic, sizeof(shmMagic));
+  header->version = shmVersion;
+  header->size = size;
+  header->valuesOffset = sizeof(PCShmHeader);
+}
+
+
+PCShmUpdater::~PCShmUpdater(void)
+{
+  munmap(header, size);
+  close(fd);
+  shm_unlink(shmName);
+  delete[] shmName;
+  delete[] columns;
+  delete[] values;
+  delete[] names;
+  delete[] sources;
+  delete[] counts;
+}
+
+
+void PCShmUpdater::Update(void)
+{
+  SCNatural i;
+
+  if (Reshaped())  // Sensor oder Objekt hinzugekommen
+  {
+    Collect();
+    Relayout();
+    return;
+  }
+  for (i = 0; i < numColumns; i++)
+  {
+    values[i] = columns[i].sensor->ExportValue(columns[i].valIndex);
+  }
+  Publish();
+}
+
+
+SCBoolean PCShmUpdater::Reshaped(void) const
+{
+  SCNatural i;
+
+  if (sensors.NumOfElems() != numSources) return true;
+  for (i = 0; i < numSources; i++)
+  {
+    if (sources[i]->ExportCount() != counts[i]) return true;
+  }
+  return false;
+}
+
+
+// Legt die Spalten aller Sensoren neu an (ueber ExportAll und Record), mit
+// den aktuellen Werten im privaten Puffer
+void PCShmUpdater::Collect(void)
+{
+  SCListIter<PESensor> iter(sensors, false);  // Anmeldereihenfolge
+
+  delete[] sources;
+  delete[] counts;
+  numSources = sensors.NumOfElems();
+  sources = new const PESensor *[numSources];
+  counts = new SCNatural[numSources];
+
+  numColumns = 0;
+  namesUsed = 0;
+  for (numSources = 0; (current = iter++); numSources++)
+  {
+    sources[numSources] = current;
+    counts[numSources] = current->ExportCount();
+    BeginSensor(current->GetName());
+    current->ExportAll(*this);
+  }
+}
+
+
+void PCShmUpdater::Record(int ValIndex, double Value, const char * Name)
+{
+  PCColumn * column;
+  double *   value;
+
+  if (numColumns == maxColumns)
+  {
+    column = new PCColumn[maxColumns * 2];
+    memcpy(column, columns, numColumns * sizeof(PCColumn));
+    delete[] columns;
+    columns = column;
+    value = new double[maxColumns * 2];
+    memcpy(value, values, numColumns * sizeof(double));
+    delete[] values;
+    values = value;
+    maxColumns *= 2;
+  }
+  column = &columns[numColumns];
+  column->sensor = current;
+  column->valIndex = ValIndex;
+  column->sensorName = AddName(sensorName ? sensorName : "");
+  column->indexName = AddName(IndexName(ValIndex, Name));
+  values[numColumns++] = Value;
+}
+
+
+SCNatural PCShmUpdater::AddName(const char * Name)
+{
+  SCNatural length = strlen(Name) + 1;
+  SCNatural offset = namesUsed;
+  char *    buffer;
+
+  if (namesUsed + length > namesSize)
+  {
+    while (namesUsed + length > namesSize) namesSize *= 2;
+    buffer = new char[namesSize];
+    memcpy(buffer, names, namesUsed);
+    delete[] names;
+    names = buffer;
+  }
+  memcpy(names + namesUsed, Name, length);
+  namesUsed += length;
+
+  return offset;
+}
+
+
+// Seqlock: sequence ist waehrend des Schreibens ungerade. Die Leser
+// vergleichen sequence vor und nach dem Lesen und lesen bei Ungleichheit
+// erneut; der Schreiber wartet nie.
+void PCShmUpdater::Publish(void)
+{
+  unsigned long long sequence = header->sequence;
+
+  __atomic_store_n(&header->sequence, sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy((char *)header + header->valuesOffset, values,
+         numColumns * sizeof(double));
+  header->time = PESensor::Now();
+  header->ticks++;
+  __atomic_store_n(&header->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+
+// Schreibt Verzeichnis, Namen und Werte neu (ebenfalls unter dem Seqlock).
+// Das Segment waechst vorher, damit Leser nie ueber sein Ende lesen.
+void PCShmUpdater::Relayout(void)
+{
+  SCNatural          directory = sizeof(PCShmHeader);
+  SCNatural          strings = directory + numColumns * sizeof(PCShmEntry);
+  SCNatural          offset = (strings + namesUsed + 7) & ~(SCNatural)7;
+  SCNatural          needed = offset + numColumns * sizeof(double);
+  SCNatural          newSize = size;
+  unsigned long long sequence;
+  PCShmEntry *       entry;
+  SCNatural          i;
+
+  while (newSize < needed) newSize *= 2;
+  if (newSize != size) Resize(newSize);
+
+  sequence = header->sequence;
+  __atomic_store_n(&header->sequence, sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  entry = (PCShmEntry *)((char *)header + directory);
+  for (i = 0; i < numColumns; i++)
+  {
+    entry[i].sensorName = strings + columns[i].sensorName;
+    entry[i].indexName = strings + columns[i].indexName;
+    entry[i].valIndex = columns[i].valIndex;
+    entry[i].reserved = 0;
+  }
+  memcpy((char *)header + strings, names, namesUsed);
+  memset((char *)header + strings + namesUsed, 0, offset - strings - namesUsed);
+  memcpy((char *)header + offset, values, numColumns * sizeof(double));
+  header->numValues = numColumns;
+  header->valuesOffset = offset;
+  header->size = size;
+  header->layout++;
+  header->time = PESensor::Now();
+  header->ticks++;
+
+  __atomic_store_n(&header->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+
+void PCShmUpdater::Resize(SCNatural Size)
+{
+  void * base;
+
+  if (ftruncate(fd, Size) < 0)
+  {
+    std::cerr << "Cannot extend shared memory " << shmName << "!\n";
+    abort();
+  }
+  base = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED)
+  {
+    std::cerr << "Cannot map shared memory " << shmName << "!\n";
+    abort();
+  }
+  if (header) munmap(header, size);
+  header = (PCShmHeader *)base;
+  size = Size;
+}
+
+
+/******************************************************************************\
+ PCShmReader: Implementierung
+\******************************************************************************/
+
+PCShmReader::PCShmReader(const char * Name) :
+  header    (NULL),
+  size      (0),
+  numValues (0),
+  values    (NULL)
+{
+  struct stat status;
+
+  shmName = new char[strlen(Name) + 1];
+  strcpy(shmName, Name);
+
+  if ((fd = shm_open(shmName, O_RDONLY, 0)) < 0 || fstat(fd, &status) < 0 ||
+      (SCNatural)status.st_size < sizeof(PCShmHeader))
+  {
+    std::cerr << "Cannot open shared memory " << shmName << "!\n";
+    abort();
+  }
+  Map(status.st_size);
+  if (memcmp(header->magic, shmMagic, sizeof(shmMagic)) ||
+      header->version != shmVersion)
+  {
+    std::cerr << "Wrong format of shared memory " << shmName << "!\n";
+    abort();
+  }
+}
+
+
+PCShmReader::~PCShmReader(void)
+{
+  munmap((void *)header, size);
+  close(fd);
+  delete[] shmName;
+}
+
+
+unsigned long long PCShmReader::Begin(void)
+{
+  unsigned long long sequence;
+  unsigned long long newSize;
+  unsigned long long offset;
+
+  while ((sequence = __atomic_load_n(&header->sequence, __ATOMIC_ACQUIRE)) & 1);
+
+  newSize = header->size;
+  if (newSize > size) Map(newSize);
+
+  numValues = header->numValues;
+  offset = header->valuesOffset;
+  if (sizeof(PCShmHeader) + numValues * sizeof(PCShmEntry) > size ||
+      offset + numValues * sizeof(double) > size)
+  {
+    numValues = 0;           // ungueltig gelesen, Valid liefert false
+    offset = sizeof(PCShmHeader);
+  }
+  values = (const double *)((const char *)header + offset);
+
+  return sequence;
+}
+
+
+SCBoolean PCShmReader::Valid(unsigned long long Sequence) const
+{
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+  return __atomic_load_n(&header->sequence, __ATOMIC_RELAXED) == Sequence;
+}
+
+
+// Der Name muss samt '\0' in der Einblendung liegen
+const char * PCShmReader::Name(SCNatural Offset) const
+{
+  const char * name = (const char *)header + Offset;
+
+  if (Offset >= size || !memchr(name, '\0', size - Offset)) return "";
+  return name;
+}
+
+
+void PCShmReader::Map(SCNatural Size)
+{
+  void * base;
+
+  base = mmap(NULL, Size, PROT_READ, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED)
+  {
+    std::cerr << "Cannot map shared memory " << shmName << "!\n";
+    abort();
+  }
+  if (header) munmap((void *)header, size);
+  header = (const PCShmHeader *)base;
+  size = Size;
+}
@@ -15,6 +15,9 @@
 #ifndef __PDDATATYPE_H
 #include "PDDataType.h"
 #endif
+#ifndef __PEREPORTWRITER_H
+#include "PEReportWriter.h"
+#endif
 
 /******************************************************************************\
  PCUpdater: Abstrakte Basisklasse einer Verbindung zwischen einem Sensor und
@@ -25,6 +28,7 @@
 class PCUpdater // : public TSLinkTo<PCUpdater>
 {
   public:
+    virtual ~PCUpdater(void) {}    // Updater werden ueber die Liste geloescht
     virtual void Update(void) = 0; // Snapshotaktualisierung
 
     friend SCStream& operator<< (SCStream& pStream,
@@ -33,6 +37,9 @@ class PCUpdater // : public TSLinkTo<PCUpdater>
 
 /******************************************************************************\
  PCCurveUpdater: Transport von Daten zu einem PDCurve-Datenbehlter.  
+   Ein Wert, der zur selben Zeit schon uebertragen wurde, wird nicht noch
+   einmal angehaengt (die Kurve bleibt unveraendert, ihre Displays werden
+   nicht neu gezeichnet).
 \******************************************************************************/  
 
 class PCCurveUpdater: public PCUpdater
@@ -48,6 +55,8 @@ class PCCurveUpdater: public PCUpdater
     PDCurve*        curve;
     const PESensor* sensor;
     int             valIndex;
+    SCTime          lastTime;   // zuletzt uebertragener Punkt
+    double          lastValue;  // < 0: noch keiner
 };
 
 
@@ -68,4 +77,132 @@ class PCFreqUpdater: public PCUpdater
     const PESensor * sensor;
 };
 
+/******************************************************************************\
+ PCShmHeader: Aufbau des Shared-Memory-Segments von PCShmUpdater. Auf den
+   Kopf folgen numValues Verzeichniseintraege (PCShmEntry), die Namen (mit
+   '\0' abgeschlossen, Offsets ab Segmentanfang) und ab valuesOffset die
+   Werte (double). Alles ausser magic und version ist durch sequence
+   geschuetzt (Seqlock): ungerade waehrend der Schreiber aendert.
+\******************************************************************************/
+
+struct PCShmHeader
+{
+  char               magic[8];    // "PEVSHMEM"
+  unsigned int       version;
+  unsigned int       numValues;
+  unsigned long long sequence;
+  unsigned long long size;        // Bytes des Segments (kann wachsen)
+  unsigned long long layout;      // zaehlt Aenderungen des Verzeichnisses
+  unsigned long long ticks;       // Anzahl der Updates
+  unsigned long long valuesOffset;
+  double             time;        // Simulationszeit der Werte
+};
+
+struct PCShmEntry
+{
+  unsigned int sensorName;        // Offset des Sensornamens
+  unsigned int indexName;         // Offset des Namens des Wertindex
+  int          valIndex;          // wie bei PESensor::GetValue
+  unsigned int reserved;
+};
+
+/******************************************************************************\
+ PCShmUpdater: Legt bei jedem Update die Werte aller angemeldeten Sensoren
+   (je Wertindex, siehe PESensor::Export) in einem POSIX-Shared-Memory-
+   Segment ab, das andere Prozesse (z.B. ein externer Viewer) nur lesend
+   einblenden. Die Spalten (Sensor, Wertindex) werden einmal ueber
+   PESensor::ExportAll eingesammelt; bei jedem Update werden nur die Werte
+   (PESensor::ExportValue) in einen privaten Puffer geholt und unter dem
+   Seqlock mit einem memcpy kopiert. Leser halten den Schreiber nie auf,
+   auch nicht, wenn sie haengen oder abstuerzen.
+     Aendert sich die Menge der Werte (neue Sensoren, neue Objekte bei
+   Haeufigkeiten, erkannt an PESensor::ExportCount), werden die Spalten neu
+   eingesammelt, Verzeichnis und Namen neu geschrieben (layout zaehlt hoch)
+   und das Segment bei Bedarf vergroessert.
+\******************************************************************************/
+
+class PCShmUpdater: public PCUpdater, private PEReportWriter
+{
+  public:
+    PCShmUpdater(const char * Name, SCList<PESensor> & Sensors);
+    ~PCShmUpdater(void);          // entfernt das Segment
+
+    void Update(void);
+
+  private:
+    struct PCColumn
+    {
+      const PESensor * sensor;
+      int              valIndex;
+      SCNatural        sensorName; // Offsets in names (nur beim Neuaufbau)
+      SCNatural        indexName;
+    };
+
+    char *             shmName;
+    int                fd;
+    PCShmHeader *      header;    // eingeblendetes Segment
+    SCNatural          size;
+    SCList<PESensor> & sensors;
+    PCColumn *         columns;
+    double *           values;    // privater Puffer
+    char *             names;     // Namen fuer das Verzeichnis
+    SCNatural          namesUsed;
+    SCNatural          namesSize;
+    SCNatural          numColumns;
+    SCNatural          maxColumns;
+    const PESensor **  sources;   // Sensoren beim Einsammeln
+    SCNatural *        counts;    // je Sensor ExportCount beim Einsammeln
+    SCNatural          numSources;
+    const PESensor *   current;   // gerade eingesammelter Sensor
+
+    SCBoolean Reshaped(void) const;
+    void      Collect(void);
+    void      Relayout(void);
+    void      Publish(void);
+    void      Resize(SCNatural Size);
+    SCNatural AddName(const char * Name);
+    void EndReport(void) {}
+    void Record(int ValIndex, double Value, const char * Name = NULL);
+};
+
+/******************************************************************************\
+ PCShmReader: Einfacher Leser eines Segments von PCShmUpdater (nur lesend
+   eingeblendet). Die Werte werden direkt im Segment gelesen:
+     do { s = reader.Begin(); ... reader.Value(i) ... } while (!reader.Valid(s));
+   Begin blendet das Segment neu ein, wenn es gewachsen ist, und liest
+   Anzahl und Lage der Werte nur so weit, wie sie in die Einblendung passen;
+   was danach gelesen wurde, ist nur gueltig, wenn Valid true liefert.
+\******************************************************************************/
+
+class PCShmReader
+{
+  public:
+    PCShmReader(const char * Name);
+    ~PCShmReader(void);
+
+    unsigned long long Begin(void);
+    SCBoolean          Valid(unsigned long long Sequence) const;
+
+    SCNatural    NumValues(void) const { return numValues; }
+    SCTime       Time(void) const      { return header->time; }
+    double       Value(SCNatural i) const { return values[i]; }
+    const char * SensorName(SCNatural i) const { return Name(Entry(i).sensorName); }
+    const char * IndexName(SCNatural i) const  { return Name(Entry(i).indexName); }
+    int          ValIndex(SCNatural i) const   { return Entry(i).valIndex; }
+
+  private:
+    char *              shmName;
+    int                 fd;
+    const PCShmHeader * header;
+    SCNatural           size;      // eingeblendete Bytes
+    SCNatural           numValues; // bei Begin gelesen, passt in size
+    const double *      values;
+
+    const char * Name(SCNatural Offset) const;   // "" falls nicht im Segment
+
+    const PCShmEntry & Entry(SCNatural i) const
+      { return ((const PCShmEntry *)(header + 1))[i]; }
+    void Map(SCNatural Size);
+};
+
 #endif
@@ -12,10 +12,12 @@
 #include <SCL/SCStateType.h>
 
 #include <stdio.h>
+#include <math.h>
 #include <iostream>
 #include <string.h>
 
 #include "PDDataType.h"
+#include "PEEvent.h"
 
 #if _SC_DMALLOC
   #include <dmalloc.h>
@@ -28,7 +30,8 @@
 SCList<PDDataType> PDDataType::collection;
 
 PDDataType::PDDataType(const long dataColor) :
-  color(dataColor)
+  color(dataColor),
+  version(0)
 {
   container = collection.InsertAfter(this);
 }
@@ -61,22 +64,70 @@ PDCurve::PDCurve(int MaxPoints, const long dataColor) :
   maxPoints (MaxPoints),
   numPoints (0),
   first     (0),
-  last      (-1)
+  last      (-1),
+  history   (NULL),
+  store     (NULL),
+  column    (-1)
 {
   assert(MaxPoints > 4);
 
   point = new PDPoint[maxPoints];
+  lower = new PDPoint[2 * maxPoints];
+  upper = new PDPoint[2 * maxPoints];
+  for (int i = 2 * maxPoints; i--;)
+  {
+    lower[i].x = lower[i].y = HUGE_VAL;
+    upper[i].x = upper[i].y = -HUGE_VAL;
+  }
 }  
 
+
+PDCurve::PDCurve(PDCurveStore* Store, const long dataColor) :
+  PDDataType(dataColor),
+  maxPoints (Store->maxRows),
+  numPoints (0),
+  first     (0),
+  last      (-1),
+  point     (NULL),
+  history   (NULL),
+  lower     (NULL),
+  upper     (NULL),
+  store     (Store)
+{
+  store->Attach();
+  column = store->AddColumn();
+}
+
 PDCurve::~PDCurve(void)
 {
   delete[] point;
   point = NULL;
+  delete[] lower;
+  delete[] upper;
+  delete history;
+  if (store) store->Release();
+}
+
+
+void PDCurve::EnableHistory(int NumTiers)
+{
+  if (!history && NumTiers > 0)
+  {
+    history = new PDCurveHistory(NumTiers, maxPoints);
+  }
 }
 
 
 void PDCurve::AddPoint(double X, double Y)
 {
+  Touch();
+  if (history) history->AddPoint(X, Y);
+
+  if (store)
+  {
+    store->Set(column, X, Y);
+    return;
+  }
   if (numPoints == maxPoints)
   {
     if (!((last > 1) && (point[last].y == Y) && (point[last - 1].y == Y)))
@@ -91,21 +142,353 @@ void PDCurve::AddPoint(double X, double Y)
   }  
   point[last].x = X;
   point[last].y = Y;
+  UpdateMinMax(last);
+}
+
+
+// Blatt des veraenderten Platzes neu setzen und bis zur Wurzel (1) angleichen
+void PDCurve::UpdateMinMax(int Index)
+{
+  int i = Index + maxPoints;
+
+  lower[i] = upper[i] = point[Index];
+  for (i >>= 1; i; i >>= 1)
+  {
+    const PDPoint& l1 = lower[2 * i];
+    const PDPoint& l2 = lower[2 * i + 1];
+    const PDPoint& u1 = upper[2 * i];
+    const PDPoint& u2 = upper[2 * i + 1];
+
+    lower[i].x = l1.x < l2.x ? l1.x : l2.x;
+    lower[i].y = l1.y < l2.y ? l1.y : l2.y;
+    upper[i].x = u1.x > u2.x ? u1.x : u2.x;
+    upper[i].y = u1.y > u2.y ? u1.y : u2.y;
+  }
 }
 
 
 void PDCurve::GetMinMax(PDPoint& Min, PDPoint& Max) const
 {
-  Min.x = Max.x = point[0].x;
-  Min.y = Max.y = point[0].y;
+  if (store)
+  {
+    store->GetMinMax(column, Min, Max);
+    return;
+  }
+  if (!numPoints)
+  {
+    Min.x = Min.y = Max.x = Max.y = 0.0;
+    return;
+  }
+  Min = lower[1];
+  Max = upper[1];
+}
+
+
+/******************************************************************************\
+ PDCurveHistory: Implementierung
+\******************************************************************************/
+
+PDCurveHistory::PDCurveHistory(int NumTiers, int TierSize) :
+  numTiers (NumTiers),
+  tierSize (TierSize & ~1)
+{
+  assert(numTiers > 0 && tierSize >= 4);
+
+  tier = new PDTier[numTiers];
+  for (int i = 0; i < numTiers; i++)
+  {
+    tier[i].bucket = new PDBucket[tierSize];
+    tier[i].first = 0;
+    tier[i].num = 0;
+    tier[i].hasCarry = false;
+  }
+}
+
 
-  for (int i = numPoints; i--;)
+PDCurveHistory::~PDCurveHistory(void)
+{
+  for (int i = 0; i < numTiers; i++)
   {
-    if (point[i].x < Min.x) Min.x = point[i].x;
-    if (point[i].y < Min.y) Min.y = point[i].y;
-    if (point[i].x > Max.x) Max.x = point[i].x;
-    if (point[i].y > Max.y) Max.y = point[i].y;
+    delete[] tier[i].bucket;
   }
+  delete[] tier;
+  tier = NULL;
+}
+
+
+void PDCurveHistory::AddPoint(double X, double Y)
+{
+  PDBucket Bucket;
+
+  Bucket.from = Bucket.lo.x = Bucket.hi.x = X;
+  Bucket.lo.y = Bucket.hi.y = Y;
+
+  if (IsEmpty())
+  {
+    min = max = Bucket.lo;
+  }
+  else
+  {
+    if (X < min.x) min.x = X;
+    if (X > max.x) max.x = X;
+    if (Y < min.y) min.y = Y;
+    if (Y > max.y) max.y = Y;
+  }
+  Push(0, Bucket);
+}
+
+
+void PDCurveHistory::Push(int Tier, const PDBucket& Bucket)
+{
+  PDTier&  t = tier[Tier];
+  PDBucket Oldest;
+
+  if (t.num == tierSize)
+  {
+    if (Tier == numTiers - 1)
+    {
+      Compact(t);                       // oberste Stufe: Aufloesung halbieren
+    }
+    else
+    {
+      Oldest = t.bucket[t.first];
+      if (++t.first == tierSize) t.first = 0;
+      t.num--;
+      if (t.hasCarry)
+      {
+        Merge(t.carry, Oldest);
+        t.hasCarry = false;
+        Push(Tier + 1, t.carry);
+      }
+      else
+      {
+        t.carry = Oldest;
+        t.hasCarry = true;
+      }
+    }
+  }
+  t.bucket[(t.first + t.num++) % tierSize] = Bucket;
+}
+
+
+// Fasst je zwei aufeinanderfolgende Eintraege zusammen:
+void PDCurveHistory::Compact(PDTier& Tier)
+{
+  PDBucket* Old = Tier.bucket;
+  int       i;
+
+  Tier.bucket = new PDBucket[tierSize];
+  for (i = 0; i < Tier.num / 2; i++)
+  {
+    Tier.bucket[i] = Old[(Tier.first + 2 * i) % tierSize];
+    Merge(Tier.bucket[i], Old[(Tier.first + 2 * i + 1) % tierSize]);
+  }
+  Tier.first = 0;
+  Tier.num = i;
+  delete[] Old;
+}
+
+
+void PDCurveHistory::Merge(PDBucket& Into, const PDBucket& Later)
+{
+  if (Later.lo.y < Into.lo.y) Into.lo = Later.lo;
+  if (Later.hi.y > Into.hi.y) Into.hi = Later.hi;
+}
+
+
+int PDCurveHistory::Emit(const PDBucket& Bucket, PDPoint* Points)
+{
+  if (Bucket.lo.x == Bucket.hi.x && Bucket.lo.y == Bucket.hi.y)
+  {
+    Points[0] = Bucket.lo;
+    return 1;
+  }
+  if (Bucket.lo.x <= Bucket.hi.x)
+  {
+    Points[0] = Bucket.lo;
+    Points[1] = Bucket.hi;
+  }
+  else
+  {
+    Points[0] = Bucket.hi;
+    Points[1] = Bucket.lo;
+  }
+  return 2;
+}
+
+
+// Reihenfolge von alt nach neu: oberste Stufe, Uebertrag der darunter
+// liegenden Stufe, diese Stufe, ... , Stufe 0.
+int PDCurveHistory::GetPoints(PDPoint* Points) const
+{
+  int n = 0;
+
+  for (int k = numTiers; k--;)
+  {
+    const PDTier& t = tier[k];
+
+    for (int i = 0; i < t.num; i++)
+    {
+      n += Emit(t.bucket[(t.first + i) % tierSize], Points + n);
+    }
+    if (k > 0 && tier[k - 1].hasCarry)
+    {
+      n += Emit(tier[k - 1].carry, Points + n);
+    }
+  }
+  return n;
+}
+
+
+/******************************************************************************\
+ PDCurveStore: Implementierung
+\******************************************************************************/
+
+PDCurveStore::PDCurveStore(int MaxRows) :
+  maxRows    (MaxRows),
+  refs       (0),
+  numColumns (0),
+  maxColumns (4),
+  numRows    (0),
+  first      (0),
+  last       (-1),
+  count      (0)
+{
+  assert(MaxRows > 4);
+
+  x = new double[maxRows];
+  y = new double*[maxColumns];
+  lower = new double*[maxColumns];
+  upper = new double*[maxColumns];
+  since = new long[maxColumns];
+}
+
+
+PDCurveStore::~PDCurveStore(void)
+{
+  for (int c = 0; c < numColumns; c++)
+  {
+    delete[] y[c];
+    delete[] lower[c];
+    delete[] upper[c];
+  }
+  delete[] x;
+  delete[] y;
+  delete[] lower;
+  delete[] upper;
+  delete[] since;
+}
+
+
+int PDCurveStore::AddColumn(void)
+{
+  int c;
+
+  if (numColumns == maxColumns)
+  {
+    double** OldY = y;
+    double** OldLower = lower;
+    double** OldUpper = upper;
+    long*    OldSince = since;
+
+    maxColumns *= 2;
+    y = new double*[maxColumns];
+    lower = new double*[maxColumns];
+    upper = new double*[maxColumns];
+    since = new long[maxColumns];
+    memcpy(y, OldY, numColumns * sizeof(double*));
+    memcpy(lower, OldLower, numColumns * sizeof(double*));
+    memcpy(upper, OldUpper, numColumns * sizeof(double*));
+    memcpy(since, OldSince, numColumns * sizeof(long));
+    delete[] OldY;
+    delete[] OldLower;
+    delete[] OldUpper;
+    delete[] OldSince;
+  }
+  c = numColumns++;
+  y[c] = new double[maxRows];
+  lower[c] = new double[2 * maxRows];
+  upper[c] = new double[2 * maxRows];
+  for (int i = 2 * maxRows; i--;)
+  {
+    lower[c][i] = HUGE_VAL;
+    upper[c][i] = -HUGE_VAL;
+  }
+  since[c] = -1;
+
+  return c;
+}
+
+
+void PDCurveStore::Set(int Column, double X, double Y)
+{
+  if (!numRows || X != x[last])
+  {
+    AdvanceRow(X);
+  }
+  if (since[Column] < 0)
+  {
+    since[Column] = count - 1;
+  }
+  y[Column][last] = Y;
+  UpdateMinMax(Column, last);
+}
+
+
+// Beginnt eine neue Zeile; jede Spalte mit Wert uebernimmt ihren letzten Wert.
+void PDCurveStore::AdvanceRow(double X)
+{
+  int Prev = last;
+
+  if (numRows == maxRows)
+  {
+    if (++first == maxRows) first = 0;
+    if (++last  == maxRows) last = 0;
+  }
+  else
+  {
+    last = numRows++;
+  }
+  x[last] = X;
+  count++;
+
+  for (int c = 0; c < numColumns; c++)
+  {
+    if (since[c] >= 0)
+    {
+      y[c][last] = y[c][Prev];
+      UpdateMinMax(c, last);
+    }
+  }
+}
+
+
+void PDCurveStore::UpdateMinMax(int Column, int Row)
+{
+  double* lo = lower[Column];
+  double* hi = upper[Column];
+  int     i = Row + maxRows;
+
+  lo[i] = hi[i] = y[Column][Row];
+  for (i >>= 1; i; i >>= 1)
+  {
+    lo[i] = lo[2 * i] < lo[2 * i + 1] ? lo[2 * i] : lo[2 * i + 1];
+    hi[i] = hi[2 * i] > hi[2 * i + 1] ? hi[2 * i] : hi[2 * i + 1];
+  }
+}
+
+
+void PDCurveStore::GetMinMax(int Column, PDPoint& Min, PDPoint& Max) const
+{
+  if (!NumRows(Column))
+  {
+    Min.x = Min.y = Max.x = Max.y = 0.0;
+    return;
+  }
+  Min.x = x[First(Column)];
+  Max.x = x[last];
+  Min.y = lower[Column][1];
+  Max.y = upper[Column][1];
 }
 
 
@@ -116,15 +499,15 @@ void PDCurve::GetMinMax(PDPoint& Min, PDPoint& Max) const
 PDCurveIter::PDCurveIter(const PDCurve& ToIter) :
   curve(ToIter)
 {
-  cur = curve.first;
-  toVisit = curve.numPoints;
+  cur = curve.store ? curve.store->First(curve.column) : curve.first;
+  toVisit = curve.GetNumPoints();
 }  
 
 PDCurveIter::PDCurveIter(const PDCurve* ToIter) :
   curve(*ToIter)
 {
-  cur = curve.first;
-  toVisit = curve.numPoints;
+  cur = curve.store ? curve.store->First(curve.column) : curve.first;
+  toVisit = curve.GetNumPoints();
 }
 
 
@@ -152,63 +535,207 @@ void PDDiscreteCurve::AddPoint(double X, double Y)
  PDFrequency: Implementierung
 \******************************************************************************/   
 
-PDFrequency::PDFrequency(int MinNum, const long dataColor) :
-  PDDataType(dataColor)
+// Direkt indizierte Tabellen bis zu dieser Groesse (bzw. 16 Eintraege je
+// benutztem Index) sind erlaubt, darueber wird auf Hashing umgeschaltet:
+static const int denseLimit = 4096;
+
+PDFrequency::PDFrequency(int MinNum, const long dataColor, SCBoolean Sparse) :
+  PDDataType(dataColor),
+  used     (0),
+  capacity (8),
+  sparse   (Sparse),
+  sum      (0.0),
+  num      (MinNum)
 {
-  num = MinNum;
-  data = new double[num];
-  Reset();
+  data = new double[capacity];
+  ids = new int[capacity];
+  order = new int[capacity];
+  tableSize = sparse ? 16 : (MinNum > 8 ? MinNum : 8);
+  table = new int[tableSize];
+  memset(table, 0, tableSize * sizeof(int));
 }
 
 
 PDFrequency::~PDFrequency(void)
 {
   delete[] data;
+  delete[] ids;
+  delete[] order;
+  delete[] table;
   data = NULL;
 }
 
 
 void PDFrequency::Reset(void)
 {
-  for (int i = num; i--;)
+  SCBoolean Changed = false;
+
+  // Die Abbildung der Indizes bleibt erhalten, nur die Werte werden geloescht.
+  for (int i = used; i--;)
+  {
+    if (data[i] != 0.0) Changed = true;
     data[i] = 0.0;
+  }
   sum = 0.0;
+  if (Changed) Touch();
 }
 
 
 void PDFrequency::ChangeVal(int Index, double Change)
 {
-  //assert(Index >= 0);
-  if (Index >= num)
+  int Slot = Find(Index);
+
+  if (Slot < 0)
+  {
+    Slot = Insert(Index);
+  }
+  else if (Change == 0.0)
+  {
+    return;
+  }
+  data[Slot] += Change;
+  sum += Change;
+  Touch();
+}
+
+
+int PDFrequency::Insert(int Index)
+{
+  int Slot = used;
+  int Low, High, Mid;
+
+  if (used == capacity)
   {
     double* OldData = data;
-    data = new double[Index + 1];
-    memcpy(data, OldData, num * sizeof(double));
-    for (int i = num; i <= Index; i++) data[i] = 0.0;
-    num = Index + 1;
+    int*    OldIds = ids;
+    int*    OldOrder = order;
+
+    capacity *= 2;
+    data = new double[capacity];
+    ids = new int[capacity];
+    order = new int[capacity];
+    memcpy(data, OldData, used * sizeof(double));
+    memcpy(ids, OldIds, used * sizeof(int));
+    memcpy(order, OldOrder, used * sizeof(int));
     delete[] OldData;
+    delete[] OldIds;
+    delete[] OldOrder;
+  }
+  data[Slot] = 0.0;
+  ids[Slot] = Index;
+  used++;
+
+  // In die aufsteigende Reihenfolge einsortieren:
+  for (Low = 0, High = Slot; Low < High;)
+  {
+    Mid = (Low + High) / 2;
+    if (ids[order[Mid]] < Index) Low = Mid + 1;
+    else High = Mid;
+  }
+  memmove(order + Low + 1, order + Low, (Slot - Low) * sizeof(int));
+  order[Low] = Slot;
+
+  if (!sparse && (unsigned int)Index >= (unsigned int)tableSize)
+  {
+    int NewSize = tableSize;
+
+    while (NewSize <= Index && NewSize < (1 << 30)) NewSize *= 2;
+    if (Index < 0 || NewSize <= Index ||
+        (NewSize > denseLimit && NewSize > 16 * used))
+    {
+      MakeSparse();
+      return Slot;
+    }
+
+    int* OldTable = table;
+
+    table = new int[NewSize];
+    memcpy(table, OldTable, tableSize * sizeof(int));
+    memset(table + tableSize, 0, (NewSize - tableSize) * sizeof(int));
+    tableSize = NewSize;
+    delete[] OldTable;
+  }
+  else if (sparse && 2 * used > tableSize)
+  {
+    MakeSparse();                      // Hashtabelle vergroessern
+    return Slot;
+  }
+  Enter(Slot);
+  if (Index >= num) num = Index + 1;
+
+  return Slot;
+}
+
+
+void PDFrequency::Enter(int Slot)
+{
+  int Index = ids[Slot];
+
+  if (!sparse)
+  {
+    table[Index] = Slot + 1;
+    return;
+  }
+  unsigned int i;
+
+  for (i = Hash(Index);
+       table[i];
+       i = (i + 1) & (tableSize - 1));
+  table[i] = Slot + 1;
+}
+
+
+// Baut die Hashtabelle fuer alle benutzten Plaetze (neu) auf:
+void PDFrequency::MakeSparse(void)
+{
+  int i;
+
+  sparse = true;
+  delete[] table;
+  for (tableSize = 16; tableSize < 2 * used; tableSize *= 2);
+  table = new int[tableSize];
+  memset(table, 0, tableSize * sizeof(int));
+  for (i = 0; i < used; i++)
+  {
+    Enter(i);
+    if (ids[i] >= num) num = ids[i] + 1;
   }
-  data[Index] += Change;
-  sum += Change;
 }
 
 
 double PDFrequency::GetRelVal(int Index) const
 {
-  return sum ? (data[Index] / sum) : 0;
+  return sum ? (GetAbsVal(Index) / sum) : 0;
 }
 
 
 void PDFrequency::Copy(const PDFrequency& From)
 {
-  if (num != From.num)
+  if (capacity < From.used)
   {
     delete[] data;
-    num = From.num;
-    data = new double[num];
+    delete[] ids;
+    delete[] order;
+    capacity = From.capacity;
+    data = new double[capacity];
+    ids = new int[capacity];
+    order = new int[capacity];
+  }
+  if (tableSize != From.tableSize)
+  {
+    delete[] table;
+    tableSize = From.tableSize;
+    table = new int[tableSize];
   }
-  memcpy(data, From.data, num * sizeof(double));
+  used = From.used;
+  memcpy(data, From.data, used * sizeof(double));
+  memcpy(ids, From.ids, used * sizeof(int));
+  memcpy(order, From.order, used * sizeof(int));
+  memcpy(table, From.table, tableSize * sizeof(int));
+  sparse = From.sparse;
   sum = From.sum;
+  num = From.num;
+  Touch();
 }
 
 
@@ -233,20 +760,20 @@ const char * PDStateTable::GetStateName(int Index) const
   if (Index > maxStateID || Index < minStateID)
     return NULL;
 
-  return SCType::GetObjectName(SC_STATE, Index);
+  return PEObjectNames::Get(SC_STATE, Index);
 } 
 
 
-void PDStateTable::RegisterState(const SCStateType *state)
+void PDStateTable::RegisterState(SCInteger StateID)
 {
-  if ((SCInteger)state->GetID() > maxStateID)
+  if (StateID > maxStateID)
   {
-    maxStateID = state->GetID();
+    maxStateID = StateID;
   }
 
-  if ((SCInteger)state->GetID() < minStateID)
+  if (StateID < minStateID)
   {
-    minStateID = state->GetID();
+    minStateID = StateID;
   }
 }
 
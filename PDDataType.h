@@ -1,7 +1,8 @@
 /******************************************************************************\
  Datei : PDDataType.h
- Inhalt: Deklaration der Klassen PDDataType, PDPoint, PDCurve, PDCurveIter,
-         PDDiscretePoint, PDFrequency, PDStateTable, PDEventType
+ Inhalt: Deklaration der Klassen PDDataType, PDPoint, PDCurveHistory,
+         PDCurveStore, PDCurve, PDCurveIter, PDDiscretePoint, PDFrequency,
+         PDStateTable, PDEventType
  Autor : Christian Rodemeyer, Marc Diefenbruch
  Datum : 10.02.98
  Status: 
@@ -15,6 +16,9 @@
 /******************************************************************************\ 
  PDDataType: Basisklasse zur automatischen Speicherfreigabe aller 
    PEV-Datentypen bei Programmende. 
+     Jede Aenderung der Werte zaehlt die Version des Datentyps hoch;
+   Displays zeichnen nur neu, wenn sich die Version ihrer Datentypen seit
+   dem letzten Update geaendert hat.
 \******************************************************************************/    
 
 class PDDataType
@@ -27,16 +31,22 @@ class PDDataType
 
     long GetColor(void) const {return color;}  
     void SetColor(const long newColor) { color = newColor;}  
+
+    unsigned long GetVersion(void) const {return version;}
     
     friend SCStream& operator<< (SCStream& pStream,
                                  const PDDataType& pData);
 
+  protected:
+    void Touch(void) {version++;}  // Werte haben sich geaendert
+
   private:
     static SCList<PDDataType> collection;
     
     SCListCons<PDDataType> *  container;      // actual SCListCons elem
 
-    long      color;
+    long          color;
+    unsigned long version;
 };
 
 
@@ -50,10 +60,132 @@ struct PDPoint
 };    
 
 
+/******************************************************************************\ 
+ PDCurveHistory: Verlauf einer Kurve ueber den gesamten Lauf bei festem
+   Speicherbedarf. Stufe 0 enthaelt die neuesten Punkte, jede weitere Stufe
+   aeltere Punkte mit halber Aufloesung: Faellt ein Eintrag aus einer vollen
+   Stufe heraus, wird er mit seinem Vorgaenger zu einem Eintrag der naechsten
+   Stufe zusammengefasst. Ist die oberste Stufe voll, werden ihre Eintraege
+   paarweise zusammengefasst. Ein Eintrag behaelt Minimum und Maximum (mit
+   ihren X-Werten) aller zusammengefassten Punkte, so dass Spitzen auch in
+   groben Stufen sichtbar bleiben.
+\******************************************************************************/    
+
+class PDCurveHistory
+{
+  public:
+    PDCurveHistory(int NumTiers, int TierSize);
+    ~PDCurveHistory(void);
+
+    void AddPoint(double X, double Y);
+
+    // Schreibt den Verlauf in zeitlicher Reihenfolge nach Points (mindestens
+    // MaxPoints() Eintraege) und liefert die Anzahl der Punkte:
+    int  GetPoints(PDPoint* Points) const;
+    int  MaxPoints(void) const {return 2 * numTiers * (tierSize + 1);}
+    void GetMinMax(PDPoint& Min, PDPoint& Max) const {Min = min; Max = max;}
+    SCBoolean IsEmpty(void) const {return tier[0].num == 0;}
+
+    const int numTiers;
+    const int tierSize;   // Eintraege je Stufe (gerade)
+
+  private:
+    struct PDBucket
+    {
+      double  from;       // X-Wert des ersten Punktes
+      PDPoint lo;         // Minimum
+      PDPoint hi;         // Maximum
+    };
+
+    struct PDTier
+    {
+      PDBucket* bucket;   // Ringpuffer mit tierSize Eintraegen
+      int       first;    // aeltester Eintrag
+      int       num;
+      PDBucket  carry;    // herausgefallen, wartet auf seinen Nachfolger
+      SCBoolean hasCarry;
+    };
+
+    PDTier* tier;
+    PDPoint min;          // Extrema des gesamten Laufs, min.x = erster Punkt
+    PDPoint max;
+
+    void   Push(int Tier, const PDBucket& Bucket);
+    void   Compact(PDTier& Tier);
+    static void Merge(PDBucket& Into, const PDBucket& Later);
+    static int  Emit(const PDBucket& Bucket, PDPoint* Points);
+};
+
+
+/******************************************************************************\ 
+ PDCurveStore: Spaltenweise Ablage der Kurven eines Rahmens. Alle Kurven
+   erhalten ihre Punkte zum selben Zeitpunkt, daher gibt es eine gemeinsame
+   Zeitspalte und je Kurve nur eine Wertespalte. Ein neuer X-Wert beginnt
+   eine neue Zeile (Ringpuffer mit maxRows Zeilen), in die fuer jede Kurve
+   zunaechst ihr letzter Wert uebernommen wird. Eine Spalte ist ab der
+   Zeile ihres ersten Wertes sichtbar.
+     Je Spalte werden Minimum und Maximum in einem Segmentbaum mitgefuehrt.
+     Der Speicher gehoert den Kurven, die ihn benutzen: Jede PDCurve meldet
+   sich im Konstruktor an und im Destruktor ab, die letzte Abmeldung gibt
+   den Speicher frei.
+\******************************************************************************/    
+
+class PDCurveStore
+{
+  public:
+    PDCurveStore(int MaxRows);
+
+    void Attach(void)                     {refs++;}
+    void Release(void)                    {if (!--refs) delete this;}
+
+    int  AddColumn(void);
+    void Set(int Column, double X, double Y);
+
+    int  NumRows(void) const              {return numRows;}
+    int  NumRows(int Column) const        {return since[Column] < 0 ? 0 :
+                                           (count - since[Column] < numRows ?
+                                            (int)(count - since[Column]) :
+                                            numRows);}
+    int  First(void) const                {return first;}
+    int  First(int Column) const          {return (last - NumRows(Column) + 1 +
+                                                   maxRows) % maxRows;}
+    const double* XColumn(void) const     {return x;}
+    const double* YColumn(int Column) const {return y[Column];}
+    void GetMinMax(int Column, PDPoint& Min, PDPoint& Max) const;
+
+    const int maxRows;
+
+  private:
+    ~PDCurveStore(void);  // nur ueber Release
+
+    int      refs;        // Anzahl angemeldeter Kurven
+    double*  x;           // gemeinsame Zeitspalte
+    double** y;           // Wertespalten
+    double** lower;       // Segmentbaeume (2 * maxRows) der Minima je Spalte
+    double** upper;       // Segmentbaeume (2 * maxRows) der Maxima je Spalte
+    long*    since;       // Nummer der ersten Zeile je Spalte, -1: kein Wert
+    int      numColumns;
+    int      maxColumns;
+    int      numRows;     // belegte Zeilen
+    int      first;       // aelteste Zeile
+    int      last;        // neueste Zeile
+    long     count;       // Anzahl aller bisher begonnenen Zeilen
+
+    void AdvanceRow(double X);
+    void UpdateMinMax(int Column, int Row);
+};
+
+
 /******************************************************************************\ 
  PDCurve, Reprsentation einer 2D-Kurve als einer Menge von Punkten.
    Die Punkte Menge wird als Queue-Struktur verwaltet. Neue Punkte verdrngen 
    die ltesten Punkte, sobald die Kurve mehr als 'maxPoints' Punkte enthlt.
+   Optional wird zusaetzlich der gesamte Verlauf gefuehrt (EnableHistory).
+     Minimum und Maximum der Punkte werden in einem Segmentbaum ueber die
+   Plaetze des Ringpuffers mitgefuehrt: AddPoint kostet O(log maxPoints),
+   GetMinMax O(1).
+     Mit einem PDCurveStore konstruiert, ist die Kurve nur eine Sicht auf
+   eine Spalte des Speichers (ohne Zusammenfassen gleicher Werte).
 \******************************************************************************/    
 
 class PDCurve: public PDDataType
@@ -62,12 +194,23 @@ class PDCurve: public PDDataType
   
   public:
     PDCurve(int MaxPoints = 32, const long dataColor = 1L);
+    PDCurve(PDCurveStore* Store, const long dataColor = 1L);
     virtual ~PDCurve(void);
     
     virtual void AddPoint(double X, double Y); // Anhaengen eines neuen Punkts
 
     void GetMinMax(PDPoint& Min, PDPoint& Max) const;
-    int  GetNumPoints() const {return numPoints;}
+    int  GetNumPoints() const {return store ? store->NumRows(column) :
+                                              numPoints;}
+
+    PDPoint GetPoint(int Index) const; // Index 0: aeltester Punkt
+    const PDCurveStore* GetStore(void) const {return store;}
+    int  GetColumn(void) const {return column;}
+
+    // Zusaetzlich den gesamten Verlauf mit NumTiers Stufen zu je maxPoints
+    // Eintraegen fuehren (nur vor dem ersten AddPoint sinnvoll):
+    void EnableHistory(int NumTiers);
+    const PDCurveHistory* GetHistory(void) const {return history;}
     
     const int maxPoints;  // Maximale Anzahl von Punkten der Kurve
     
@@ -76,6 +219,15 @@ class PDCurve: public PDDataType
     int       first;      // Index des ersten Punktes 
     int       last;       // Index des letzten Punktes 
     PDPoint*  point;      // numPoints PVPoints
+    PDCurveHistory* history; // gesamter Verlauf oder NULL
+
+  private:
+    PDPoint*  lower;      // Segmentbaum (2 * maxPoints): Minima von x und y
+    PDPoint*  upper;      // Segmentbaum (2 * maxPoints): Maxima von x und y
+    PDCurveStore* store;  // spaltenweise Ablage oder NULL
+    int       column;     // Spalte in store
+
+    void UpdateMinMax(int Index);
 };
 
 
@@ -91,15 +243,40 @@ class PDCurveIter
 
     void     operator ++(int)      {toVisit--; if (++cur == curve.maxPoints) cur = 0;}
              operator bool() const {return toVisit;}
-    PDPoint* operator ->() const   {return &curve.point[cur];}
+    PDPoint* operator ->() const;
     
   private:
     const PDCurve& curve;   // Kurve ber die iteriert wird
     int            cur;     // aktueller Punkt
     int            toVisit; // noch zu besuchende Punkte
+    mutable PDPoint row;    // aktueller Punkt einer Spalte eines PDCurveStore
 };    
 
 
+inline PDPoint* PDCurveIter::operator ->() const
+{
+  if (!curve.store) return &curve.point[cur];
+
+  row.x = curve.store->XColumn()[cur];
+  row.y = curve.store->YColumn(curve.column)[cur];
+  return &row;
+}    
+
+
+inline PDPoint PDCurve::GetPoint(int Index) const
+{
+  PDPoint p;
+  int     row;
+
+  if (!store) return point[(first + Index) % maxPoints];
+
+  row = (store->First(column) + Index) % store->maxRows;
+  p.x = store->XColumn()[row];
+  p.y = store->YColumn(column)[row];
+  return p;
+}
+
+
 /******************************************************************************\ 
  PDDiscreteCurve: Kurve, mit diskreten Wertewechseln
 \******************************************************************************/    
@@ -116,28 +293,81 @@ class PDDiscreteCurve: public PDCurve
 /******************************************************************************\
  PDFrequency: Dynamisches Array von double-Werten als Basis von Balkendiagrammen,
    jeder Eintrag entspricht der Hoehe eines Balken.
+     Die Indizes (meist SCL-Typ-IDs) werden beim ersten Auftreten auf dichte
+   Plaetze abgebildet; nur fuer tatsaechlich benutzte Indizes wird ein Wert
+   gespeichert. Die Abbildung ist eine direkt indizierte Tabelle, bei sehr
+   weit gestreuten (oder negativen) Indizes bzw. mit Sparse = true eine
+   Hashtabelle. Alle Arrays wachsen geometrisch.
+     Num() liefert weiterhin den groessten Index + 1 (mindestens MinNum),
+   GetAbsVal und GetRelVal liefern fuer unbenutzte Indizes 0. Mit NumUsed()
+   und IdAt() koennen die benutzten Indizes in aufsteigender Reihenfolge
+   durchlaufen werden.
 \******************************************************************************/   
 
 class PDFrequency: public PDDataType 
 {
   public:
-    PDFrequency(int MinNum = 1, const long dataColor = 1L); // enthaelt mindestens MinNum Elemente
+    PDFrequency(int MinNum = 1, const long dataColor = 1L, // enthaelt mindestens MinNum Elemente
+                SCBoolean Sparse = false);
     ~PDFrequency();
     
     void   Reset(void);
     void   ChangeVal(int Index, double Change);
     void   Copy(const PDFrequency& From);
     double GetRelVal(int Index) const;
-    double GetAbsVal(int Index) const           {return data[Index];}
+    double GetAbsVal(int Index) const           {int s = Find(Index);
+                                                 return s < 0 ? 0.0 : data[s];}
     int    Num(void) const                      {return num;}
+    int    NumUsed(void) const                  {return used;}
+    int    IdAt(int Rank) const                 {return ids[order[Rank]];}
     
   private:
-    double* data;
-    double  sum;
-    int     num;
+    double*   data;      // Werte je Platz (in der Reihenfolge des Auftretens)
+    int*      ids;       // Index je Platz
+    int*      order;     // Plaetze nach aufsteigendem Index
+    int*      table;     // Index -> Platz + 1, 0 = unbenutzt
+    int       tableSize; // sparse: immer Zweierpotenz
+    int       used;
+    int       capacity;
+    SCBoolean sparse;
+    double    sum;
+    int       num;
+
+    int  Find(int Index) const;
+    int  Insert(int Index);
+    void Enter(int Slot);
+    void MakeSparse(void);
+    unsigned int Hash(int Index) const; // Platz in table (sparse)
 };
 
 
+// Die unteren Bits des Produkts haengen nur von den unteren Bits des Index
+// ab; die oberen werden daher wie bei PEInstrument::Hash hineingefaltet
+inline unsigned int PDFrequency::Hash(int Index) const
+{
+  unsigned int h = (unsigned int)Index * 0x9e3779b1U;
+
+  return (h ^ (h >> 16)) & (tableSize - 1);
+}
+
+
+inline int PDFrequency::Find(int Index) const
+{
+  if (!sparse)
+  {
+    return ((unsigned int)Index < (unsigned int)tableSize) ?
+           table[Index] - 1 : -1;
+  }
+  for (unsigned int i = Hash(Index);
+       table[i];
+       i = (i + 1) & (tableSize - 1))
+  {
+    if (ids[table[i] - 1] == Index) return table[i] - 1;
+  }
+  return -1;
+}
+
+
 /******************************************************************************\
  PDEventType: Einfaches Ereigniss, Ankuft oder Abgang eines Signals (Requests) an
   einem Proze (einer Maschine).
@@ -177,7 +407,7 @@ class PDStateTable
     ~PDStateTable(void);
               
     const char * GetStateName(int Index) const;
-    void         RegisterState(const class SCStateType *state);
+    void         RegisterState(SCInteger StateID);
     SCInteger    GetMaxStateID(void) const { return maxStateID; }
     SCInteger    GetMinStateID(void) const { return minStateID; }
     SCNatural    GetNumOfStates(void) const { return (maxStateID >= minStateID ?
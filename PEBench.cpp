@@ -0,0 +1,1114 @@
+/******************************************************************************\
+ Datei : PEBench.cpp
+ Inhalt: Benchmark der Ereignisverteilung (pevbench): Ein synthetischer
+         Lastgenerator versorgt den EventDispatcher ohne laufenden Simulator
+         mit Ereignissen; gemessen werden Ereignisse/s, ns/Ereignis und der
+         maximale Speicherbedarf. Erhaelt ein Sensor der Konfiguration
+         keine Ereignisse, endet pevbench mit Status 1. Mit -C prueft
+         pevbench stattdessen die Statistik der Tallies (Selbsttest).
+ Status:
+\******************************************************************************/
+
+#include <iostream>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "PEEventDispatcher.h"
+#include "PEInstrument.h"
+#include "PEReportWriter.h"
+#include "PETraceFile.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+/******************************************************************************\
+ Parameter der synthetischen Last
+\******************************************************************************/
+
+enum                          // Arten von Schritten des Generators
+{
+  mSend, mConsume, mSave, mDrop, mState, mRequest, mFinish,
+  numMixes
+};
+
+static const char * mixNames[numMixes] =
+{
+  "send", "consume", "save", "drop", "state", "request", "finish"
+};
+
+struct PEBenchParams
+{
+  long         events;        // Anzahl zu erzeugender Ereignisse (ca.)
+  int          processTypes;
+  int          instances;     // Prozesse je Prozesstyp
+  int          machines;
+  int          servers;       // Server je Maschine
+  int          signalTypes;
+  int          requestTypes;
+  int          states;
+  int          sensorSets;    // Kopien der Sensorkonfiguration
+  int          mix[numMixes]; // Gewichte der Schritte
+  int          timeStep;      // mittlere Ereignisse je Zeitfortschritt
+  unsigned     seed;
+  int          pipeline;      // Groesse der Warteschlange (0: inline)
+  int          replay;        // Threads der Wiedergabe (0: Inject)
+  const char * traceFile;
+  const char * reportFile;
+  SCBoolean    instrument;
+};
+
+/******************************************************************************\
+ Sensortypen der Konfiguration: Je Prozesstyp bzw. Maschine wird ein Sensor
+   angelegt, globale Sensoren einmal je Sensorsatz. ProcessNumber liefert
+   bei dieser Last keine Werte: Alle Prozesse entstehen zum Zeitpunkt 0 und
+   werden nie beendet, die Anzahl aendert sich also nicht.
+\******************************************************************************/
+
+enum                          // Parameter des Sensors
+{
+  pProcess,                   // "P"
+  pSignalProcess,             // "S", "P"
+  pMachine,                   // "M"
+  pRequestMachine,            // "R", "M"
+  pGlobal,                    // keine
+  pEvent,                     // "E", In, Signal, "S", "P"
+  pActivity                   // "A", In, Signal, "S", "P", Out, Signal, "S", "P"
+};
+
+struct PEBenchSensor
+{
+  const char * name;
+  int          params;
+  SCBoolean    checked;       // liefert bei dieser Last Werte ungleich 0
+};
+
+static const PEBenchSensor sensorTypes[] =
+{
+  {"ProcessQLen",        pProcess,        true},
+  {"ProcessQLenFreq",    pProcess,        true},
+  {"ProcessNumber",      pProcess,        false},
+  {"ProcessSigWaitTime", pSignalProcess,  true},
+  {"ProcessStateFreq",   pProcess,        true},
+  {"ProcessInSigFreq",   pProcess,        true},
+  {"ProcessOutSigFreq",  pProcess,        true},
+  {"ProcessOutReqFreq",  pProcess,        true},
+  {"MachineQLen",        pMachine,        true},
+  {"MachineQLenFreq",    pMachine,        true},
+  {"MachineReqWaitTime", pRequestMachine, true},
+  {"MachineReqThruTime", pRequestMachine, true},
+  {"MachineInReqFreq",   pMachine,        true},
+  {"MachineUtilization", pMachine,        true},
+  {"GlobalSigFreq",      pGlobal,         true},
+  {"GlobalReqFreq",      pGlobal,         true},
+  {"SimpleEvent",        pEvent,          true},
+  {"SimpleActivity",     pActivity,       true},
+  {NULL,                0,               false}
+};
+
+/******************************************************************************\
+ PEBenchLoad: Synthetischer Lastgenerator. Anstelle der Objekte der SCL gibt
+   es nur Platzhalter (Name und ID), deren Adressen als Identitaet in die
+   Ereignisse eingehen, wie bei der Wiedergabe einer Aufzeichnung. Die Namen
+   der Typen werden in PEObjectNames eingetragen.
+     Der Generator fuehrt fuer jeden Prozess eine Eingangswarteschlange und
+   fuer jede Maschine Warteschlange und freie Server, so dass die Ereignisse
+   zueinander passen (kein Konsum ohne Empfang, kein Ende ohne Start). Bei
+   gleichem Startwert entsteht immer dieselbe Folge von Ereignissen.
+\******************************************************************************/
+
+class PEBenchLoad
+{
+  public:
+    PEBenchLoad(const PEBenchParams & Params);
+    ~PEBenchLoad(void);
+
+    SCNatural Next(PEEvent * Buffer, SCNatural Size); // 0: Ende der Last
+
+    const char * ProcessName(int i) const { return processTypes[i].name; }
+    const char * MachineName(int i) const { return machines[i].stub.name; }
+    const char * SignalName(int i) const  { return signalTypes[i].name; }
+    const char * RequestName(int i) const { return requestTypes[i].name; }
+
+  private:
+    enum {queueSize = 32};     // Platz je Warteschlange (Zweierpotenz)
+
+    struct PEStub              // Platzhalter fuer ein Objekt der SCL
+    {
+      char      name[32];
+      SCInteger id;
+    };
+
+    struct PEMessage           // wartendes Signal bzw. wartender Request
+    {
+      int    type;
+      int    partner;          // Sender bzw. Aufrufer (Prozessindex)
+      SCTime creation;
+    };
+
+    struct PEQueue
+    {
+      PEMessage entry[queueSize];
+      int       head;
+      int       length;
+    };
+
+    struct PEProcess
+    {
+      int     type;
+      PEQueue input;
+    };
+
+    struct PEMachine
+    {
+      PEStub  stub;
+      int     freeServers;
+      PEQueue waiting;
+    };
+
+    const PEBenchParams & params;
+    PEStub *    processTypes;
+    PEStub *    signalTypes;
+    PEStub *    requestTypes;
+    PEStub *    states;
+    PEProcess * processes;
+    PEMachine * machines;
+    int         numProcesses;
+    int         mixTotal;
+    unsigned long long random;
+    SCTime      now;
+    long        emitted;
+    int         phase;         // 0: Anfang, 1: Last, 2: Ende, 3: fertig
+
+    PEEvent *   out;
+    SCNatural   fill;
+
+    SCNatural   Random(SCNatural Range);
+    PEEvent &   Emit(SCTraceAction Action);
+    void        SetProcess(PEEvent & Event, int Process);
+    void        SetMachine(PEEvent & Event, int Machine);
+    void        SetSignal(PEEvent & Event, const PEMessage & Signal);
+    void        SetRequest(PEEvent & Event, const PEMessage & Request);
+    void        Step(void);
+    void        Start(int Machine);
+    static void Name(PEStub & Stub, const char * Prefix, int Index);
+    static void Push(PEQueue & Queue, const PEMessage & Message);
+    static PEMessage Pop(PEQueue & Queue);
+};
+
+
+PEBenchLoad::PEBenchLoad(const PEBenchParams & Params) :
+  params   (Params),
+  random   (Params.seed),
+  now      (0.0),
+  emitted  (0),
+  phase    (0),
+  out      (NULL),
+  fill     (0)
+{
+  int i;
+
+  processTypes = new PEStub[params.processTypes];
+  for (i = 0; i < params.processTypes; i++)
+    Name(processTypes[i], "P", i);
+
+  signalTypes = new PEStub[params.signalTypes];
+  for (i = 0; i < params.signalTypes; i++)
+  {
+    Name(signalTypes[i], "S", i);
+    PEObjectNames::Set(SC_SIGNAL, i, signalTypes[i].name);
+  }
+
+  requestTypes = new PEStub[params.requestTypes];
+  for (i = 0; i < params.requestTypes; i++)
+  {
+    Name(requestTypes[i], "R", i);
+    PEObjectNames::Set(SC_REQUEST, i, requestTypes[i].name);
+  }
+
+  states = new PEStub[params.states];
+  for (i = 0; i < params.states; i++)
+  {
+    Name(states[i], "Z", i);
+    PEObjectNames::Set(SC_STATE, i, states[i].name);
+  }
+
+  numProcesses = params.processTypes * params.instances;
+  processes = new PEProcess[numProcesses];
+  for (i = 0; i < numProcesses; i++)
+  {
+    processes[i].type = i % params.processTypes;
+    processes[i].input.head = processes[i].input.length = 0;
+  }
+
+  machines = new PEMachine[params.machines];
+  for (i = 0; i < params.machines; i++)
+  {
+    Name(machines[i].stub, "M", i);
+    machines[i].freeServers = params.servers;
+    machines[i].waiting.head = machines[i].waiting.length = 0;
+  }
+
+  for (mixTotal = 0, i = 0; i < numMixes; i++)
+    mixTotal += params.mix[i];
+}
+
+
+PEBenchLoad::~PEBenchLoad(void)
+{
+  delete[] processTypes;
+  delete[] signalTypes;
+  delete[] requestTypes;
+  delete[] states;
+  delete[] processes;
+  delete[] machines;
+}
+
+
+void PEBenchLoad::Name(PEStub & Stub, const char * Prefix, int Index)
+{
+  sprintf(Stub.name, "%s%d", Prefix, Index);
+  Stub.id = Index;
+}
+
+
+SCNatural PEBenchLoad::Random(SCNatural Range)
+{
+  random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+
+  return (SCNatural)((random >> 33) % Range);
+}
+
+
+void PEBenchLoad::Push(PEQueue & Queue, const PEMessage & Message)
+{
+  Queue.entry[(Queue.head + Queue.length++) & (queueSize - 1)] = Message;
+}
+
+
+PEBenchLoad::PEMessage PEBenchLoad::Pop(PEQueue & Queue)
+{
+  PEMessage message = Queue.entry[Queue.head];
+
+  Queue.head = (Queue.head + 1) & (queueSize - 1);
+  Queue.length--;
+
+  return message;
+}
+
+
+PEEvent & PEBenchLoad::Emit(SCTraceAction Action)
+{
+  PEEvent & event = out[fill++];
+
+  memset(&event, 0, sizeof(event));
+  event.action = Action;
+  event.time = now;
+  emitted++;
+
+  return event;
+}
+
+
+void PEBenchLoad::SetProcess(PEEvent & Event, int Process)
+{
+  Event.runnable = &processes[Process];
+  Event.runnableType = &processTypes[processes[Process].type];
+  Event.runnableName = processTypes[processes[Process].type].name;
+}
+
+
+void PEBenchLoad::SetMachine(PEEvent & Event, int Machine)
+{
+  Event.runnable = Event.runnableType = &machines[Machine];
+  Event.runnableName = machines[Machine].stub.name;
+  Event.freeServers = machines[Machine].freeServers;
+  Event.numServers = params.servers;
+}
+
+
+void PEBenchLoad::SetSignal(PEEvent & Event, const PEMessage & Signal)
+{
+  Event.partner = &processes[Signal.partner];
+  Event.partnerType = &processTypes[processes[Signal.partner].type];
+  Event.msgType = &signalTypes[Signal.type];
+  Event.msgName = signalTypes[Signal.type].name;
+  Event.msgID = signalTypes[Signal.type].id;
+  Event.msgCreation = Signal.creation;
+}
+
+
+void PEBenchLoad::SetRequest(PEEvent & Event, const PEMessage & Request)
+{
+  Event.partner = &processes[Request.partner];
+  Event.partnerType = &processTypes[processes[Request.partner].type];
+  Event.msgType = &requestTypes[Request.type];
+  Event.msgName = requestTypes[Request.type].name;
+  Event.msgID = requestTypes[Request.type].id;
+  Event.msgCreation = Request.creation;
+  Event.msgWaitStart = Request.creation;
+}
+
+
+// Bedienung des naechsten wartenden Requests, falls ein Server frei ist
+void PEBenchLoad::Start(int Machine)
+{
+  PEMachine & machine = machines[Machine];
+
+  if (machine.freeServers && machine.waiting.length)
+  {
+    PEMessage request = Pop(machine.waiting);
+
+    machine.freeServers--;
+    PEEvent & event = Emit(scTraceServiceStart);
+    SetMachine(event, Machine);
+    SetRequest(event, request);
+  }
+}
+
+
+// Ein Schritt der Last; erzeugt hoechstens drei Ereignisse
+void PEBenchLoad::Step(void)
+{
+  SCNatural    choice;
+  int          mix, p, m;
+  PEMessage    message;
+
+  if (params.timeStep && Random(params.timeStep) == 0)
+  {
+    now += Random(1000) / 500.0;
+    Emit(scTraceTimeChange);
+    return;
+  }
+
+  for (choice = Random(mixTotal), mix = 0;
+       choice >= (SCNatural)params.mix[mix];
+       choice -= params.mix[mix++]);
+
+  p = Random(numProcesses);
+  m = Random(params.machines);
+
+  switch (mix)
+  {
+    case mSend:
+      {
+        message.type = Random(params.signalTypes);
+        message.partner = Random(numProcesses);
+        message.creation = now;
+
+        PEEvent & send = Emit(scTraceSignalSend);
+        SetProcess(send, p);
+        SetSignal(send, message);
+
+        PEEvent & receive = Emit(processes[p].input.length < queueSize ?
+                                 scTraceSignalReceive : scTraceSignalLose);
+        SetProcess(receive, p);
+        SetSignal(receive, message);
+        if (receive.action == scTraceSignalReceive)
+          Push(processes[p].input, message);
+      }
+      break;
+
+    case mConsume:
+    case mDrop:
+      if (processes[p].input.length)
+      {
+        message = Pop(processes[p].input);
+
+        PEEvent & event = Emit(mix == mConsume ? scTraceSignalConsume :
+                                                 scTraceSignalDrop);
+        SetProcess(event, p);
+        SetSignal(event, message);
+      }
+      break;
+
+    case mSave:
+      if (processes[p].input.length)
+      {
+        PEQueue & input = processes[p].input;
+        PEEvent & event = Emit(scTraceSignalSave);
+        SetProcess(event, p);
+        SetSignal(event, input.entry[input.head]);
+      }
+      break;
+
+    case mState:
+      {
+        int       s = Random(params.states);
+        PEEvent & event = Emit(scTraceStateChange);
+        SetProcess(event, p);
+        event.msgType = &states[s];
+        event.msgName = states[s].name;
+        event.msgID = states[s].id;
+      }
+      break;
+
+    case mRequest:
+      if (machines[m].waiting.length < queueSize)
+      {
+        message.type = Random(params.requestTypes);
+        message.partner = p;
+        message.creation = now;
+        Push(machines[m].waiting, message);
+
+        PEEvent & event = Emit(scTraceServiceRequest);
+        SetMachine(event, m);
+        SetRequest(event, message);
+        Start(m);
+      }
+      break;
+
+    case mFinish:
+      if (machines[m].freeServers < params.servers)
+      {
+        message.type = Random(params.requestTypes);
+        message.partner = p;
+        message.creation = now;
+        machines[m].freeServers++;
+
+        PEEvent & event = Emit(scTraceServiceFinish);
+        SetMachine(event, m);
+        SetRequest(event, message);
+        Start(m);
+      }
+      break;
+  }
+}
+
+
+SCNatural PEBenchLoad::Next(PEEvent * Buffer, SCNatural Size)
+{
+  int i;
+
+  out = Buffer;
+  fill = 0;
+
+  switch (phase)
+  {
+    case 0:                       // Start: alle Maschinen und Prozesse
+      assert(Size >= (SCNatural)(params.machines + numProcesses + 1));
+      Emit(scTraceSchedulerInit);
+      for (i = 0; i < params.machines; i++)
+      {
+        SetMachine(Emit(scTraceMachineCreate), i);
+      }
+      for (i = 0; i < numProcesses; i++)
+      {
+        SetProcess(Emit(scTraceProcessCreate), i);
+      }
+      phase = 1;
+      break;
+
+    case 1:
+      while (fill + 3 <= Size && emitted < params.events)
+      {
+        Step();
+      }
+      if (emitted >= params.events) phase = 2;
+      break;
+
+    case 2:
+      now += 1.0;
+      Emit(scTraceSchedulerStop);
+      phase = 3;
+      break;
+
+    default:
+      break;
+  }
+  return fill;
+}
+
+/******************************************************************************\
+ PEBenchCheck: Gibt die Reports unveraendert an einen Text-Report weiter und
+   prueft nebenbei ueber PESensor::Export, ob jeder Sensor Ereignisse
+   erhalten hat. Liefert ein Sensor in keinem Report einen Wert ungleich 0,
+   erkennt er z.B. seinen Prozess bzw. seine Maschine nicht wieder; er wird
+   beim Abbau gemeldet und mitgezaehlt. Die Sensoren werden an ihrem Namen
+   aus der Konfiguration (bN, siehe WriteConfig) erkannt.
+\******************************************************************************/
+
+class PEBenchCheck: public PEReportWriter
+{
+  public:
+    PEBenchCheck(const char * FileName, int * Idle);
+    ~PEBenchCheck(void);
+
+    void Expect(int Sensor, const char * Type); // Sensor bN muss Werte liefern
+
+    void BeginReport(const char * Experiment, SCTime Time);
+    void WriteSensor(const PESensor & Sensor);
+    void WriteInstrument(const PEInstrument & Instrument)
+      { out->WriteInstrument(Instrument); }
+    void EndReport(void) { out->EndReport(); }
+    void Flush(void) { out->Flush(); }
+    void Record(int, double Value, const char *)
+      { if (current >= 0 && Value != 0.0 && Value == Value) active[current] = true; }
+
+  private:
+    PEReportWriter * out;
+    int *            idle;       // Sensoren ohne Ereignisse (Ergebnis)
+    const char **    types;      // Sensortyp je Nummer, NULL: nicht pruefen
+    SCBoolean *      active;     // Sensor hat einen Wert ungleich 0 geliefert
+    int              numSensors;
+    int              maxSensors;
+    int              current;    // Nummer des ausgegebenen Sensors, -1: keiner
+};
+
+
+PEBenchCheck::PEBenchCheck(const char * FileName, int * Idle) :
+  out        (PEReportWriter::Create(FileName, PEReportWriter::text)),
+  idle       (Idle),
+  numSensors (0),
+  maxSensors (64),
+  current    (-1)
+{
+  types = new const char *[maxSensors];
+  active = new SCBoolean[maxSensors];
+}
+
+
+PEBenchCheck::~PEBenchCheck(void)
+{
+  int i;
+
+  for (i = 0; i < numSensors; i++)
+  {
+    if (types[i] && !active[i])
+    {
+      std::cerr << "Sensor b" << i << " (" << types[i]
+                << ") received no events!\n";
+      (*idle)++;
+    }
+  }
+  delete[] types;
+  delete[] active;
+  delete out;
+}
+
+
+void PEBenchCheck::Expect(int Sensor, const char * Type)
+{
+  const char ** type;
+  SCBoolean *   flag;
+
+  while (Sensor >= maxSensors)
+  {
+    type = new const char *[maxSensors * 2];
+    flag = new SCBoolean[maxSensors * 2];
+    memcpy(type, types, numSensors * sizeof(const char *));
+    memcpy(flag, active, numSensors * sizeof(SCBoolean));
+    delete[] types;
+    delete[] active;
+    types = type;
+    active = flag;
+    maxSensors *= 2;
+  }
+  for (; numSensors <= Sensor; numSensors++)
+  {
+    types[numSensors] = NULL;
+    active[numSensors] = false;
+  }
+  types[Sensor] = Type;
+}
+
+
+void PEBenchCheck::BeginReport(const char * Experiment, SCTime Time)
+{
+  PEReportWriter::BeginReport(Experiment, Time);
+  out->BeginReport(Experiment, Time);
+}
+
+
+void PEBenchCheck::WriteSensor(const PESensor & Sensor)
+{
+  out->WriteSensor(Sensor);
+
+  if (sscanf(Sensor.GetName(), "b%d", &current) != 1 ||
+      current < 0 || current >= numSensors)
+  {
+    current = -1;
+  }
+  PEReportWriter::WriteSensor(Sensor); // Export => Record
+  current = -1;
+}
+
+/******************************************************************************\
+ Erzeugung der Konfiguration, Durchfuehrung und Ausgabe einer Messung
+\******************************************************************************/
+
+// Konfiguration mit den Sensoren des Typs Type (-1: alle, -2: keine); die
+// Sensoren, die Werte liefern muessen, werden bei Check angemeldet
+static void WriteConfig(FILE * File, const PEBenchParams & Params,
+                        const PEBenchLoad & Load, int Type,
+                        PEBenchCheck & Check)
+{
+  int set, t, i, n = 0, first;
+
+  fprintf(File, "Experiment: \"bench\";\n"
+                "Specification: \"bench\";\n"
+                "Report: \"%s\";\n"
+                "CurvePoints: 64;\n"
+                "ScaleAdaption: 10;\n"
+                "DefaultInterval: 10.0;\n", Params.reportFile);
+  if (Params.pipeline)
+    fprintf(File, "Pipeline: %d;\n", Params.pipeline);
+  if (Params.instrument)
+    fprintf(File, "Instrument;\n");
+
+  fprintf(File, "SensorCreation: {\n");
+  for (set = 0; set < Params.sensorSets; set++)
+  {
+    for (t = 0; sensorTypes[t].name; t++)
+    {
+      const char * name = sensorTypes[t].name;
+
+      if (Type != -1 && Type != t) continue;
+
+      first = n;
+      switch (sensorTypes[t].params)
+      {
+        case pProcess:
+          for (i = 0; i < Params.processTypes; i++)
+            fprintf(File, "  %s b%d: \"%s\";\n", name, n++,
+                    Load.ProcessName(i));
+          break;
+
+        case pSignalProcess:
+          for (i = 0; i < Params.processTypes; i++)
+            fprintf(File, "  %s b%d: \"%s\", \"%s\";\n", name, n++,
+                    Load.SignalName(i % Params.signalTypes),
+                    Load.ProcessName(i));
+          break;
+
+        case pMachine:
+          for (i = 0; i < Params.machines; i++)
+            fprintf(File, "  %s b%d: \"%s\";\n", name, n++,
+                    Load.MachineName(i));
+          break;
+
+        case pRequestMachine:
+          for (i = 0; i < Params.machines; i++)
+            fprintf(File, "  %s b%d: \"%s\", \"%s\";\n", name, n++,
+                    Load.RequestName(i % Params.requestTypes),
+                    Load.MachineName(i));
+          break;
+
+        case pGlobal:
+          fprintf(File, "  %s b%d;\n", name, n++);
+          break;
+
+        case pEvent:
+          for (i = 0; i < Params.processTypes; i++)
+            fprintf(File, "  %s b%d: \"E%d\", In, Signal, \"%s\", \"%s\";\n",
+                    name, n, n, Load.SignalName(i % Params.signalTypes),
+                    Load.ProcessName(i)), n++;
+          break;
+
+        case pActivity:
+          for (i = 0; i < Params.processTypes; i++)
+            fprintf(File, "  %s b%d: \"A%d\", In, Signal, \"%s\", \"%s\", "
+                          "Out, Signal, \"%s\", \"%s\";\n",
+                    name, n, n, Load.SignalName(i % Params.signalTypes),
+                    Load.ProcessName(i),
+                    Load.SignalName((i + 1) % Params.signalTypes),
+                    Load.ProcessName(i)), n++;
+          break;
+      }
+      if (!sensorTypes[t].checked) continue;
+      for (i = first; i < n; i++)
+      {
+        Check.Expect(i, name);
+      }
+    }
+  }
+  fprintf(File, "}\nDisplayCreation: {\n}\n");
+}
+
+
+static long PeakRSS(void)        // in KByte
+{
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+
+  return usage.ru_maxrss;
+}
+
+
+// Eine Messung: Konfiguration erzeugen, Dispatcher aufbauen, Last einspeisen
+// (bzw. aufzeichnen und wiedergeben). Gemessen wird nur die Verteilung, nicht
+// die Erzeugung der Last. Ergebnis: Anzahl Sensoren ohne Ereignisse.
+static int Run(const PEBenchParams & Params, int Type, const char * Title)
+{
+  enum {batchSize = 4096};
+
+  PEBenchLoad *       load = new PEBenchLoad(Params);
+  PEEventDispatcher * dispatcher;
+  PEEvent *           batch = new PEEvent[batchSize];
+  PEBenchCheck *      check;         // geht an den Dispatcher ueber
+  char                config[] = "/tmp/pevbenchXXXXXX";
+  FILE *              file;
+  int                 fd;
+  long                events = 0;
+  int                 idle = 0;
+  SCNatural           i, n;
+  unsigned long long  nanos = 0, begin;
+  std::streambuf *    console;
+
+  check = new PEBenchCheck(Params.reportFile, &idle);
+  if ((fd = mkstemp(config)) < 0 || !(file = fdopen(fd, "w")))
+  {
+    std::cerr << "Cannot create configuration file!\n";
+    abort();
+  }
+  WriteConfig(file, Params, *load, Type, *check);
+  fclose(file);
+
+  console = std::cout.rdbuf(NULL);   // Meldungen des Dispatchers unterdruecken
+  dispatcher = new PEEventDispatcher(config, "bench");
+  std::cout.rdbuf(console);
+  std::cout.clear();
+  unlink(config);
+  dispatcher->OpenReport(check);      // ersetzt den Report der Konfiguration
+
+  if (!Params.replay)
+  {
+    while ((n = load->Next(batch, batchSize)))
+    {
+      begin = PEInstrument::Clock();
+      for (i = 0; i < n; i++)
+      {
+        dispatcher->Inject(batch[i]);
+      }
+      nanos += PEInstrument::Clock() - begin;
+      events += n;
+    }
+    PESensor::SetClock(-1.0);        // wie am Ende von Replay
+  }
+  else
+  {
+    PETraceWriter * writer = new PETraceWriter(Params.traceFile);
+
+    while ((n = load->Next(batch, batchSize)))
+    {
+      for (i = 0; i < n; i++)
+      {
+        writer->Record(batch[i]);
+      }
+      events += n;
+    }
+    delete writer;
+
+    begin = PEInstrument::Clock();
+    dispatcher->Replay(Params.traceFile, Params.replay);
+    nanos = PEInstrument::Clock() - begin;
+  }
+
+  delete dispatcher;
+  delete[] batch;
+  delete load;
+
+  printf("  %-20s %10ld %9.3f %12.0f %9.1f %10ld\n", Title, events,
+         nanos / 1e9, events / (nanos / 1e9), (double)nanos / events,
+         PeakRSS());
+  fflush(stdout);
+
+  return idle;
+}
+
+/******************************************************************************\
+ Selbsttest (-C): Prueft die Statistik von PESTally gegen exakt berechnete
+   Werte, statt nur die Verteilung zu messen:
+   - Merge: 300000 gewichtete Stichproben in [1e9, 1e9 + 1000] (reihum auf
+     drei Tallies verteilt und vereinigt) gegen einen Tally mit allen
+     Stichproben und gegen Mittelwert und Varianz aus zwei Durchlaeufen in
+     long double.
+   - Quantile: 1e6 exponentialverteilte Stichproben gegen die Quantile der
+     sortierten Stichproben (Fehler hoechstens 0,6%); zwei vereinigte
+     Haelften muessen genau dieselben Quantile liefern.
+\******************************************************************************/
+
+class PEBenchTally: public PESTally
+{
+  public:
+    SCBoolean NotifyOnEvent(SCTraceAction) const { return false; }
+    void      Add(double Sample, double Weight = 1.0) { UpdateTally(Sample, Weight); }
+};
+
+static unsigned long long checkRandom = 1;
+
+static double Uniform(void)           // gleichverteilt in (0, 1)
+{
+  checkRandom = checkRandom * 6364136223846793005ULL + 1442695040888963407ULL;
+
+  return ((checkRandom >> 11) + 0.5) / 9007199254740992.0; // 2^53
+}
+
+
+static int CompareDouble(const void * A, const void * B)
+{
+  double a = *(const double *)A, b = *(const double *)B;
+
+  return (a > b) - (a < b);
+}
+
+
+// Eine Pruefung: relativer Fehler von Value gegen Exact hoechstens Limit
+static int Check(const char * What, double Value, double Exact, double Limit)
+{
+  double error = (Value == Exact) ? 0.0 : fabs(Value - Exact) / fabs(Exact);
+
+  printf("  %-26s %22.15g %22.15g %9.2e  %s\n", What, Value, Exact, error,
+         error <= Limit ? "ok" : "FAILED");
+
+  return error <= Limit ? 0 : 1;
+}
+
+
+static int SelfCheck(void)
+{
+  enum {numMerge = 300000, numQuantile = 1000000, numParts = 3};
+
+  static const int    index[] = {PESTally::p50, PESTally::p90,
+                                 PESTally::p95, PESTally::p99};
+  static const double level[] = {0.50, 0.90, 0.95, 0.99};
+  static const char * name[]  = {"p50", "p90", "p95", "p99"};
+
+  PEBenchTally * whole = new PEBenchTally;
+  PEBenchTally * part = new PEBenchTally[numParts];
+  PEBenchTally * half = new PEBenchTally[2];
+  double *       sample = new double[numQuantile];
+  double *       weight = new double[numMerge];
+  long double    sum = 0.0, total = 0.0, mean, m2 = 0.0;
+  char           what[32];
+  int            failed = 0, i;
+
+  PESensor::SetClock(0.0);           // kein Scheduler
+  printf("PEV self-check\n\n  %-26s %22s %22s %9s\n", "Value", "PESTally",
+         "Exact", "Error");
+
+  // Welford und Merge: grosser Mittelwert, kleine Streuung
+  for (i = 0; i < numMerge; i++)
+  {
+    sample[i] = 1e9 + 1000.0 * Uniform();
+    weight[i] = 0.5 + Uniform();
+    whole->Add(sample[i], weight[i]);
+    part[i % numParts].Add(sample[i], weight[i]);
+    sum += (long double)sample[i] * weight[i];
+    total += weight[i];
+  }
+  mean = sum / total;
+  for (i = 0; i < numMerge; i++)
+  {
+    m2 += weight[i] * (sample[i] - mean) * (sample[i] - mean);
+  }
+  for (i = 1; i < numParts; i++)
+  {
+    part[0].Merge(part[i]);
+  }
+  failed += Check("mean", whole->GetValue(PESTally::avg), mean, 1e-14);
+  failed += Check("mean merged", part[0].GetValue(PESTally::avg), mean, 1e-14);
+  failed += Check("variance", whole->GetValue(PESTally::var),
+                  m2 / (total + 1), 1e-9);
+  failed += Check("variance merged", part[0].GetValue(PESTally::var),
+                  m2 / (total + 1), 1e-9);
+  failed += Check("variance merged/single", part[0].GetValue(PESTally::var),
+                  whole->GetValue(PESTally::var), 1e-9);
+
+  // Quantile des Histogramms
+  whole->Reset();
+  for (i = 0; i < numQuantile; i++)
+  {
+    sample[i] = -log(Uniform());
+    whole->Add(sample[i]);
+    half[i & 1].Add(sample[i]);
+  }
+  half[0].Merge(half[1]);
+  qsort(sample, numQuantile, sizeof(double), CompareDouble);
+  for (i = 0; i < 4; i++)
+  {
+    failed += Check(name[i], whole->GetValue(index[i]),
+                    sample[(int)ceil(level[i] * numQuantile) - 1], 0.006);
+    sprintf(what, "%s merged/single", name[i]);
+    failed += Check(what, half[0].GetValue(index[i]),
+                    whole->GetValue(index[i]), 0.0);
+  }
+  PESensor::SetClock(-1.0);
+
+  delete whole;
+  delete[] part;
+  delete[] half;
+  delete[] sample;
+  delete[] weight;
+
+  if (failed)
+  {
+    std::cerr << failed << " check(s) failed!\n";
+    return 1;
+  }
+  printf("\n  all checks passed\n");
+  return 0;
+}
+
+/******************************************************************************\
+ Hauptprogramm
+\******************************************************************************/
+
+static void Usage(void)
+{
+  std::cerr <<
+    "Usage: pevbench [options]\n"
+    "  -n events      number of generated events        (1000000)\n"
+    "  -p types       process types                     (8)\n"
+    "  -i instances   processes per process type        (4)\n"
+    "  -m machines    machines                          (4)\n"
+    "  -c servers     servers per machine               (2)\n"
+    "  -s signals     signal types                      (8)\n"
+    "  -r requests    request types                     (4)\n"
+    "  -z states      states                            (6)\n"
+    "  -k sets        copies of the sensor configuration (1)\n"
+    "  -x w,w,...     weights of send,consume,save,drop,state,request,finish\n"
+    "                                                   (30,25,2,3,10,15,15)\n"
+    "  -t n           mean events per time step         (10)\n"
+    "  -e sensortype  only sensors of this type (e.g. ProcessQLen)\n"
+    "  -a             suite: no sensors, each sensor type, all sensors\n"
+    "  -q size        pipeline mode with queue size\n"
+    "  -R threads     record the load, measure replay with threads\n"
+    "  -f file        trace file for -R                 (/tmp/pevbench.trc)\n"
+    "  -o file        report file                       (/dev/null)\n"
+    "  -I             instrumentation (needs _PEV_INSTRUMENT)\n"
+    "  -S seed        random seed                       (1)\n"
+    "  -C             self-check of the tally statistics (no benchmark)\n";
+  exit(1);
+}
+
+
+int main(int argc, char ** argv)
+{
+  PEBenchParams params;
+  SCBoolean     suite = false;
+  SCBoolean     keepTrace = false;
+  const char *  only = NULL;
+  char *        mix;
+  int           option, type, i;
+  int           idle = 0;     // Sensoren ohne Ereignisse
+  static int    defaultMix[numMixes] = {30, 25, 2, 3, 10, 15, 15};
+
+  params.events       = 1000000;
+  params.processTypes = 8;
+  params.instances    = 4;
+  params.machines     = 4;
+  params.servers      = 2;
+  params.signalTypes  = 8;
+  params.requestTypes = 4;
+  params.states       = 6;
+  params.sensorSets   = 1;
+  params.timeStep     = 10;
+  params.seed         = 1;
+  params.pipeline     = 0;
+  params.replay       = 0;
+  params.traceFile    = "/tmp/pevbench.trc";
+  params.reportFile   = "/dev/null";
+  params.instrument   = false;
+  memcpy(params.mix, defaultMix, sizeof(defaultMix));
+
+  while ((option = getopt(argc, argv, "n:p:i:m:c:s:r:z:k:x:t:e:aq:R:f:o:IS:C")) != -1)
+  {
+    switch (option)
+    {
+      case 'n': params.events = atol(optarg); break;
+      case 'p': params.processTypes = atoi(optarg); break;
+      case 'i': params.instances = atoi(optarg); break;
+      case 'm': params.machines = atoi(optarg); break;
+      case 'c': params.servers = atoi(optarg); break;
+      case 's': params.signalTypes = atoi(optarg); break;
+      case 'r': params.requestTypes = atoi(optarg); break;
+      case 'z': params.states = atoi(optarg); break;
+      case 'k': params.sensorSets = atoi(optarg); break;
+      case 't': params.timeStep = atoi(optarg); break;
+      case 'e': only = optarg; break;
+      case 'a': suite = true; break;
+      case 'q': params.pipeline = atoi(optarg); break;
+      case 'R': params.replay = atoi(optarg); break;
+      case 'f': params.traceFile = optarg; keepTrace = true; break;
+      case 'o': params.reportFile = optarg; break;
+      case 'I': params.instrument = true; break;
+      case 'S': params.seed = atoi(optarg); break;
+      case 'C': return SelfCheck();
+      case 'x':
+        for (i = 0, mix = strtok(optarg, ","); i < numMixes;
+             i++, mix = strtok(NULL, ","))
+        {
+          params.mix[i] = mix ? atoi(mix) : 0;
+        }
+        break;
+      default: Usage();
+    }
+  }
+
+  for (i = 0, type = 0; i < numMixes; i++)
+  {
+    if (params.mix[i] < 0) Usage();
+    type += params.mix[i];
+  }
+  if (optind < argc || params.events <= 0 || type == 0 ||
+      params.processTypes < 1 || params.instances < 1 ||
+      params.machines < 1 || params.servers < 1 || params.signalTypes < 1 ||
+      params.requestTypes < 1 || params.states < 1 || params.sensorSets < 0 ||
+      params.timeStep < 0 || params.pipeline < 0 || params.replay < 0)
+  {
+    Usage();
+  }
+
+  printf("PEV benchmark: %ld events, %d process types x %d, %d machines x %d,"
+         " %d signal types, %d request types\n  mix",
+         params.events, params.processTypes, params.instances,
+         params.machines, params.servers, params.signalTypes,
+         params.requestTypes);
+  for (i = 0; i < numMixes; i++)
+    printf(" %s=%d", mixNames[i], params.mix[i]);
+  printf(", %s", params.pipeline ? "pipeline" : "inline");
+  if (params.replay) printf(", replay with %d thread(s)", params.replay);
+  printf("\n\n  %-20s %10s %9s %12s %9s %10s\n", "Sensors", "Events",
+         "Seconds", "Events/sec", "ns/event", "RSS [KB]");
+
+  if (only)
+  {
+    for (type = 0; sensorTypes[type].name && strcmp(sensorTypes[type].name, only); type++);
+    if (!sensorTypes[type].name)
+    {
+      std::cerr << "Unknown sensor type " << only << "!\n";
+      exit(1);
+    }
+    idle += Run(params, type, only);
+  }
+  else if (suite)
+  {
+    idle += Run(params, -2, "(none)");
+    for (type = 0; sensorTypes[type].name; type++)
+    {
+      idle += Run(params, type, sensorTypes[type].name);
+    }
+    idle += Run(params, -1, "(all)");
+  }
+  else
+  {
+    idle += Run(params, -1, "(all)");
+  }
+
+  if (params.replay && !keepTrace) unlink(params.traceFile);
+
+  if (idle)
+  {
+    std::cerr << idle << " sensor(s) received no events!\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,186 @@
+/******************************************************************************\
+ Datei : PEEvent.cpp
+ Inhalt: Implementierung der Namenstabelle (PEObjectNames) und der
+         Ereigniswarteschlange (PEEventQueue)
+ Status:
+\******************************************************************************/
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "PEEvent.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+/******************************************************************************\
+ PEObjectNames: Implementierung
+\******************************************************************************/
+
+char **   PEObjectNames::names[PEObjectNames::maxTypes];
+SCInteger PEObjectNames::size[PEObjectNames::maxTypes];
+
+
+const char * PEObjectNames::Get(SCObjectType Type, SCInteger ID)
+{
+  if ((int)Type < maxTypes && ID >= 0 && ID < size[Type] && names[Type][ID])
+  {
+    return names[Type][ID];
+  }
+  return SCType::GetObjectName(Type, ID);
+}
+
+
+void PEObjectNames::Set(SCObjectType Type, SCInteger ID, const char * Name)
+{
+  SCInteger i;
+
+  assert((int)Type < maxTypes && ID >= 0);
+
+  if (ID >= size[Type])
+  {
+    SCInteger newSize = size[Type] ? size[Type] : 16;
+
+    while (newSize <= ID) newSize <<= 1;
+    names[Type] = (char **)realloc(names[Type], newSize * sizeof(char *));
+    assert(names[Type]);
+    for (i = size[Type]; i < newSize; i++)
+    {
+      names[Type][i] = NULL;
+    }
+    size[Type] = newSize;
+  }
+  free(names[Type][ID]);
+  names[Type][ID] = strdup(Name);
+}
+
+
+void PEObjectNames::Clear(void)
+{
+  SCInteger i;
+  int       type;
+
+  for (type = 0; type < maxTypes; type++)
+  {
+    for (i = 0; i < size[type]; i++)
+    {
+      free(names[type][i]);
+    }
+    free(names[type]);
+    names[type] = NULL;
+    size[type] = 0;
+  }
+}
+
+
+/******************************************************************************\
+ PEEventQueue: Implementierung
+\******************************************************************************/
+
+PEEventQueue::PEEventQueue(SCNatural Size) :
+  head     (0),
+  tail     (0),
+  sleepers (0)
+{
+  SCNatural size = 2;
+
+  while (size < Size) size <<= 1;
+
+  ring = new PEEvent[size];
+  mask = size - 1;
+
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&wakeup, NULL);
+}
+
+
+PEEventQueue::~PEEventQueue(void)
+{
+  assert(head == tail);
+
+  pthread_cond_destroy(&wakeup);
+  pthread_mutex_destroy(&lock);
+
+  delete[] ring;
+}
+
+
+void PEEventQueue::Put(const PEEvent & Event)
+{
+  SCNatural t;
+
+  while (head - (t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) > mask)
+  {
+    Wait(&tail, t); // Puffer voll
+  }
+  ring[head & mask] = Event;
+  __atomic_store_n(&head, head + 1, __ATOMIC_SEQ_CST);
+  Notify();
+}
+
+
+const PEEvent * PEEventQueue::Peek(void)
+{
+  while (__atomic_load_n(&head, __ATOMIC_ACQUIRE) == tail)
+  {
+    Wait(&head, tail); // Puffer leer
+  }
+  return &ring[tail & mask];
+}
+
+
+void PEEventQueue::Release(void)
+{
+  __atomic_store_n(&tail, tail + 1, __ATOMIC_SEQ_CST);
+  Notify();
+}
+
+
+void PEEventQueue::Drain(void)
+{
+  SCNatural t;
+
+  while ((t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) != head)
+  {
+    Wait(&tail, t);
+  }
+}
+
+
+// Zunaechst kurz aktiv warten, da der andere Thread meist sofort
+// weiterkommt; erst dann an der Bedingungsvariable schlafen. Da sleepers
+// vor der erneuten Pruefung erhoeht wird, kann Notify nach dem Fortschalten
+// eines Index kein Wecken verpassen.
+void PEEventQueue::Wait(SCNatural * Index, SCNatural Value)
+{
+  int i;
+
+  for (i = 64; i--;)
+  {
+    if (__atomic_load_n(Index, __ATOMIC_ACQUIRE) != Value) return;
+    sched_yield();
+  }
+
+  pthread_mutex_lock(&lock);
+  __atomic_add_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(Index, __ATOMIC_SEQ_CST) == Value)
+  {
+    pthread_cond_wait(&wakeup, &lock);
+  }
+  __atomic_sub_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&lock);
+}
+
+
+void PEEventQueue::Notify(void)
+{
+  if (__atomic_load_n(&sleepers, __ATOMIC_SEQ_CST))
+  {
+    pthread_mutex_lock(&lock);
+    pthread_cond_broadcast(&wakeup);
+    pthread_mutex_unlock(&lock);
+  }
+}
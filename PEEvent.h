@@ -0,0 +1,100 @@
+/******************************************************************************\
+ Datei : PEEvent.h
+ Inhalt: Deklaration des Ereignisdatensatzes (PEEvent) und der Warteschlange
+         fuer die Sensorauswertung in einem eigenen Thread (PEEventQueue)
+ Status:
+\******************************************************************************/
+
+#ifndef __PEEVENT_H
+#define __PEEVENT_H
+
+#include <pthread.h>
+
+#include <SCL/SCBasicTypes.h>
+#include <SCL/SCTraceTypes.h>
+#include <SCL/SCStateType.h>
+
+/******************************************************************************\
+ PEEvent: Basis-Ereignis, wie es an die Sensoren verteilt wird. Der Datensatz
+   ist in sich abgeschlossen: Er enthaelt alle Werte, die die Sensoren
+   auswerten, und verweist nur auf langlebige Objekte der SCL (Prozesstypen,
+   Maschinen, Signal-, Request- und Zustandstypen). Fluechtige Objekte
+   (Prozesse, Signale, Requests) dienen nur als Identitaet und werden nicht
+   dereferenziert. Damit kann ein Ereignis auch spaeter oder in einem anderen
+   Thread ausgewertet werden.
+\******************************************************************************/
+
+struct PEEvent
+{
+  SCTraceAction action;       // Basis-Ereignis
+  SCTime        time;         // Simulationszeit des Ereignisses
+  const void *  runnable;     // Prozess bzw. Maschine (Identitaet)
+  const void *  runnableType; // Prozesstyp bzw. Maschine (siehe PERouter)
+  const char *  runnableName; // Name des Prozesstyps bzw. der Maschine
+  const void *  partner;      // Sender, Aufrufer bzw. Erzeuger (Identitaet)
+  const void *  partnerType;  // Prozesstyp des Senders bzw. Aufrufers
+  const void *  msgType;      // Signal-, Request- bzw. Zustandstyp
+  const char *  msgName;      // Name des Signal-, Request- bzw. Zustandstyps
+  SCInteger     msgID;        // ID des Signal-, Request- bzw. Zustandstyps
+  SCTime        msgCreation;  // Erzeugung des Signals bzw. Requests
+  SCTime        msgWaitStart; // Beginn der Wartezeit des Requests
+  SCInteger     freeServers;  // freie Server der Maschine
+  SCInteger     numServers;   // Anzahl Server der Maschine
+};
+
+/******************************************************************************\
+ PEObjectNames: Namen der Zustands-, Signal- und Requesttypen zu ihrer ID, wie
+   sie Haeufigkeits-Reports und -Anzeigen ausgeben. Normalerweise liefert die
+   SCL die Namen (SCType::GetObjectName). Bei der Wiedergabe einer
+   Aufzeichnung laeuft kein Simulator; dann traegt PETraceReader die Namen
+   aus der Aufzeichnung ein.
+\******************************************************************************/
+
+class PEObjectNames
+{
+  public:
+    static const char * Get(SCObjectType Type, SCInteger ID);
+    static void         Set(SCObjectType Type, SCInteger ID, const char * Name);
+    static void         Clear(void);  // wieder die Namen der SCL verwenden
+
+  private:
+    enum {maxTypes = 8};              // SCObjectType-Werte
+
+    static char **   names[maxTypes]; // je Objekttyp Namen nach ID
+    static SCInteger size[maxTypes];
+};
+
+/******************************************************************************\
+ PEEventQueue: Ringpuffer fuer genau einen Erzeuger (Simulator) und genau
+   einen Verbraucher (Auswertungsthread). Schreib- und Leseindex werden ohne
+   Sperren fortgeschaltet; nur wenn der Puffer voll bzw. leer ist, legt sich
+   die wartende Seite an einer Bedingungsvariable schlafen.
+     Der Verbraucher gibt einen Platz erst nach der Auswertung frei, daher
+   bedeutet ein leerer Puffer, dass alle Ereignisse verarbeitet sind (Drain).
+\******************************************************************************/
+
+class PEEventQueue
+{
+  public:
+    PEEventQueue(SCNatural Size);   // Size wird auf Zweierpotenz aufgerundet
+    ~PEEventQueue(void);
+
+    void            Put(const PEEvent & Event); // blockiert nur bei vollem Puffer
+    const PEEvent * Peek(void);                 // blockiert bei leerem Puffer
+    void            Release(void);              // Peek-Ergebnis freigeben
+    void            Drain(void);                // wartet auf leeren Puffer
+
+  private:
+    PEEvent *       ring;
+    SCNatural       mask;
+    SCNatural       head;           // naechster Schreibplatz (Erzeuger)
+    SCNatural       tail;           // naechster Leseplatz (Verbraucher)
+    int             sleepers;       // Anzahl wartender Threads
+    pthread_mutex_t lock;
+    pthread_cond_t  wakeup;
+
+    void Wait(SCNatural * Index, SCNatural Value); // schlafen bis *Index != Value
+    void Notify(void);
+};
+
+#endif
@@ -11,7 +11,20 @@
 #include <time.h>
 #include <sys/time.h>
 
+#include <string.h>
+
+#include <SCL/SCProcess.h>
+#include <SCL/SCProcessType.h>
+#include <SCL/SCMachine.h>
+#include <SCL/SCSignal.h>
+#include <SCL/SCSignalType.h>
+#include <SCL/SCRequest.h>
+#include <SCL/SCRequestType.h>
+#include <SCL/SCStateType.h>
+
+#ifndef _PEV_HEADLESS
 #include "PCController.h"
+#endif
 #include "PEEventDispatcher.h"
 
 #if _SC_DMALLOC
@@ -26,16 +39,24 @@ PEEventDispatcher::PEEventDispatcher(const char * Configuration,
                                      const char * Specification,
                                      double PicsPerSec) :
   SCTrace         (scfTraceAll),
+  traceMask       (TraceFlag(scTraceSchedulerStop) | // Report am Ende
+                   TraceFlag(scTraceTimeChange)),    // Updates, Intervalle
   specification   (Specification),
   updateInterval  ((clock_t)(CLOCKS_PER_SEC / PicsPerSec)), 
   lastUpdateClock (clock()),
   sleepUSecs      ((long)(1000000 / (PicsPerSec + 1))), // Sleep beim synchronen Update 
   asyncUpdate     (false),
+  report          (NULL),
   reportInterval  (0.0),
-  lastReport      (0)
+  lastReport      (0),
+  queue           (NULL),
+  recorder        (NULL),
+  instrument      (NULL),
+  series          (NULL),
+  metrics         (NULL),
+  plots           (NULL),
+  numEvents       (0)
 {
-  SCNatural i;
-
   assert(updateInterval > 0); 
 
   std::cout << "\n"
@@ -47,133 +68,922 @@ PEEventDispatcher::PEEventDispatcher(const char * Configuration,
 
   Setup(Configuration, Specification);
 
-  for (i = 0; i < scTraceMax; i++)
-  {
-    activateOnAction[i].SetDeleteElems(false);
+  actionFlags = traceMask; // SCL liefert nur noch benoetigte Ereignisse
+
+  std::cout << "Done.\n\n";
+  std::cout.flush();
+}
+
+
+PEEventDispatcher::~PEEventDispatcher(void)
+{
+  SetPipelineMode(0);
+  SetRecordMode(NULL);
+  SetInstrumentMode(false);
+  SetSeriesMode(NULL);
+  SetMetricsMode(NULL);
+  SetPlotMode(NULL);
+  registeredSensors.RemoveAllElements();
+  registeredUpdaters.RemoveAllElements();
+
+  CloseReport();
+}
+
+
+void PEEventDispatcher::RegisterSensor(PESensor* ToRegister, const char* Name)
+{
+  int i;
+
+  Drain(); // Auswertungsthread darf den Router nicht gerade benutzen
+  registeredSensors.InsertBefore(ToRegister);
+  if (Name) ToRegister->SetName(Name);
+
+  for (i = scTraceMax; i--;)
+  {
+    if (ToRegister->NotifyOnEvent(SCTraceAction(i)))
+    {
+      router.Insert(ToRegister, SCTraceAction(i));
+      traceMask |= TraceFlag(i);
+    }  
+  }
+  if (instrument) instrument->AddSensor(ToRegister, Name);
+  actionFlags |= traceMask; // nach dem Setup angemeldet => Maske erweitern
+}  
+
+
+void PEEventDispatcher::RegisterUpdater(PCUpdater* ToRegister, const char* Name)
+{
+  registeredUpdaters.InsertBefore(ToRegister);
+  if (instrument) instrument->AddUpdater(ToRegister, Name);
+}
+
+
+void PEEventDispatcher::ResetAllSensors(void)
+{
+  PESensor * sensor;
+
+  SCListIter<PESensor> iter(registeredSensors);
+
+  Drain();
+  for (sensor = iter++;
+       sensor;
+       sensor = iter++)
+  {
+    sensor->Reset();
+  }
+}
+
+
+void PEEventDispatcher::OpenReport(const char * FileName, int Format,
+                                   SCNatural QueueSize)
+{
+  delete report;
+  report = PEReportWriter::Create(FileName, Format, QueueSize);
+}
+
+
+void PEEventDispatcher::OpenReport(PEReportWriter * Writer)
+{
+  delete report;
+  report = Writer;
+}
+
+
+void PEEventDispatcher::CloseReport(void)
+{
+  delete report;
+
+  report = NULL;
+}
+
+
+void PEEventDispatcher::ReportAllSensors(void)
+{
+  PESensor *             sensor;
+  SCListIter<PESensor>   iter(registeredSensors);
+
+  assert(report);
+
+  Drain();
+  report->BeginReport(experiment, PESensor::Now()); // ohne Controller evtl. kein Sensor
+
+  for (sensor = iter++;
+       sensor;
+       sensor = iter++)
+  {
+    report->WriteSensor(*sensor);
+  }
+  if (instrument)
+  {
+    report->WriteInstrument(*instrument);
+    instrument->Dump();
+  }
+  report->EndReport();
+  if (plots) plots->Plot();
+}
+
+
+void PEEventDispatcher::Update(void)
+{
+  PCUpdater *           updater;
+  SCListIter<PCUpdater> iter(registeredUpdaters);
+
+  Drain(); // Updater lesen die Sensoren
+  for (updater = iter++;
+       updater;
+       updater = iter++)
+  {
+    NOTIFY(updater, Update());
+  }
+  if (series) series->Sample(PESensor::Now());
+  if (metrics) metrics->Publish(registeredSensors, experiment,
+                                PESensor::Now(), numEvents);
+#ifndef _PEV_HEADLESS
+  PE_MEASURE(instrument, updateDisplays,
+             xEventDispatcher.UpdateDisplays()); // Anzeige aktualisieren
+#endif
+}
+
+
+#ifndef _PEV_HEADLESS
+void PEEventDispatcher::DoXEvents(void)
+{
+  if (!xEventDispatcher.Pending()) return;
+  // Expose und Resize zeichnen aus den Daten der Sensoren, die der
+  // Auswertungsthread gerade veraendern koennte. Da nur dieser Thread
+  // Ereignisse einreiht, bleibt er bis zum naechsten LogEvent untaetig.
+  Drain();
+  PE_MEASURE(instrument, xEvents, xEventDispatcher.DoEvents());
+}
+#endif
+
+
+void PEEventDispatcher::SetUpdateMode(SCBoolean Async)
+{
+  asyncUpdate = Async;
+}
+
+
+void PEEventDispatcher::SetReportInterval(double Interval)
+{
+  reportInterval = Interval;
+}
+
+
+void PEEventDispatcher::WrongSCLAction()
+{
+  std::cerr << "Invalid scTraceAction!\n";
+  abort();
+} 
+
+
+// Fuellen des Ereignisdatensatzes aus den Objekten der SCL. Es werden nur
+// Werte und Verweise auf langlebige Objekte (Typen, Maschinen) uebernommen,
+// damit das Ereignis auch nach dem LogEvent ausgewertet werden kann.
+// -----------------------------------------------------------------------
+
+static inline void InitEvent(PEEvent & Event, SCInteger Action)
+{
+  memset(&Event, 0, sizeof(Event));
+  Event.action = SCTraceAction(Action);
+  Event.time = PESensor::Now(); // bei der Wiedergabe die Zeit der Aufzeichnung
+}
+
+static inline void SetProcess(PEEvent & Event, const SCProcess * Process)
+{
+  Event.runnable = Process;
+  if (Process)
+  {
+    Event.runnableType = Process->GetType();
+    Event.runnableName = Process->GetType()->GetName();
+  }
+}
+
+static inline void SetMachine(PEEvent & Event, const SCMachine * Machine)
+{
+  Event.runnable = Machine;
+  Event.runnableType = Machine;
+  Event.runnableName = Machine->GetName();
+  Event.freeServers = Machine->NumOfFreeServers();
+  Event.numServers = Machine->NumOfServers();
+}
+
+static inline void SetSignal(PEEvent & Event, const SCSignal * Signal)
+{
+  Event.partner = Signal->GetSender();
+  Event.partnerType = Signal->GetSenderType();
+  Event.msgType = Signal->GetSignalType();
+  Event.msgName = Signal->GetSignalType()->GetName();
+  Event.msgID = Signal->GetSignalType()->GetID();
+  Event.msgCreation = Signal->GetCreationTime();
+}
+
+static inline void SetRequest(PEEvent & Event, const SCRequest * Request)
+{
+  const SCProcess * caller = (SCProcess *)Request->GetCaller();
+
+  Event.partner = caller;
+  Event.partnerType = caller ? caller->GetType() : NULL;
+  Event.msgType = Request->GetRequestType();
+  Event.msgName = Request->GetRequestType()->GetName();
+  Event.msgID = Request->GetRequestType()->GetID();
+  Event.msgCreation = Request->GetCreationTime();
+  Event.msgWaitStart = Request->GetWaitStartTime();
+}
+
+static inline void SetState(PEEvent & Event, const SCStateType * State)
+{
+  Event.msgType = State;
+  Event.msgName = State->GetName();
+  Event.msgID = State->GetID();
+}
+
+
+// Verteilung eines Ereignisses an alle betroffenen Sensoren. Wird direkt
+// aus LogEvent oder im Auswertungsthread aufgerufen, bei der parallelen
+// Wiedergabe mit dem Router einer Teilmenge der Sensoren.
+// ---------------------------------------------------------------------
+
+void PEEventDispatcher::Dispatch(const PEEvent & Event)
+{
+  Dispatch(Event, router);
+}
+
+
+void PEEventDispatcher::Dispatch(const PEEvent & Event, PERouter & Router)
+{
+  PESensor *   sensor;
+  PERouterIter iter(Router, Event.action, Event.runnableType);
+
+  switch (Event.action)
+  {
+    case scTraceSchedulerInit:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSchedInit());
+      }
+      break;
+
+    case scTraceSchedulerStop:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSchedStop());
+      }
+      {
+        PERouterIter endIter(Router, scTraceSchedulerStop);
+
+        for (sensor = endIter++;
+             sensor;
+             sensor = endIter++)
+        {
+          NOTIFY(sensor, EvEnd());
+        }
+      }
+      break;
+
+    case scTraceTimeChange:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvTimeChange(Event.time));
+      }
+      break;
+
+    case scTraceProcessCreate:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvProcessCreate(Event));
+      }
+      if (Router.HasUnresolved()) Router.Resolve();
+      break;
+
+    case scTraceProcessStop:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvProcessDelete(Event));
+      }
+      break;
+
+    case scTraceStateChange:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvStateChange(Event));
+      }
+      break;
+
+    case scTraceSpontTrans:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSpontTrans(Event));
+      }
+      break;
+
+    case scTraceContSignal:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvContSignal(Event));
+      }
+      break;
+
+    case scTraceSignalSend:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSignalSend(Event));
+      }
+      break;
+
+    case scTraceSignalReceive:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSignalReceive(Event));
+      }
+      break;
+
+    case scTraceSignalConsume:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSignalConsume(Event));
+      }
+      break;
+
+    case scTraceSignalSave:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSignalSave(Event));
+      }
+      break;
+
+    case scTraceSignalDrop:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSignalDrop(Event));
+      }
+      break;
+
+    case scTraceSignalLose:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSignalReject(Event));
+      }
+      break;
+
+    case scTraceTimerRemove:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvSignalDrop(Event));
+      }
+      break;
+
+    case scTraceMachineCreate:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvMachineCreate(Event));
+      }
+      if (Router.HasUnresolved()) Router.Resolve();
+      break;
+
+    case scTraceMachineStop:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvMachineDelete(Event));
+      }
+      break;
+
+    case scTraceServiceRequest:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvServiceRequest(Event));
+      }
+      break;
+
+    case scTraceServiceStart:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvServiceStart(Event));
+      }
+      break;
+
+    case scTraceServiceInterrupt:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvServiceInterrupt(Event));
+      }
+      break;
+
+    case scTraceServiceFinish:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvServiceFinish(Event));
+      }
+      break;
+
+    case scTraceTimerSet:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvTimerSet(Event));
+      }
+      break;
+
+    case scTraceTimerReset:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvTimerReset(Event));
+      }
+      break;
+
+    case scTraceTimerFire:
+      for (sensor = iter++;
+           sensor;
+           sensor = iter++)
+      {
+        NOTIFY(sensor, EvTimerFire(Event));
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+
+// Hauptschleife des Auswertungsthreads
+void * PEEventDispatcher::Evaluate(void * Dispatcher)
+{
+  PEEventDispatcher * self = (PEEventDispatcher *)Dispatcher;
+  const PEEvent *     event;
+
+  while ((event = self->queue->Peek())->action != scTraceMax)
+  {
+    PESensor::SetClock(event->time);
+    self->Dispatch(*event);
+    self->queue->Release();
+  }
+  self->queue->Release(); // Endemarke
+  
+  return NULL;
+}
+
+
+void PEEventDispatcher::SetPipelineMode(SCNatural QueueSize)
+{
+  if (queue)
+  {
+    PEEvent quit;
+
+    InitEvent(quit, scTraceMax);
+    queue->Put(quit);
+    pthread_join(evaluator, NULL);
+    delete queue;
+    queue = NULL;
+  }
+
+  if (QueueSize)
+  {
+    queue = new PEEventQueue(QueueSize);
+    if (pthread_create(&evaluator, NULL, Evaluate, this))
+    {
+      std::cerr << "Cannot create evaluation thread!\n";
+      abort();
+    }
+  }
+}
+
+
+void PEEventDispatcher::SetRecordMode(const char * TraceFile)
+{
+  delete recorder;
+  recorder = NULL;
+
+  if (TraceFile)
+  {
+    recorder = new PETraceWriter(TraceFile);
+    traceMask |= TraceFlag(scTraceMax) - 1; // alle Aktionen aufzeichnen
+    actionFlags |= traceMask;
+  }
+}
+
+
+void PEEventDispatcher::SetSeriesMode(const char * SeriesFile)
+{
+  delete series;
+  series = NULL;
+
+  if (SeriesFile)
+  {
+    series = new PESeriesWriter(SeriesFile);
+  }
+}
+
+
+void PEEventDispatcher::SetMetricsMode(const char * SocketPath)
+{
+  delete metrics;
+  metrics = NULL;
+
+  if (SocketPath)
+  {
+    metrics = new PEMetricsExporter(SocketPath);
+  }
+}
+
+
+void PEEventDispatcher::SetPlotMode(const char * Prefix, int Format,
+                                    int Width, int Height)
+{
+  delete plots;
+  plots = NULL;
+
+  if (Prefix)
+  {
+    plots = new PVPlotter(Prefix, Format, Width, Height);
+  }
+}
+
+
+void PEEventDispatcher::AddSeriesColumn(const PESensor * Sensor, int ValIndex,
+                                        const char * Name)
+{
+  if (series) series->AddColumn(Sensor, ValIndex, Name);
+}
+
+
+void PEEventDispatcher::SetInstrumentMode(SCBoolean On, const char * DumpFile)
+{
+  Drain(); // Auswertungsthread darf die Zaehler nicht gerade benutzen
+  delete instrument;
+  instrument = NULL;
+
+  if (On)
+  {
+#ifdef _PEV_INSTRUMENT
+    PESensor *            sensor;
+    PCUpdater *           updater;
+    SCListIter<PESensor>  sensorIter(registeredSensors, false); // Anmeldereihenfolge
+    SCListIter<PCUpdater> updaterIter(registeredUpdaters, false);
+
+    instrument = new PEInstrument(DumpFile);
+    for (sensor = sensorIter++;
+         sensor;
+         sensor = sensorIter++)
+    {
+      instrument->AddSensor(sensor, NULL);
+    }
+    for (updater = updaterIter++;
+         updater;
+         updater = updaterIter++)
+    {
+      instrument->AddUpdater(updater, NULL);
+    }
+#else
+    std::cerr << "Instrumentation not available (compile with _PEV_INSTRUMENT)!\n";
+#endif
+  }
+}
+
+
+// Wiedergabe einer Aufzeichnung: Zeitfortschritt und Scheduler-Ereignisse
+// laufen ueber die LogEvent-Funktionen (Updates, Reports), alle anderen
+// Ereignisse werden direkt verteilt (siehe Inject). PESensor::Now() liefert
+// dabei die aufgezeichnete Zeit.
+void PEEventDispatcher::Replay(const char * TraceFile, int Threads)
+{
+  PEEvent event;
+
+  // Die Aufzeichnungsdatei wird erst beim ersten Ereignis angelegt, ist
+  // also noch unversehrt
+  if (recorder && !strcmp(recorder->GetFileName(), TraceFile))
+  {
+    SetRecordMode(NULL);
+  }
+
+  PEObjectNames::Clear();     // Namen kommen aus der Aufzeichnung
+
+  if (Threads > 1)
+  {
+    ReplayParallel(TraceFile, Threads);
+    return;
+  }
+
+  PETraceReader trace(TraceFile);
+
+  while (trace.Next(event))
+  {
+    Inject(event);
+  }
+  Drain();
+  PESensor::SetClock(-1.0);
+}
+
+
+// Einspeisen eines fertigen Ereignisses (Wiedergabe, synthetische Lasten).
+// Wie bei der SCL werden nur Aktionen der Trace-Maske weitergegeben.
+void PEEventDispatcher::Inject(const PEEvent & Event)
+{
+  PESensor::SetClock(Event.time);
+
+  if (!(traceMask & TraceFlag(Event.action))) return;
+
+  switch (Event.action)
+  {
+    case scTraceSchedulerInit:
+    case scTraceSchedulerStop:
+      LogEvent(Event.action);
+      break;
+
+    case scTraceTimeChange:
+      LogEvent(Event.action, Event.time);
+      break;
+
+    default:
+      DoXEvents();
+      Deliver(Event);
+      break;
   }
-
-  std::cout << "Done.\n\n";
-  std::cout.flush();
 }
 
 
-PEEventDispatcher::~PEEventDispatcher(void)
+// Parallele Wiedergabe: Die Sensoren werden reihum auf Threads verteilt, jeder
+// Thread verteilt alle Ereignisse ueber den Router seiner Sensoren. Gelesen
+// und dekodiert wird die Aufzeichnung nur einmal, vom aufrufenden Thread: Er
+// legt die Ereignisse blockweise in einem Ringpuffer ab (PEReplayFeed), den
+// alle Threads lesen; ein Block wird erst wieder gefuellt, wenn ihn alle
+// Threads ausgewertet haben. Reports setzen eine Synchronisation aller
+// Threads voraus; dann erzeugt einer von ihnen den Report ueber alle Sensoren
+// (in der Reihenfolge von registeredSensors). Updater werden nicht bedient.
+struct PEEventDispatcher::PEReplayFeed
 {
-  registeredSensors.RemoveAllElements();
-  registeredUpdaters.RemoveAllElements();
+  enum {blockSize = 1024,     // Ereignisse je Block
+        numBlocks = 8};       // Bloecke im Ringpuffer
 
-  CloseReport();
-}
+  struct PEBlock
+  {
+    PEEvent   events[blockSize];
+    SCNatural count;          // 0: Ende der Aufzeichnung
+    SCNatural sequence;       // laufende Nummer des Blocks
+    int       readers;        // Threads, die den Block noch auswerten
+  };
 
+  PEBlock *       blocks;
+  int             numReaders;
+  pthread_mutex_t lock;
+  pthread_cond_t  filled;     // ein Block wurde gefuellt
+  pthread_cond_t  emptied;    // ein Block wurde von allen ausgewertet
 
-void PEEventDispatcher::RegisterSensor(PESensor* ToRegister)
+  PEReplayFeed(int Readers);
+  ~PEReplayFeed(void);
+
+  void            Fill(PETraceReader & Trace, PEInstrument * Instrument);
+  const PEBlock * Get(SCNatural Sequence);  // wartet auf den Block
+  void            Release(const PEBlock * Block);
+};
+
+
+PEEventDispatcher::PEReplayFeed::PEReplayFeed(int Readers) :
+  numReaders(Readers)
 {
   int i;
 
-  registeredSensors.InsertBefore(ToRegister);
-
-  for (i = scTraceMax; i--;)
+  blocks = new PEBlock[numBlocks];
+  for (i = 0; i < numBlocks; i++)
   {
-    if (ToRegister->NotifyOnEvent(SCTraceAction(i)))
-    {
-      activateOnAction[i].InsertBefore(ToRegister);
-    }  
+    blocks[i].count = 0;
+    blocks[i].sequence = ~(SCNatural)0;
+    blocks[i].readers = 0;
   }
-}  
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&filled, NULL);
+  pthread_cond_init(&emptied, NULL);
+}
 
 
-void PEEventDispatcher::RegisterUpdater(PCUpdater* ToRegister)
+PEEventDispatcher::PEReplayFeed::~PEReplayFeed(void)
 {
-  registeredUpdaters.InsertBefore(ToRegister);
+  pthread_cond_destroy(&emptied);
+  pthread_cond_destroy(&filled);
+  pthread_mutex_destroy(&lock);
+  delete[] blocks;
 }
 
 
-void PEEventDispatcher::ResetAllSensors(void)
+void PEEventDispatcher::PEReplayFeed::Fill(PETraceReader & Trace,
+                                           PEInstrument * Instrument)
 {
-  PESensor * sensor;
-
-  SCListIter<PESensor> iter(registeredSensors);
+  PEBlock * block;
+  SCNatural sequence;
 
-  for (sensor = iter++;
-       sensor;
-       sensor = iter++)
+  for (sequence = 0;; sequence++)
   {
-    sensor->Reset();
+    block = &blocks[sequence % numBlocks];
+
+    pthread_mutex_lock(&lock);
+    while (block->readers)
+    {
+      pthread_cond_wait(&emptied, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+
+    for (block->count = 0;
+         block->count < blockSize && Trace.Next(block->events[block->count]);
+         block->count++)
+    {
+      if (Instrument) Instrument->CountEvent(block->events[block->count].action);
+    }
+
+    pthread_mutex_lock(&lock);
+    block->sequence = sequence;
+    block->readers = numReaders;
+    pthread_cond_broadcast(&filled);
+    pthread_mutex_unlock(&lock);
+
+    if (!block->count) break;
   }
 }
 
 
-void PEEventDispatcher::OpenReport(const char * FileName)
+const PEEventDispatcher::PEReplayFeed::PEBlock *
+PEEventDispatcher::PEReplayFeed::Get(SCNatural Sequence)
 {
-  report = new SCStream(FileName);
+  PEBlock * block = &blocks[Sequence % numBlocks];
+
+  pthread_mutex_lock(&lock);
+  while (!block->readers || block->sequence != Sequence)
+  {
+    pthread_cond_wait(&filled, &lock);
+  }
+  pthread_mutex_unlock(&lock);
+  return block;
 }
 
 
-void PEEventDispatcher::CloseReport(void)
+void PEEventDispatcher::PEReplayFeed::Release(const PEBlock * Block)
 {
-  delete report;
-
-  report = NULL;
+  pthread_mutex_lock(&lock);
+  if (!--((PEBlock *)Block)->readers)
+  {
+    pthread_cond_signal(&emptied);
+  }
+  pthread_mutex_unlock(&lock);
 }
 
 
-void PEEventDispatcher::ReportAllSensors(void)
+struct PEEventDispatcher::PEPartition
 {
-  PESensor *             sensor;
-  SCListIter<PESensor>   iter(registeredSensors);
-  SCListCons<PESensor> * head;
+  PEEventDispatcher * dispatcher;
+  PEReplayFeed *      feed;
+  pthread_barrier_t * barrier;
+  PERouter            router;     // Sensoren dieses Threads
+  pthread_t           thread;
+};
 
-  assert(report);
 
-  head = registeredSensors.Head();
-  sensor = (*head)();
+void PEEventDispatcher::ReplayParallel(const char * TraceFile, int Threads)
+{
+  PEPartition *        partitions = new PEPartition[Threads];
+  PEReplayFeed         feed(Threads);
+  PETraceReader        trace(TraceFile);
+  pthread_barrier_t    barrier;
+  PESensor *           sensor;
+  SCListIter<PESensor> iter(registeredSensors, false); // Anmeldereihenfolge
+  int                  i, action;
 
-  (*report) << std::endl << "PEV-Report for experiment '" << experiment << "' at ";
-  (*report) << sensor->Now(); // Das Controller-Objekt
-  (*report) << ":\n==========\n\n";
+  Drain();
+  pthread_barrier_init(&barrier, NULL, Threads);
 
-  for (sensor = iter++;
+  for (i = 0, sensor = iter++;
        sensor;
-       sensor = iter++)
+       i = (i + 1) % Threads, sensor = iter++)
   {
-    sensor->Report(*report);
+    for (action = scTraceMax; action--;)
+    {
+      if (sensor->NotifyOnEvent(SCTraceAction(action)))
+        partitions[i].router.Insert(sensor, SCTraceAction(action));
+    }
   }
-  (*report) << "<<< End of report >>>\n\n";
-}
-
-
-void PEEventDispatcher::Update(void)
-{
-  PCUpdater *           updater;
-  SCListIter<PCUpdater> iter(registeredUpdaters);
 
-  for (updater = iter++;
-       updater;
-       updater = iter++)
+  for (i = 0; i < Threads; i++)
+  {
+    partitions[i].dispatcher = this;
+    partitions[i].feed = &feed;
+    partitions[i].barrier = &barrier;
+    if (pthread_create(&partitions[i].thread, NULL,
+                       ReplayPartition, &partitions[i]))
+    {
+      std::cerr << "Cannot create replay thread!\n";
+      abort();
+    }
+  }
+  feed.Fill(trace, instrument);
+  for (i = 0; i < Threads; i++)
   {
-    updater->Update();
+    pthread_join(partitions[i].thread, NULL);
   }
-  xEventDispatcher.UpdateDisplays(); // Anzeige aktualisieren
+
+  pthread_barrier_destroy(&barrier);
+  delete[] partitions;
 }
 
 
-void PEEventDispatcher::SetUpdateMode(SCBoolean Async)
+void * PEEventDispatcher::ReplayPartition(void * Partition)
 {
-  asyncUpdate = Async;
-}
+  PEPartition *                 part = (PEPartition *)Partition;
+  PEEventDispatcher *           self = part->dispatcher;
+  const PEReplayFeed::PEBlock * block;
+  const PEEvent *               event;
+  const PEEvent *               end;
+  SCNatural                     sequence;
+  SCTime                        lastReport = self->lastReport;
+
+  for (sequence = 0;; sequence++)
+  {
+    block = part->feed->Get(sequence);
+    if (!block->count)
+    {
+      part->feed->Release(block);
+      break;
+    }
 
+    for (event = block->events, end = event + block->count; event < end; event++)
+    {
+      PESensor::SetClock(event->time);
 
-void PEEventDispatcher::SetReportInterval(double Interval)
-{
-  reportInterval = Interval;
-}
+      // Intervall-Report wie in LogEvent vor dem Zeitfortschritt
+      if (event->action == scTraceTimeChange &&
+          self->reportInterval &&
+          (event->time - lastReport) > self->reportInterval)
+      {
+        lastReport = event->time;
+        if (pthread_barrier_wait(part->barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+          self->lastReport = lastReport;
+          self->ReportAllSensors();
+          self->ResetAllSensors();
+        }
+        pthread_barrier_wait(part->barrier);
+      }
 
+      self->Dispatch(*event, part->router);
 
-void PEEventDispatcher::WrongSCLAction()
-{
-  std::cerr << "Invalid scTraceAction!\n";
-  abort();
-} 
+      // Abschluss-Report wie in LogEvent nach dem Scheduler-Stop
+      if (event->action == scTraceSchedulerStop)
+      {
+        if (pthread_barrier_wait(part->barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+        {
+          self->ReportAllSensors();
+          self->report->Flush();
+          if (self->plots) self->plots->Flush();
+        }
+        pthread_barrier_wait(part->barrier);
+      }
+    }
+    part->feed->Release(block);
+  }
+  return NULL;
+}
 
 
 // Umsetzung von LogEvents in Sensor-Ereignisse. Der Aufruf der Funktion exit()
@@ -229,38 +1039,25 @@ void PEEventDispatcher::LogEvent(const SCInteger pAction)
 {
   ENTER;
   
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   DoXEvents();
   
   switch(pAction)
   {
-
     case scTraceSchedulerInit: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSchedInit(); 
-      }
+      InitEvent(event, pAction);
+      Deliver(event);
       break;
     
     case scTraceSchedulerStop: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSchedStop(); 
-      }
-      iter.GoToFirst();
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvEnd(); 
-      }
-      ReportAllSensors();
+      InitEvent(event, pAction);
+      Deliver(event);
+      ReportAllSensors(); // wartet auf die Auswertung aller Ereignisse
+      report->Flush();    // auch asynchron geschriebene Reports vollstaendig
+      if (recorder) recorder->Flush();
+      if (series) series->Flush();
+      if (plots) plots->Flush();
       break;
 
     case scTraceDeadlock:
@@ -275,8 +1072,7 @@ void PEEventDispatcher::LogEvent(const SCInteger pAction)
 // Simulation time change
 void PEEventDispatcher::LogEvent(const SCInteger pAction, const SCTime newTime)
 {
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[scTraceTimeChange]);
+  PEEvent event;
 
   if (newTime < 0) return;
 
@@ -297,12 +1093,15 @@ void PEEventDispatcher::LogEvent(const SCInteger pAction, const SCTime newTime)
   {
     Update();
     DoXEvents();
+#ifndef _PEV_HEADLESS
     {  // Dieser Block simuliert ein Sleep mit einer Aufloesung kleiner als Sekunden    
        struct timeval TimeOut;
        TimeOut.tv_sec = 0;
        TimeOut.tv_usec = sleepUSecs; // 1000000 usecs = 1 sec
-       select(0, NULL, NULL, NULL, &TimeOut);
+       PE_MEASURE(instrument, syncSleep,
+                  select(0, NULL, NULL, NULL, &TimeOut));
     }
+#endif
   }
   DoXEvents();
   
@@ -316,10 +1115,10 @@ void PEEventDispatcher::LogEvent(const SCInteger pAction, const SCTime newTime)
   }
   
   if (pAction != scTraceTimeChange) WrongSCLAction(); 
-  for (sensor = iter++; sensor; sensor = iter++)
-  {
-    sensor->EvTimeChange(newTime);
-  }  
+
+  InitEvent(event, pAction);
+  event.time = newTime;
+  Deliver(event);
   LEAVE;
 }
 
@@ -330,27 +1129,15 @@ void PEEventDispatcher::LogEvent(const SCInteger pAction, SCMachine* machine)
   ENTER;
   DoXEvents();
   
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     case scTraceMachineCreate: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvMachineCreate(machine);
-      }
-      break;
-    
     case scTraceMachineStop:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvMachineDelete(machine);
-      }
+      InitEvent(event, pAction);
+      SetMachine(event, machine);
+      Deliver(event);
       break;
    
     default: WrongSCLAction();
@@ -364,18 +1151,14 @@ void PEEventDispatcher::LogEvent (const SCInteger pAction, SCProcess *process)
   ENTER;
   DoXEvents();
   
-  PESensor * sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     case scTraceProcessStop:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvProcessDelete(process);
-      }
+      InitEvent(event, pAction);
+      SetProcess(event, process);
+      Deliver(event);
       break;
    
     default: WrongSCLAction();
@@ -391,19 +1174,17 @@ void PEEventDispatcher::LogEvent(const SCInteger pAction,
   ENTER;
   DoXEvents();
   
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     
     case scTraceProcessCreate: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvProcessCreate(process, creator);
-      }
+      InitEvent(event, pAction);
+      SetProcess(event, process);
+      event.partner = creator;
+      event.partnerType = creator ? creator->GetType() : NULL;
+      Deliver(event);
       break;
     
     default: WrongSCLAction();
@@ -460,45 +1241,18 @@ void PEEventDispatcher::LogEvent(const SCInteger  pAction,
   ENTER;
   DoXEvents();
   
-  PESensor * sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     case scTraceServiceRequest: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvServiceRequest(machine, request);
-      }
-      break;
-    
     case scTraceServiceStart:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvServiceStart(machine, request);
-      }
-      break;
- 
     case scTraceServiceInterrupt:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvServiceInterrupt(machine, request);      
-      }
-      break;
-      
     case scTraceServiceFinish:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvServiceFinish(machine, request);      
-      }
+      InitEvent(event, pAction);
+      SetMachine(event, machine);
+      SetRequest(event, request);
+      Deliver(event);
       break;
     
     default: WrongSCLAction();
@@ -518,20 +1272,19 @@ void PEEventDispatcher::LogEvent(const SCInteger  pAction,
   ENTER;
   DoXEvents();
   
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[scTraceSignalSend]);
+  PEEvent event;
 
   if (pAction != scTraceSignalSend)
     WrongSCLAction();
 
   if ((actionFlags & scfTraceSignalSend))
   {
-    for (sensor = iter++;
-         sensor;
-         sensor = iter++)
-    {
-      sensor->EvSignalSend(sender, receiver, signal);
-    }
+    InitEvent(event, pAction);
+    SetProcess(event, receiver);
+    SetSignal(event, signal);
+    event.partner = sender;
+    event.partnerType = sender ? sender->GetType() : NULL;
+    Deliver(event);
   }
 
   LEAVE;
@@ -566,63 +1319,20 @@ void PEEventDispatcher::LogEvent(const SCInteger  pAction,
   ENTER; 
   DoXEvents();
 
-  PESensor * sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     case scTraceSignalReceive:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSignalReceive(process, signal);
-      }
-      break;
-
     case scTraceSignalConsume: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSignalConsume(process, signal);
-      }
-      break;
-    
     case scTraceSignalSave:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSignalSave(process, signal);
-      }
-      break;
- 
     case scTraceSignalDrop:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSignalDrop(process, signal);
-      }
-      break;
-      
     case scTraceSignalLose:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSignalReject(process, signal);
-      }
-      break;
-
     case scTraceTimerRemove:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSignalDrop(process, signal);
-      }
+      InitEvent(event, pAction);
+      SetProcess(event, process);
+      SetSignal(event, signal);
+      Deliver(event);
       break;
 
     default: WrongSCLAction();
@@ -640,19 +1350,17 @@ void PEEventDispatcher::LogEvent (const SCInteger pAction,
 
   (void)transition;
 
-  PESensor * sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     case scTraceSignalConsume: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSignalConsume(process, signal);
-      }
+      InitEvent(event, pAction);
+      SetProcess(event, process);
+      SetSignal(event, signal);
+      Deliver(event);
       break;
+
     default: WrongSCLAction();
   }
   LEAVE;
@@ -668,27 +1376,15 @@ void PEEventDispatcher::LogEvent(const SCInteger  pAction,
 
   (void)transition;
   
-  PESensor * sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     case scTraceSpontTrans:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvSpontTrans(process);
-      }
-      break;
-      
     case scTraceContSignal:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvContSignal(process);
-      }
+      InitEvent(event, pAction);
+      SetProcess(event, process);
+      Deliver(event);
       break;
       
     default: WrongSCLAction();
@@ -701,33 +1397,21 @@ void PEEventDispatcher::LogEvent(const SCInteger pAction,
                                  SCProcess *     process,
                                  const SCTimer * timer)
 {
-  (void)process;
+  (void)timer;
 
   ENTER;
   DoXEvents();
   
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[pAction]);
+  PEEvent event;
 
   switch (pAction)
   {
     
     case scTraceTimerSet: 
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvTimerSet(timer);
-      }
-      break;
-    
     case scTraceTimerReset:
-      for (sensor = iter++;
-           sensor;
-           sensor = iter++)
-      {
-        sensor->EvTimerReset(timer);
-      }
+      InitEvent(event, pAction);
+      SetProcess(event, process);
+      Deliver(event);
       break;
  
     case scTraceSignalSend: // Delayed Output
@@ -744,23 +1428,22 @@ void PEEventDispatcher::LogEvent(const SCInteger  pAction,
                                  const SCTimer *  timer,
                                  const SCSignal * signal)
 {
-  (void)process;
+  (void)timer;
 
   ENTER;
   DoXEvents();
   
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[scTraceTimerFire]);
+  PEEvent event;
 
   if (pAction != scTraceTimerFire)
     WrongSCLAction();
 
   if ((actionFlags & scfTraceTimerFire))
   {
-    for (sensor = iter++; sensor; sensor = iter++)
-    {
-      sensor->EvTimerFire(timer, signal);
-    }
+    InitEvent(event, pAction);
+    SetProcess(event, process);
+    if (signal) SetSignal(event, signal);
+    Deliver(event);
   }
   LEAVE;
 }
@@ -776,20 +1459,18 @@ void PEEventDispatcher::LogEvent(const SCInteger     pAction,
   ENTER;
   DoXEvents();
   
-  PESensor *           sensor;
-  SCListIter<PESensor> iter(activateOnAction[scTraceStateChange]);
+  PEEvent event;
 
   if (pAction != scTraceStateChange)
     WrongSCLAction();
 
   if ((actionFlags & scfTraceStateChange))
   {
-    for (sensor = iter++; sensor; sensor = iter++)
-    {
-      sensor->EvStateChange(process, newState);
-    }
+    InitEvent(event, pAction);
+    SetProcess(event, process);
+    SetState(event, newState);
+    Deliver(event);
   }
 
   LEAVE;
 }
-
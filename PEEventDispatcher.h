@@ -20,18 +20,46 @@
 #ifndef __PESENSOR_H
 #include "PESensor.h"
 #endif
+#ifndef __PEEVENT_H
+#include "PEEvent.h"
+#endif
+#ifndef __PETRACEFILE_H
+#include "PETraceFile.h"
+#endif
+#ifndef __PESERIESFILE_H
+#include "PESeriesFile.h"
+#endif
+#ifndef __PEREPORTWRITER_H
+#include "PEReportWriter.h"
+#endif
+#ifndef __PEMETRICS_H
+#include "PEMetrics.h"
+#endif
+#ifndef __PEROUTER_H
+#include "PERouter.h"
+#endif
 #ifndef __PCUPDATER_H
 #include "PCUpdater.h"
 #endif
+#ifndef __PEINSTRUMENT_H
+#include "PEInstrument.h"
+#endif
+#ifndef __PVPLOT_H
+#include "PVPlot.h"
+#endif
+#ifndef _PEV_HEADLESS
 #ifndef __PVXEVENTDISPATCHER_H
 #include "PVXEventDispatcher.h"   // Verwaltung der Xlib-Ereignisse
 #endif
+#endif
 
 /******************************************************************************\
  PEEventDispatcher: Verwaltung der LogEvent-Ereignisse aus der SCL und 
   Low-Level Steuerung des Simulators (siehe Dipl-Doku). 
     Jedes LogEvent wird in Basis-Ereignisse (scTraceAction) aufgeloest. Jeder 
-  Sensor, der sich fuer ein Basis-Ereignis registriert hat, wird benachrichtigt.
+  Sensor, der sich fuer ein Basis-Ereignis registriert hat und sich auf den
+  beteiligten Prozesstyp bzw. die Maschine bezieht, wird benachrichtigt (siehe
+  PERouter).
   XEvents, die sich waehrend der Simulationszeit angesammelt haben werden
   bearbeitet. Zu diesen Zeitpunkten kann der Benutzer in die Steuerung des
   Simulators eingreifen. Im Gegensatz zu den ueblichen Anwendung mittels 
@@ -43,6 +71,59 @@
   zurueckkehrt, sobald alle XEvents abgearbeitet wurden. Aufgrund der Haeufigkeit
   der LogEvents bemerkt der Benutzer keinen Unterschied in der Reaktionszeit
   zu einer konventionellen Anwendung (zumindest auf einem 486'er).
+    Die Trace-Maske der SCL wird nach dem Setup auf die Aktionen beschraenkt,
+  fuer die sich Sensoren angemeldet haben (plus Scheduler-Stop und Zeit-
+  fortschritt fuer Reports und Updates). Spaeter angemeldete Sensoren
+  erweitern die Maske wieder.
+    Im Pipeline-Modus (SetPipelineMode) legt LogEvent nur einen PEEvent-
+  Datensatz in einem Ringpuffer ab; ein eigener Thread verteilt die
+  Ereignisse an die Sensoren. Vor Updates, Reports, Resets, dem Bearbeiten
+  anstehender XEvents und am Ende der Simulation wird gewartet, bis alle Ereignisse ausgewertet sind.
+  Der Modus ist nur fuer Rechner mit mehreren Kernen gedacht, auf denen der
+  Simulator selbst den groessten Teil der Zeit braucht; je Ereignis kostet
+  er mehr als die Auswertung im Simulator-Thread (pevbench -q auf einem Kern:
+  etwa 230 statt 90 ns). Ohne SetPipelineMode wird daher wie bisher im
+  Simulator-Thread ausgewertet.
+    Mit SetRecordMode wird jedes verteilte Ereignis zusaetzlich in eine
+  Trace-Datei geschrieben (siehe PETraceFile.h). Replay gibt eine solche
+  Datei ohne laufenden Simulator an die Sensoren der aktuellen Konfiguration
+  weiter; Updates, Intervall-Reports und der Abschluss-Report entstehen wie
+  waehrend der Simulation. Mit Threads > 1 werden die Sensoren auf mehrere
+  Threads verteilt, die die einmal gelesenen Ereignisse gemeinsam auswerten;
+  die Reports sind dieselben, Updater werden dabei aber nicht bedient. Jeder
+  Thread geht dabei alle Ereignisse durch; ob sich das lohnt, haengt von der
+  Zahl der Kerne und dem Aufwand der Sensoren ab (auf einem Kern steigt die
+  Zeit je Ereignis mit jedem Thread, pevbench -R). Inject gibt einzelne
+  Ereignisse auf demselben Weg weiter (z.B. synthetische Lasten, PEBench).
+    SetInstrumentMode misst den Aufwand von PEV selbst (Ereignisse je
+  Aktion, Zeit je Sensor und Updater, DoXEvents, UpdateDisplays, Sleep im
+  synchronen Modus, siehe PEInstrument.h) und haengt ihn an jeden Report an.
+  Die Messung muss mit _PEV_INSTRUMENT uebersetzt sein.
+    Reports werden ueber einen PEReportWriter ausgegeben (OpenReport): als
+  Text wie bisher oder maschinenlesbar als CSV, JSON Lines oder binaer mit
+  einem Datensatz je Sensorwert (siehe PEReportWriter.h). Die Namen der
+  Sensoren in diesen Datensaetzen stammen aus RegisterSensor. Mit einer
+  QueueSize > 0 kopiert der Simulator beim Report nur die Werte, ein eigener
+  Thread formatiert und schreibt sie (PEAsyncReportWriter); beim Text
+  formatiert weiterhin der Simulator, nur das Schreiben uebernimmt der
+  Thread. Am Ende der Simulation wird gewartet, bis alle Reports
+  geschrieben sind.
+    SetSeriesMode schreibt bei jedem Update die Werte aller in Kurven und
+  Gantt-Diagrammen angezeigten Sensorwerte (AddSeriesColumn, beim Setup)
+  als Zeile in eine Zeitreihendatei (siehe PESeriesFile.h), die nach der
+  Simulation mit pevseries nach Simulationszeit ausgelesen werden kann.
+    SetMetricsMode stellt die aktuellen Werte aller Sensoren und einige
+  Kennzahlen des Dispatchers an einem Unix-Socket im OpenMetrics-Format
+  bereit (siehe PEMetrics.h); der Schnappschuss dafuer entsteht beim Update.
+  Mit SharedMemory in der Konfiguration legt ein PCShmUpdater dieselben
+  Werte bei jedem Update in einem Shared-Memory-Segment ab (PCUpdater.h).
+    SetPlotMode gibt die Displays bei jedem Report zusaetzlich als Bilder
+  (PPM, PNG mit zlib oder SVG) aus, auch ohne X-Server; das Setup legt dazu je
+  Display einen PVPlot an (siehe PVPlot.h). Gerastert und geschrieben wird
+  in einem eigenen Thread, am Ende der Simulation wird darauf gewartet.
+    Wird mit _PEV_HEADLESS uebersetzt (libPEVCore), entfaellt die gesamte
+  Visualisierung: Es wird keine Verbindung zum X-Server aufgebaut, der Block
+  DisplayCreation der Konfiguration wird nur ueberlesen und DoXEvents ist leer.
 \******************************************************************************/
 
 class PEEventDispatcher: public SCTrace 
@@ -54,16 +135,36 @@ class PEEventDispatcher: public SCTrace
                       double PicsPerSec = 10); // Updates pro Sekunde
     ~PEEventDispatcher(void);
 
-    void RegisterSensor(PESensor* ToRegister);   // Anmelden und
+    void RegisterSensor(PESensor* ToRegister,    // Anmelden und
+                        const char* Name = NULL);
     // void UnRegisterSensor(PESensor* Sensor);  // Abmelden eines Sensors
-    void RegisterUpdater(PCUpdater* ToRegister); // Anmelden
+    void RegisterUpdater(PCUpdater* ToRegister,  // Anmelden
+                         const char* Name = NULL);
     // void UnRegisterUpdater();                 // und Abmelden
     void ResetAllSensors(void);                  // alle Sensoren zuruecksetzen
     void ReportAllSensors(void);                 // Report ueber Sensoren erzeugen
-    void OpenReport(const char * File);          // Oeffnet fstream report
+    void OpenReport(const char * File,           // Oeffnet report im
+                    int Format = PEReportWriter::text, // angegebenen Format,
+                    SCNatural QueueSize = 0);    // evtl. asynchron
+    void OpenReport(PEReportWriter * Writer);    // eigener Writer (wird uebernommen)
     void CloseReport(void);                      // Schliet reportstream
     void SetReportInterval(double Interval);     // 
     void SetUpdateMode(SCBoolean Async);         // Asynchrone oder synchrone Updates
+    void SetPipelineMode(SCNatural QueueSize);   // Auswertung in eigenem Thread (0: aus)
+    void Dispatch(const PEEvent & Event);        // Ereignis an Sensoren verteilen
+    void SetRecordMode(const char * TraceFile);  // Ereignisse aufzeichnen (NULL: aus)
+    void Replay(const char * TraceFile,          // Aufzeichnung auswerten,
+                int Threads = 1);                // Sensoren auf Threads verteilt
+    void Inject(const PEEvent & Event);          // Ereignis wie von der SCL einspeisen
+    void SetInstrumentMode(SCBoolean On,         // Eigenaufwand messen,
+                           const char * DumpFile = NULL); // zusaetzlich Datei
+    void SetSeriesMode(const char * SeriesFile); // Anzeigewerte speichern (NULL: aus)
+    void AddSeriesColumn(const PESensor * Sensor,// Spalte der Zeitreihendatei
+                         int ValIndex, const char * Name);
+    void SetMetricsMode(const char * SocketPath); // Werte am Socket (NULL: aus)
+    void SetPlotMode(const char * Prefix,         // Displays als Bilder
+                     int Format = PVPlotImage::defaultFormat, // (NULL: aus)
+                     int Width = 640, int Height = 400);
 
     // Von SCTrace geerbte Ereignisfunktionen
     // --------------------------------------
@@ -149,9 +250,12 @@ class PEEventDispatcher: public SCTrace
                           const SCDuration            awakeDelay = kSCNoAwakeDelay);
 
   private:
+#ifndef _PEV_HEADLESS
     PVXEventDispatcher  xEventDispatcher;
+#endif
     SCList<PESensor>    registeredSensors;
-    SCList<PESensor>    activateOnAction[scTraceMax];
+    PERouter            router;   // Sensoren je Aktion und Prozesstyp/Maschine
+    SCNatural           traceMask;    // von den Sensoren benoetigte Aktionen
     SCList<PCUpdater>   registeredUpdaters;
     const char *        specification;
     char                experiment[80];
@@ -159,13 +263,38 @@ class PEEventDispatcher: public SCTrace
     clock_t             lastUpdateClock;
     const long          sleepUSecs;
     SCBoolean           asyncUpdate;
-    SCStream *          report;
+    PEReportWriter *    report;
     SCDuration          reportInterval;
     SCTime              lastReport;
+    PEEventQueue *      queue;      // != NULL: Pipeline-Modus
+    pthread_t           evaluator;  // Auswertungsthread im Pipeline-Modus
+    PETraceWriter *     recorder;   // != NULL: Ereignisse aufzeichnen
+    PEInstrument *      instrument; // != NULL: Eigenaufwand messen
+    PESeriesWriter *    series;     // != NULL: Anzeigewerte speichern
+    PEMetricsExporter * metrics;    // != NULL: Werte am Socket anbieten
+    PVPlotter *         plots;      // != NULL: Displays als Bilder ausgeben
+    unsigned long long  numEvents;  // verteilte Ereignisse (fuer metrics)
 
     void Update(void); // Update an alle Updater senden
+    void Deliver(const PEEvent & Event) {numEvents++;
+                                         if (instrument) instrument->CountEvent(Event.action);
+                                         if (recorder) recorder->Record(Event);
+                                         if (queue) queue->Put(Event);
+                                         else Dispatch(Event);}
+    void Drain(void) {if (queue) PE_MEASURE(instrument, drain, queue->Drain());} // alle Ereignisse auswerten
+    static void * Evaluate(void * Dispatcher);    // Auswertungsthread
+    void Dispatch(const PEEvent & Event, PERouter & Router);
+    struct PEPartition;                           // Sensoren eines Wiedergabe-Threads
+    struct PEReplayFeed;                          // dekodierte Ereignisse fuer alle Threads
+    void ReplayParallel(const char * TraceFile, int Threads);
+    static void * ReplayPartition(void * Partition);
+    static SCNatural TraceFlag(SCInteger Action) {return (SCNatural)1 << Action;}
     void Setup(const char * Config, const char * SpecName);
-    void DoXEvents(void) {xEventDispatcher.DoEvents();}
+#ifndef _PEV_HEADLESS
+    void DoXEvents(void);
+#else
+    void DoXEvents(void) {}
+#endif
     void WrongSCLAction(void);
 };
 
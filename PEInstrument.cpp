@@ -0,0 +1,405 @@
+/******************************************************************************\
+ Datei : PEInstrument.cpp
+ Inhalt: Implementierung der Messung des Eigenaufwands der Leistungsbewertung
+ Status:
+\******************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "PEInstrument.h"
+#include "PEReportWriter.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+using namespace std;
+
+/******************************************************************************\
+ PEInstrument: Implementierung
+\******************************************************************************/
+
+__thread SCNatural PEInstrument::work = 0;
+
+PEInstrument::PEInstrument(const char * DumpFile) :
+  numEntries (0),
+  maxEntries (16),
+  indexSize  (64),
+  start      (Clock()),
+  dumpFile   (NULL)
+{
+  SCNatural i;
+
+  if (DumpFile)
+  {
+    dumpFile = new char[strlen(DumpFile) + 1];
+    strcpy(dumpFile, DumpFile);
+  }
+
+  for (i = 0; i < scTraceMax; i++)
+  {
+    events[i] = 0;
+  }
+  for (i = 0; i < numSections; i++)
+  {
+    sectionCalls[i] = 0;
+    sectionNanos[i] = 0;
+  }
+  entries = NewEntries(maxEntries);
+  index = new SCNatural[indexSize];
+  for (i = 0; i < indexSize; i++)
+  {
+    index[i] = 0;
+  }
+}
+
+
+PEInstrument::~PEInstrument(void)
+{
+  SCNatural i;
+
+  for (i = 0; i < numEntries; i++)
+  {
+    delete[] entries[i].name;
+  }
+  free(entries);
+  delete[] index;
+  delete[] dumpFile;
+}
+
+
+unsigned long long PEInstrument::Clock(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+
+void PEInstrument::AddSensor(const void * Sensor, const char * Name)
+{
+  Enter(Sensor, Name, true);
+}
+
+
+void PEInstrument::AddUpdater(const void * Updater, const char * Name)
+{
+  Enter(Updater, Name, false);
+}
+
+
+SCNatural PEInstrument::Hash(const void * Object) const
+{
+  unsigned long h = (unsigned long)Object;
+
+  h ^= h >> 4;
+  h *= 0x9e3779b1UL;
+
+  return (h ^ (h >> 16)) & (indexSize - 1);
+}
+
+
+PEInstrument::PEEntry * PEInstrument::NewEntries(SCNatural Count)
+{
+  void * memory;
+
+  if (posix_memalign(&memory, cacheLine, Count * sizeof(PEEntry)))
+  {
+    std::cerr << "Cannot allocate instrumentation entries!\n";
+    abort();
+  }
+  return (PEEntry *)memory;
+}
+
+
+PEInstrument::PEEntry * PEInstrument::Lookup(const void * Object) const
+{
+  SCNatural i;
+
+  for (i = Hash(Object); index[i]; i = (i + 1) & (indexSize - 1))
+  {
+    if (entries[index[i] - 1].object == Object)
+    {
+      return &entries[index[i] - 1];
+    }
+  }
+  return NULL;
+}
+
+
+void PEInstrument::Enter(const void * Object, const char * Name,
+                         SCBoolean IsSensor)
+{
+  PEEntry * entry;
+  char      buffer[32];
+  SCNatural i;
+
+  if (Lookup(Object)) return;  // schon eingetragen
+
+  if (numEntries == maxEntries)
+  {
+    entry = NewEntries(maxEntries * 2);
+    memcpy(entry, entries, numEntries * sizeof(PEEntry));
+    free(entries);
+    entries = entry;
+    maxEntries *= 2;
+  }
+  if (2 * (numEntries + 1) > indexSize)
+  {
+    Grow();
+  }
+
+  if (!Name)
+  {
+    sprintf(buffer, "%s #%lu", IsSensor ? "Sensor" : "Updater",
+            (unsigned long)numEntries + 1);
+    Name = buffer;
+  }
+  entry = &entries[numEntries];
+  entry->object = Object;
+  entry->name = new char[strlen(Name) + 1];
+  strcpy(entry->name, Name);
+  entry->isSensor = IsSensor;
+  entry->calls = entry->useful = 0;
+  entry->nanos = 0;
+  numEntries++;
+
+  for (i = Hash(Object); index[i]; i = (i + 1) & (indexSize - 1));
+  index[i] = numEntries;
+}
+
+
+void PEInstrument::Grow(void)
+{
+  SCNatural e, i;
+
+  delete[] index;
+  indexSize *= 2;
+  index = new SCNatural[indexSize];
+  for (i = 0; i < indexSize; i++)
+  {
+    index[i] = 0;
+  }
+  for (e = 0; e < numEntries; e++)
+  {
+    for (i = Hash(entries[e].object); index[i]; i = (i + 1) & (indexSize - 1));
+    index[i] = e + 1;
+  }
+}
+
+
+void PEInstrument::Add(const void * Object, unsigned long long Nanos,
+                       SCBoolean Useful)
+{
+  PEEntry * entry = Lookup(Object);
+
+  if (!entry) return;          // vor dem Einschalten angemeldet
+  entry->calls++;
+  entry->nanos += Nanos;
+  if (Useful) entry->useful++;
+}
+
+
+void PEInstrument::Add(int Section, unsigned long long Nanos)
+{
+  sectionCalls[Section]++;
+  sectionNanos[Section] += Nanos;
+}
+
+
+void PEInstrument::Report(SCStream & Out) const
+{
+  unsigned long long total = Clock() - start;
+  unsigned long long sensors = 0, updaters = 0;
+  SCNatural          i;
+  int                a;
+  ostream &          out = Out.GetStream();
+
+  out << "PEV instrumentation\n===================\n\n";
+  out.setf(ios::left, ios::adjustfield);
+  out.setf(ios::fixed, ios::floatfield);
+  out.precision(3);
+
+  out << "  Action            Events\n"
+      << "  ----------------+-----------\n";
+  for (a = 0; a < scTraceMax; a++)
+  {
+    if (events[a])
+    {
+      out << "  " << setw(16) << ActionName(a) << "  " << events[a] << "\n";
+    }
+  }
+
+  out << "\n  Sensor                          Calls       Useful      ms\n"
+      << "  ------------------------------+-----------+-----------+----------\n";
+  for (i = 0; i < numEntries; i++)
+  {
+    if (!entries[i].isSensor) continue;
+    out << "  " << setw(30) << entries[i].name << "  "
+        << setw(12) << entries[i].calls
+        << setw(12) << entries[i].useful
+        << entries[i].nanos / 1e6 << "\n";
+    sensors += entries[i].nanos;
+  }
+
+  out << "\n  Updater                         Calls                   ms\n"
+      << "  ------------------------------+-----------------------+----------\n";
+  for (i = 0; i < numEntries; i++)
+  {
+    if (entries[i].isSensor) continue;
+    out << "  " << setw(30) << entries[i].name << "  "
+        << setw(24) << entries[i].calls
+        << entries[i].nanos / 1e6 << "\n";
+    updaters += entries[i].nanos;
+  }
+
+  out << "\n  Section                         Calls                   ms\n"
+      << "  ------------------------------+-----------------------+----------\n";
+  for (a = 0; a < numSections; a++)
+  {
+    out << "  " << setw(30) << SectionName(a) << "  "
+        << setw(24) << sectionCalls[a]
+        << sectionNanos[a] / 1e6 << "\n";
+  }
+
+  out << "\n  Sensors: " << sensors / 1e6 << " ms, Updaters: "
+      << updaters / 1e6 << " ms, Elapsed: " << total / 1e6 << " ms\n\n";
+}
+
+
+// Ein Record je Wert, durchnumeriert; die Namen entsprechen den Feldern des
+// Dumps: "elapsed.ns", "action.<Name>", "sensor.<Name>.calls|useful|ns",
+// "updater.<Name>.calls|ns", "section.<Name>.calls|ns"
+void PEInstrument::Export(PEReportWriter & Out) const
+{
+  char      name[512];
+  int       index = 0;
+  SCNatural i;
+  int       a;
+
+  Out.Record(index++, Clock() - start, "elapsed.ns");
+  for (a = 0; a < scTraceMax; a++)
+  {
+    if (!events[a]) continue;
+    snprintf(name, sizeof(name), "action.%s", ActionName(a));
+    Out.Record(index++, events[a], name);
+  }
+  for (i = 0; i < numEntries; i++)
+  {
+    const char * kind = entries[i].isSensor ? "sensor" : "updater";
+
+    snprintf(name, sizeof(name), "%s.%s.calls", kind, entries[i].name);
+    Out.Record(index++, entries[i].calls, name);
+    if (entries[i].isSensor)
+    {
+      snprintf(name, sizeof(name), "%s.%s.useful", kind, entries[i].name);
+      Out.Record(index++, entries[i].useful, name);
+    }
+    snprintf(name, sizeof(name), "%s.%s.ns", kind, entries[i].name);
+    Out.Record(index++, entries[i].nanos, name);
+  }
+  for (a = 0; a < numSections; a++)
+  {
+    snprintf(name, sizeof(name), "section.%s.calls", SectionName(a));
+    Out.Record(index++, sectionCalls[a], name);
+    snprintf(name, sizeof(name), "section.%s.ns", SectionName(a));
+    Out.Record(index++, sectionNanos[a], name);
+  }
+}
+
+
+// Ein Datensatz je Zeile, Felder durch Tabulatoren getrennt:
+//   elapsed <ns>
+//   action  <name> <events>
+//   sensor  <name> <calls> <useful> <ns>
+//   updater <name> <calls> <ns>
+//   section <name> <calls> <ns>
+void PEInstrument::Dump(void) const
+{
+  FILE *    file;
+  SCNatural i;
+  int       a;
+
+  if (!dumpFile) return;
+
+  if (!(file = fopen(dumpFile, "w")))
+  {
+    std::cerr << "Cannot open instrumentation dump " << dumpFile << "!\n";
+    return;
+  }
+
+  fprintf(file, "elapsed\t%llu\n", Clock() - start);
+  for (a = 0; a < scTraceMax; a++)
+  {
+    if (events[a])
+      fprintf(file, "action\t%s\t%lu\n", ActionName(a), events[a]);
+  }
+  for (i = 0; i < numEntries; i++)
+  {
+    if (entries[i].isSensor)
+      fprintf(file, "sensor\t%s\t%lu\t%lu\t%llu\n", entries[i].name,
+              entries[i].calls, entries[i].useful, entries[i].nanos);
+    else
+      fprintf(file, "updater\t%s\t%lu\t%llu\n", entries[i].name,
+              entries[i].calls, entries[i].nanos);
+  }
+  for (a = 0; a < numSections; a++)
+  {
+    fprintf(file, "section\t%s\t%lu\t%llu\n", SectionName(a),
+            sectionCalls[a], sectionNanos[a]);
+  }
+  fclose(file);
+}
+
+
+const char * PEInstrument::ActionName(int Action)
+{
+  switch (Action)
+  {
+    case scTraceSchedulerInit:    return "SchedulerInit";
+    case scTraceSchedulerStop:    return "SchedulerStop";
+    case scTraceTimeChange:       return "TimeChange";
+    case scTraceProcessCreate:    return "ProcessCreate";
+    case scTraceProcessStop:      return "ProcessStop";
+    case scTraceMachineCreate:    return "MachineCreate";
+    case scTraceMachineStop:      return "MachineStop";
+    case scTraceStateChange:      return "StateChange";
+    case scTraceSignalSend:       return "SignalSend";
+    case scTraceSignalReceive:    return "SignalReceive";
+    case scTraceSignalConsume:    return "SignalConsume";
+    case scTraceSignalSave:       return "SignalSave";
+    case scTraceSignalDrop:       return "SignalDrop";
+    case scTraceSignalLose:       return "SignalLose";
+    case scTraceSpontTrans:       return "SpontTrans";
+    case scTraceContSignal:       return "ContSignal";
+    case scTraceServiceRequest:   return "ServiceRequest";
+    case scTraceServiceFinish:    return "ServiceFinish";
+    case scTraceServiceStart:     return "ServiceStart";
+    case scTraceServiceInterrupt: return "ServiceInterrupt";
+    case scTraceTimerSet:         return "TimerSet";
+    case scTraceTimerReset:       return "TimerReset";
+    case scTraceTimerFire:        return "TimerFire";
+    case scTraceTimerRemove:      return "TimerRemove";
+    default:                      return "Other";
+  }
+}
+
+
+const char * PEInstrument::SectionName(int Section)
+{
+  switch (Section)
+  {
+    case xEvents:        return "DoXEvents";
+    case updateDisplays: return "UpdateDisplays";
+    case drain:          return "Drain";
+    case syncSleep:      return "SyncSleep";
+    default:             return "Other";
+  }
+}
@@ -0,0 +1,141 @@
+/******************************************************************************\
+ Datei : PEInstrument.h
+ Inhalt: Deklaration der Messung des Eigenaufwands der Leistungsbewertung
+         (PEInstrument, PEProbe)
+ Status:
+\******************************************************************************/
+
+#ifndef __PEINSTRUMENT_H
+#define __PEINSTRUMENT_H
+
+#include <SCL/SCBasicTypes.h>
+#include <SCL/SCStream.h>
+#include <SCL/SCTraceTypes.h>
+
+class PEReportWriter;
+
+/******************************************************************************\
+ PEInstrument: Zaehler fuer den Aufwand, den PEV selbst verursacht. Erfasst
+   werden die Ereignisse je Trace-Aktion, fuer jeden Sensor die Aufrufe seiner
+   Ereignisfunktionen, davon die Aufrufe, die seine Daten veraendert haben
+   (PE_WORK), und die darin verbrachte Zeit, fuer jeden Updater Aufrufe und
+   Zeit sowie die Zeit in DoXEvents, UpdateDisplays, beim Warten auf den
+   Auswertungsthread und im Sleep des synchronen Update-Modus.
+     Sensoren und Updater werden beim Anmelden eingetragen; waehrend der
+   Auswertung wird die Tabelle nur gelesen. Jeder Eintrag wird nur von dem
+   Thread geschrieben, der den Sensor auswertet. Die Werte sind kumuliert
+   (ResetAllSensors setzt sie nicht zurueck).
+     Gemessen wird nur, wenn mit _PEV_INSTRUMENT uebersetzt wurde; sonst sind
+   NOTIFY, PE_MEASURE und PE_WORK einfache Aufrufe ohne Zusatzaufwand.
+\******************************************************************************/
+
+class PEInstrument
+{
+  public:
+    enum                        // Abschnitte ausserhalb der Sensoren
+    {
+      xEvents,                  // DoXEvents
+      updateDisplays,           // UpdateDisplays (Neuzeichnen)
+      drain,                    // Warten auf den Auswertungsthread
+      syncSleep,                // Sleep im synchronen Update-Modus
+      numSections
+    };
+
+    PEInstrument(const char * DumpFile = NULL);
+    ~PEInstrument(void);
+
+    void AddSensor(const void * Sensor, const char * Name);
+    void AddUpdater(const void * Updater, const char * Name);
+
+    void CountEvent(SCTraceAction Action) { events[Action]++; }
+    void Add(const void * Object, unsigned long long Nanos, SCBoolean Useful);
+    void Add(int Section, unsigned long long Nanos);
+
+    void Report(SCStream & Out) const;   // Abschnitt fuer ReportAllSensors
+    void Export(PEReportWriter & Out) const; // dieselben Werte als Records
+    void Dump(void) const;               // strukturiert in die Dump-Datei
+
+    static unsigned long long Clock(void); // Nanosekunden (monoton)
+    static __thread SCNatural work;        // Zaehler fuer PE_WORK
+
+  private:
+    // Bei der parallelen Wiedergabe zaehlen mehrere Threads in benachbarte
+    // Eintraege; jeder Eintrag belegt daher eigene Cache-Zeilen
+    enum {cacheLine = 64};
+    struct PEEntryData
+    {
+      const void *       object;
+      char *             name;
+      SCBoolean          isSensor;
+      unsigned long      calls;
+      unsigned long      useful;
+      unsigned long long nanos;
+    };
+    struct PEEntry: PEEntryData
+    {
+      char padding[cacheLine - sizeof(PEEntryData) % cacheLine];
+    };
+
+    unsigned long      events[scTraceMax];
+    unsigned long      sectionCalls[numSections];
+    unsigned long long sectionNanos[numSections];
+    PEEntry *          entries;       // in Anmeldereihenfolge
+    SCNatural          numEntries;
+    SCNatural          maxEntries;
+    SCNatural *        index;         // Hashtabelle: Eintrag + 1, 0 = frei
+    SCNatural          indexSize;     // immer Zweierpotenz
+    unsigned long long start;
+    char *             dumpFile;
+
+    void           Enter(const void * Object, const char * Name,
+                         SCBoolean IsSensor);
+    PEEntry *      Lookup(const void * Object) const;
+    SCNatural      Hash(const void * Object) const;
+    void           Grow(void);
+    static PEEntry *    NewEntries(SCNatural Count); // an Cache-Zeilen ausgerichtet
+    static const char * ActionName(int Action);
+    static const char * SectionName(int Section);
+};
+
+/******************************************************************************\
+ PEProbe: Misst die Zeit zwischen Konstruktion und Destruktion und ordnet sie
+   einem Sensor, Updater oder Abschnitt zu. Ohne PEInstrument (NULL) wird
+   nichts gemessen.
+\******************************************************************************/
+
+class PEProbe
+{
+  public:
+    PEProbe(PEInstrument * Instrument, const void * Object) :
+      instrument(Instrument), object(Object), section(-1)
+      { if (instrument) {work = PEInstrument::work; begin = PEInstrument::Clock();} }
+    PEProbe(PEInstrument * Instrument, int Section) :
+      instrument(Instrument), object(NULL), section(Section)
+      { if (instrument) begin = PEInstrument::Clock(); }
+    ~PEProbe(void)
+      { if (!instrument) return;
+        if (section < 0) instrument->Add(object, PEInstrument::Clock() - begin,
+                                         PEInstrument::work != work);
+        else instrument->Add(section, PEInstrument::Clock() - begin); }
+
+  private:
+    PEInstrument *     instrument;
+    const void *       object;
+    int                section;
+    SCNatural          work;
+    unsigned long long begin;
+};
+
+#ifdef _PEV_INSTRUMENT
+#define NOTIFY(Sensor, Call) \
+  { PEProbe probe(instrument, Sensor); (Sensor)->Call; }
+#define PE_MEASURE(Instrument, Section, Statement) \
+  { PEProbe probe(Instrument, (int)PEInstrument::Section); Statement; }
+#define PE_WORK() (PEInstrument::work++)
+#else
+#define NOTIFY(Sensor, Call) (Sensor)->Call
+#define PE_MEASURE(Instrument, Section, Statement) { Statement; }
+#define PE_WORK()
+#endif
+
+#endif
@@ -0,0 +1,326 @@
+/******************************************************************************\
+ Datei : PEMetrics.cpp
+ Inhalt: Implementierung der Ausgabe aktueller Sensorwerte ueber einen
+         Unix-Socket im OpenMetrics-Textformat
+ Status:
+\******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <iostream>
+
+#include "PEMetrics.h"
+#include "PEInstrument.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+/******************************************************************************\
+ PEMetricsText: Formatiert einen Schnappschuss als OpenMetrics-Text
+\******************************************************************************/
+
+class PEMetricsText: public PEReportWriter
+{
+  public:
+    PEMetricsText(void) : data(NULL), used(0), size(0) {}
+    ~PEMetricsText(void) { free(data); }
+
+    void EndReport(void) {}
+    void Record(int ValIndex, double Value, const char * Name = NULL);
+
+    void Clear(void) { used = 0; }
+    void Put(const char * String, SCNatural Length);
+    void Put(const char * String) { Put(String, strlen(String)); }
+    void PutLabel(const char * Value);
+    void PutNumber(double Value);
+    void PutMetric(const char * Type, const char * Name, double Value);
+
+    const char * Data(void) const   { return data; }
+    SCNatural    Length(void) const { return used; }
+
+  private:
+    char *    data;
+    SCNatural used;
+    SCNatural size;
+};
+
+
+void PEMetricsText::Put(const char * String, SCNatural Length)
+{
+  if (used + Length > size)
+  {
+    do size = size ? 2 * size : 65536;
+    while (used + Length > size);
+    data = (char *)realloc(data, size);
+  }
+  memcpy(data + used, String, Length);
+  used += Length;
+}
+
+
+void PEMetricsText::PutLabel(const char * Value)
+{
+  const char * cur;
+
+  for (cur = Value; *cur; cur++)
+  {
+    switch (*cur)
+    {
+      case '\\': Put("\\\\", 2); break;
+      case '"':  Put("\\\"", 2); break;
+      case '\n': Put("\\n", 2); break;
+      default:   Put(cur, 1);
+    }
+  }
+}
+
+
+void PEMetricsText::PutNumber(double Value)
+{
+  char number[32];
+
+  if (isnan(Value))
+    Put("NaN");
+  else if (isinf(Value))
+    Put(Value > 0 ? "+Inf" : "-Inf");
+  else
+    Put(number, sprintf(number, "%.17g", Value));
+}
+
+
+void PEMetricsText::Record(int ValIndex, double Value, const char * Name)
+{
+  char number[48];
+
+  Put("pev_sensor{experiment=\"");
+  PutLabel(experiment);
+  Put("\",sensor=\"");
+  PutLabel(sensorName);
+  Put(number, sprintf(number, "\",index=\"%d\",name=\"", ValIndex));
+  PutLabel(IndexName(ValIndex, Name));
+  Put("\"} ");
+  PutNumber(Value);
+  Put("\n", 1);
+}
+
+
+void PEMetricsText::PutMetric(const char * Type, const char * Name,
+                              double Value)
+{
+  Put("# TYPE ");
+  Put(Name);
+  Put(" ");
+  Put(Type);
+  Put("\n");
+  Put(Name);
+  if (!strcmp(Type, "counter")) Put("_total");
+  Put(" ");
+  PutNumber(Value);
+  Put("\n", 1);
+}
+
+/******************************************************************************\
+ PEMetricsExporter: Implementierung
+\******************************************************************************/
+
+PEMetricsExporter::PEMetricsExporter(const char * SocketPath) :
+  listener    (-1),
+  fresh       (false),
+  stop        (false),
+  start       (0),
+  lastPublish (0),
+  lastEvents  (0),
+  startTime   (0.0)
+{
+  struct sockaddr_un address;
+  SCNatural          i;
+
+  socketPath = new char[strlen(SocketPath) + 1];
+  strcpy(socketPath, SocketPath);
+
+  for (i = 0; i < 3; i++)
+  {
+    memset(&slots[i].health, 0, sizeof(PEHealth));
+  }
+  filling = &slots[0];
+  ready = &slots[1];
+  serving = &slots[2];
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(SocketPath) >= sizeof(address.sun_path))
+  {
+    std::cerr << "Metrics socket path " << SocketPath << " too long!\n";
+    abort();
+  }
+  strcpy(address.sun_path, SocketPath);
+  unlink(SocketPath);          // von einem frueheren Lauf
+
+  if ((listener = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+      bind(listener, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+      listen(listener, 8) < 0)
+  {
+    std::cerr << "Cannot open metrics socket " << SocketPath << "!\n";
+    abort();
+  }
+
+  pthread_mutex_init(&lock, NULL);
+  if (pthread_create(&server, NULL, Run, this))
+  {
+    std::cerr << "Cannot create metrics thread!\n";
+    abort();
+  }
+}
+
+
+PEMetricsExporter::~PEMetricsExporter(void)
+{
+  pthread_mutex_lock(&lock);
+  stop = true;
+  pthread_mutex_unlock(&lock);
+  pthread_join(server, NULL);   // wacht spaetestens nach einem poll auf
+  pthread_mutex_destroy(&lock);
+
+  close(listener);
+  unlink(socketPath);
+  delete[] socketPath;
+}
+
+
+void PEMetricsExporter::Publish(SCList<PESensor> & Sensors,
+                                const char *       Experiment,
+                                SCTime             Now,
+                                unsigned long long Events)
+{
+  unsigned long long   now = PEInstrument::Clock();
+  PESensor *           sensor;
+  SCListIter<PESensor> iter(Sensors);
+  PESlot *             slot;
+
+  if (lastPublish && now - lastPublish < publishNanos) return;
+
+  if (!lastPublish)
+  {
+    start = now;
+    startTime = Now;
+  }
+
+  filling->snapshot.BeginReport(Experiment, Now);
+  for (sensor = iter++;
+       sensor;
+       sensor = iter++)
+  {
+    filling->snapshot.WriteSensor(*sensor);
+  }
+  filling->snapshot.EndReport();
+
+  filling->health.simTime = Now;
+  filling->health.events = Events;
+  filling->health.wallTime = (now - start) / 1e9;
+  filling->health.wallSimRatio = Now > startTime ?
+                                 filling->health.wallTime / (Now - startTime) : 0.0;
+  filling->health.eventRate = lastPublish ?
+                              (Events - lastEvents) / ((now - lastPublish) / 1e9) : 0.0;
+  lastPublish = now;
+  lastEvents = Events;
+
+  pthread_mutex_lock(&lock);
+  slot = ready;
+  ready = filling;
+  filling = slot;
+  fresh = true;
+  pthread_mutex_unlock(&lock);
+}
+
+
+void PEMetricsExporter::Serve(int Connection)
+{
+  static const char * httpHeader =
+    "HTTP/1.0 200 OK\r\n"
+    "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+    "Content-Length: %lu\r\n\r\n";
+  PEMetricsText   text;
+  PESlot *        slot;
+  struct pollfd   request;
+  struct timeval  timeout;
+  char            buffer[512];
+  ssize_t         length = 0;
+  SCNatural       done;
+
+  pthread_mutex_lock(&lock);
+  if (fresh)
+  {
+    slot = serving;
+    serving = ready;
+    ready = slot;
+    fresh = false;
+  }
+  pthread_mutex_unlock(&lock);
+
+  text.Put("# TYPE pev_sensor gauge\n"
+           "# HELP pev_sensor Current value of a sensor value index.\n");
+  serving->snapshot.Replay(text);
+  text.PutMetric("counter", "pev_events", serving->health.events);
+  text.PutMetric("gauge", "pev_event_rate", serving->health.eventRate);
+  text.PutMetric("gauge", "pev_sim_time", serving->health.simTime);
+  text.PutMetric("gauge", "pev_wall_time_seconds", serving->health.wallTime);
+  text.PutMetric("gauge", "pev_wall_sim_ratio", serving->health.wallSimRatio);
+  text.Put("# EOF\n");
+
+  // Eine Anfrage wird nicht verlangt (z.B. nc -U); HTTP nur nach "GET "
+  request.fd = Connection;
+  request.events = POLLIN;
+  if (poll(&request, 1, 100) > 0)
+  {
+    length = recv(Connection, buffer, sizeof(buffer), MSG_DONTWAIT);
+  }
+
+  timeout.tv_sec = 1;           // haengende Leser nicht ewig bedienen
+  timeout.tv_usec = 0;
+  setsockopt(Connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  if (length >= 4 && !strncmp(buffer, "GET ", 4))
+  {
+    length = sprintf(buffer, httpHeader, (unsigned long)text.Length());
+    if (send(Connection, buffer, length, MSG_NOSIGNAL) != length) return;
+  }
+  for (done = 0; done < text.Length(); done += length)
+  {
+    length = send(Connection, text.Data() + done, text.Length() - done,
+                  MSG_NOSIGNAL);
+    if (length <= 0) return;
+  }
+}
+
+
+void * PEMetricsExporter::Run(void * Exporter)
+{
+  PEMetricsExporter * self = (PEMetricsExporter *)Exporter;
+  struct pollfd       incoming;
+  int                 connection;
+  SCBoolean           stop;
+
+  incoming.fd = self->listener;
+  incoming.events = POLLIN;
+  for (;;)
+  {
+    pthread_mutex_lock(&self->lock);
+    stop = self->stop;
+    pthread_mutex_unlock(&self->lock);
+    if (stop) break;
+
+    if (poll(&incoming, 1, 200) <= 0) continue;
+    if ((connection = accept(self->listener, NULL, NULL)) < 0) continue;
+    self->Serve(connection);
+    close(connection);
+  }
+  return NULL;
+}
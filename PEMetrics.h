@@ -0,0 +1,83 @@
+/******************************************************************************\
+ Datei : PEMetrics.h
+ Inhalt: Deklaration der Ausgabe aktueller Sensorwerte ueber einen Unix-
+         Socket im OpenMetrics-Textformat (PEMetricsExporter)
+ Status:
+\******************************************************************************/
+
+#ifndef __PEMETRICS_H
+#define __PEMETRICS_H
+
+#include <pthread.h>
+
+#include <SCL/SCBasicTypes.h>
+#include <SCL/SCList.h>
+
+#ifndef __PESENSOR_H
+#include "PESensor.h"
+#endif
+#ifndef __PEREPORTWRITER_H
+#include "PEReportWriter.h"
+#endif
+
+/******************************************************************************\
+ PEMetricsExporter: Jede Verbindung zum Unix-Socket erhaelt die Werte aller
+   Sensoren (je Wertindex, siehe PESensor::Export) und einige Kennzahlen
+   des Dispatchers (Ereignisse, Ereignisse/s, Simulationszeit, Verhaeltnis
+   von Real- zu Simulationszeit) im OpenMetrics-Textformat. Beginnt die
+   Anfrage mit "GET ", wird ein HTTP-Kopf vorangestellt (curl --unix-socket).
+     Publish wird vom Simulator beim Update aufgerufen und haelt hoechstens
+   alle publishInterval Sekunden einen PEReportSnapshot fest. Die Anfragen
+   beantwortet ein eigener Thread aus dem zuletzt veroeffentlichten
+   Schnappschuss. Es gibt drei Schnappschuesse (fuellen, bereit, in
+   Auslieferung), die unter einer Sperre nur vertauscht werden; der
+   Simulator wartet also nie auf eine Anfrage.
+\******************************************************************************/
+
+class PEMetricsExporter
+{
+  public:
+    PEMetricsExporter(const char * SocketPath);
+    ~PEMetricsExporter(void);
+
+    void Publish(SCList<PESensor> & Sensors, const char * Experiment,
+                 SCTime Now, unsigned long long Events);
+
+  private:
+    struct PEHealth                 // Kennzahlen des Dispatchers
+    {
+      SCTime             simTime;
+      unsigned long long events;
+      double             wallTime;  // Sekunden seit dem ersten Publish
+      double             eventRate; // Ereignisse/s seit dem letzten Publish
+      double             wallSimRatio; // Realzeit je Simulationszeiteinheit
+    };
+
+    struct PESlot
+    {
+      PEReportSnapshot snapshot;
+      PEHealth         health;
+    };
+
+    enum { publishNanos = 100000000 }; // hoechstens 10 Schnappschuesse/s
+
+    char *             socketPath;
+    int                listener;
+    PESlot             slots[3];
+    PESlot *           filling;     // nur Simulator
+    PESlot *           ready;       // zuletzt veroeffentlicht
+    PESlot *           serving;     // nur Ausgabethread
+    SCBoolean          fresh;       // ready neuer als serving
+    SCBoolean          stop;
+    unsigned long long start;       // ns, erstes Publish
+    unsigned long long lastPublish; // ns
+    unsigned long long lastEvents;
+    SCTime             startTime;   // Simulationszeit beim ersten Publish
+    pthread_mutex_t    lock;
+    pthread_t          server;
+
+    void         Serve(int Connection);
+    static void * Run(void * Exporter);  // Ausgabethread
+};
+
+#endif
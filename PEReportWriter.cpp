@@ -0,0 +1,675 @@
+/******************************************************************************\
+ Datei : PEReportWriter.cpp
+ Inhalt: Implementierung der Ausgabeformate der Reports
+ Status:
+\******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+
+#include "PEReportWriter.h"
+#include "PESensor.h"
+#include "PEInstrument.h"
+#include "PESetup.h"
+#include "PEScanner.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+/******************************************************************************\
+ PEReportWriter: Implementierung
+\******************************************************************************/
+
+PEReportWriter::PEReportWriter(void) :
+  experiment (""),
+  time       (0.0),
+  sensorName ("")
+{
+}
+
+
+PEReportWriter * PEReportWriter::Create(const char * FileName, int Format,
+                                        SCNatural QueueSize)
+{
+  PEReportWriter * writer;
+  SCBoolean        isText = false;
+
+  switch (Format)
+  {
+    case csv:       writer = new PECSVReportWriter(FileName); break;
+    case jsonLines: writer = new PEJSONReportWriter(FileName); break;
+    case binary:    writer = new PEBinaryReportWriter(FileName); break;
+    default:        writer = new PETextReportWriter(FileName);
+                    isText = true;
+  }
+  if (QueueSize)
+  {
+    writer = new PEAsyncReportWriter(writer, QueueSize, isText);
+  }
+  return writer;
+}
+
+
+void PEReportWriter::BeginReport(const char * Experiment, SCTime Time)
+{
+  experiment = Experiment;
+  time = Time;
+}
+
+
+void PEReportWriter::WriteSensor(const PESensor & Sensor)
+{
+  BeginSensor(Sensor.GetName());
+  Sensor.Export(*this);
+}
+
+
+const char PEReportWriter::instrumentName[] = "pev.instrument";
+
+void PEReportWriter::WriteInstrument(const PEInstrument & Instrument)
+{
+  BeginSensor(instrumentName);
+  Instrument.Export(*this);
+}
+
+
+const char * PEReportWriter::IndexName(int ValIndex, const char * Name)
+{
+  if (Name) return Name;
+  if (ValIndex >= 0 && ValIndex < numValIndexTypes)
+    return ValIndexTypeName(ValIndex);
+  return "";
+}
+
+/******************************************************************************\
+ PETextReportWriter: Implementierung
+\******************************************************************************/
+
+PETextReportWriter::PETextReportWriter(const char * FileName)
+{
+  out = new SCStream(FileName);
+}
+
+
+PETextReportWriter::PETextReportWriter(std::ostream & Out)
+{
+  out = new SCStream(Out);
+}
+
+
+PETextReportWriter::~PETextReportWriter(void)
+{
+  delete out;
+}
+
+
+void PETextReportWriter::BeginReport(const char * Experiment, SCTime Time)
+{
+  PEReportWriter::BeginReport(Experiment, Time);
+
+  (*out) << std::endl << "PEV-Report for experiment '" << Experiment << "' at ";
+  (*out) << Time;
+  (*out) << ":\n==========\n\n";
+}
+
+
+void PETextReportWriter::WriteSensor(const PESensor & Sensor)
+{
+  Sensor.Report(*out);
+}
+
+
+void PETextReportWriter::WriteInstrument(const PEInstrument & Instrument)
+{
+  Instrument.Report(*out);
+}
+
+
+void PETextReportWriter::EndReport(void)
+{
+  (*out) << "<<< End of report >>>\n\n";
+}
+
+
+void PETextReportWriter::Flush(void)
+{
+  out->GetStream().flush();
+}
+
+
+void PETextReportWriter::WriteText(const char * Text, SCNatural Length)
+{
+  out->GetStream().write(Text, Length);
+}
+
+/******************************************************************************\
+ PEBufferedReportWriter: Implementierung
+\******************************************************************************/
+
+PEBufferedReportWriter::PEBufferedReportWriter(const char * FileName) :
+  used (0)
+{
+  fileName = new char[strlen(FileName) + 1];
+  strcpy(fileName, FileName);
+  if ((fd = open(FileName, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+  {
+    std::cerr << "Cannot open report file " << FileName << "!\n";
+    abort();
+  }
+  buffer = new char[bufferSize];
+}
+
+
+PEBufferedReportWriter::~PEBufferedReportWriter(void)
+{
+  Flush();
+  close(fd);
+  delete[] buffer;
+  delete[] fileName;
+}
+
+
+void PEBufferedReportWriter::Flush(void)
+{
+  WriteAll(buffer, used);
+  used = 0;
+}
+
+
+// Was groesser als der ganze Puffer ist, geht direkt in die Datei
+void PEBufferedReportWriter::PutLarge(const void * Data, SCNatural Length)
+{
+  Flush();
+  if (Length > bufferSize)
+  {
+    WriteAll((const char *)Data, Length);
+    return;
+  }
+  memcpy(buffer, Data, Length);
+  used = Length;
+}
+
+
+void PEBufferedReportWriter::WriteAll(const char * Data, SCNatural Length)
+{
+  SCNatural done = 0;
+  ssize_t   written;
+
+  while (done < Length)
+  {
+    if ((written = write(fd, Data + done, Length - done)) < 0)
+    {
+      std::cerr << "Cannot write report file " << fileName << "!\n";
+      abort();
+    }
+    done += written;
+  }
+}
+
+
+void PEBufferedReportWriter::PutNumber(double Value)
+{
+  char number[32];
+
+  if (isnan(Value))
+    Put("nan");
+  else if (isinf(Value))
+    Put(Value > 0 ? "inf" : "-inf");
+  else
+    Put(number, sprintf(number, "%.17g", Value));
+}
+
+/******************************************************************************\
+ PECSVReportWriter: Implementierung
+\******************************************************************************/
+
+PECSVReportWriter::PECSVReportWriter(const char * FileName) :
+  PEBufferedReportWriter(FileName)
+{
+  Put("experiment,time,sensor,index,name,value\n");
+}
+
+
+void PECSVReportWriter::PutField(const char * String)
+{
+  const char * cur;
+
+  if (!strpbrk(String, ",\"\r\n"))
+  {
+    Put(String);
+    return;
+  }
+  Put("\"", 1);
+  for (cur = String; *cur; cur++)
+  {
+    if (*cur == '"') Put("\"", 1);  // verdoppeln
+    Put(cur, 1);
+  }
+  Put("\"", 1);
+}
+
+
+void PECSVReportWriter::Record(int ValIndex, double Value, const char * Name)
+{
+  char number[48];
+
+  PutField(experiment);
+  Put(",", 1);
+  PutNumber(time);
+  Put(",", 1);
+  PutField(sensorName);
+  Put(number, sprintf(number, ",%d,", ValIndex));
+  PutField(IndexName(ValIndex, Name));
+  Put(",", 1);
+  PutNumber(Value);
+  Put("\n", 1);
+}
+
+/******************************************************************************\
+ PEJSONReportWriter: Implementierung
+\******************************************************************************/
+
+PEJSONReportWriter::PEJSONReportWriter(const char * FileName) :
+  PEBufferedReportWriter(FileName)
+{
+}
+
+
+void PEJSONReportWriter::PutString(const char * String)
+{
+  const char * cur;
+  char         escape[8];
+
+  Put("\"", 1);
+  for (cur = String; *cur; cur++)
+  {
+    if (*cur == '"' || *cur == '\\')
+    {
+      Put("\\", 1);
+      Put(cur, 1);
+    }
+    else if ((unsigned char)*cur < 0x20)
+    {
+      Put(escape, sprintf(escape, "\\u%04x", *cur));
+    }
+    else
+    {
+      Put(cur, 1);
+    }
+  }
+  Put("\"", 1);
+}
+
+
+void PEJSONReportWriter::Record(int ValIndex, double Value, const char * Name)
+{
+  char number[48];
+
+  Put("{\"experiment\":");
+  PutString(experiment);
+  Put(",\"time\":");
+  PutNumber(time);
+  Put(",\"sensor\":");
+  PutString(sensorName);
+  Put(number, sprintf(number, ",\"index\":%d", ValIndex));
+  Put(",\"name\":");
+  PutString(IndexName(ValIndex, Name));
+  Put(",\"value\":");
+  if (isfinite(Value))
+    PutNumber(Value);
+  else
+    Put("null");
+  Put("}\n", 2);
+}
+
+/******************************************************************************\
+ PEBinaryReportWriter: Implementierung
+\******************************************************************************/
+
+const char PEBinaryReportWriter::magic[8] = {'P', 'E', 'V', 'R', 'E', 'P', 'R', 'T'};
+
+PEBinaryReportWriter::PEBinaryReportWriter(const char * FileName) :
+  PEBufferedReportWriter(FileName)
+{
+  char v = version;
+
+  Put(magic, sizeof(magic));
+  Put(&v, 1);
+}
+
+
+void PEBinaryReportWriter::PutString(const char * String)
+{
+  SCNatural      length = strlen(String);
+  unsigned short len = length > 0xffff ? 0xffff : length;
+
+  Put(&len, sizeof(len));
+  Put(String, len);
+}
+
+
+void PEBinaryReportWriter::BeginReport(const char * Experiment, SCTime Time)
+{
+  PEReportWriter::BeginReport(Experiment, Time);
+
+  Put("R", 1);
+  PutString(Experiment);
+  Put(&Time, sizeof(Time));
+}
+
+
+void PEBinaryReportWriter::BeginSensor(const char * Name)
+{
+  PEReportWriter::BeginSensor(Name);
+
+  Put("S", 1);
+  PutString(Name);
+}
+
+
+void PEBinaryReportWriter::EndReport(void)
+{
+  Put("E", 1);
+  Flush();
+}
+
+
+void PEBinaryReportWriter::Record(int ValIndex, double Value, const char * Name)
+{
+  int index = ValIndex;
+
+  Put(Name ? "N" : "V", 1);
+  Put(&index, sizeof(index));
+  Put(&Value, sizeof(Value));
+  if (Name) PutString(Name);
+}
+
+/******************************************************************************\
+ PEReportSnapshot: Implementierung
+\******************************************************************************/
+
+// Kodierung: 'R' Zeit Experiment, 'S' Name, 'V' Index Wert,
+//            'N' Index Wert Name, 'E' Ende, 'T' Laenge Text
+
+PEReportSnapshot::PEReportSnapshot(void) :
+  data (NULL),
+  used (0),
+  size (0)
+{
+}
+
+
+PEReportSnapshot::~PEReportSnapshot(void)
+{
+  free(data);
+}
+
+
+void PEReportSnapshot::Put(const void * Data, SCNatural Length)
+{
+  if (used + Length > size)
+  {
+    do size = size ? 2 * size : 4096;
+    while (used + Length > size);
+    data = (char *)realloc(data, size);
+  }
+  memcpy(data + used, Data, Length);
+  used += Length;
+}
+
+
+void PEReportSnapshot::BeginReport(const char * Experiment, SCTime Time)
+{
+  used = 0;
+  Put("R", 1);
+  Put(&Time, sizeof(Time));
+  PutString(Experiment);
+}
+
+
+void PEReportSnapshot::BeginSensor(const char * Name)
+{
+  Put("S", 1);
+  PutString(Name);
+}
+
+
+void PEReportSnapshot::EndReport(void)
+{
+  Put("E", 1);
+}
+
+
+void PEReportSnapshot::SetText(const char * Text, SCNatural Length)
+{
+  used = 0;
+  Put("T", 1);
+  Put(&Length, sizeof(Length));
+  Put(Text, Length);
+}
+
+
+void PEReportSnapshot::Record(int ValIndex, double Value, const char * Name)
+{
+  Put(Name ? "N" : "V", 1);
+  Put(&ValIndex, sizeof(ValIndex));
+  Put(&Value, sizeof(Value));
+  if (Name) PutString(Name);
+}
+
+
+void PEReportSnapshot::Replay(PEReportWriter & Target) const
+{
+  const char * cur = data;
+  const char * end = data + used;
+  const char * name;
+  SCTime       time;
+  double       value;
+  int          index;
+  SCNatural    length;
+  char         tag;
+
+  while (cur < end)
+  {
+    switch (tag = *cur++)
+    {
+      case 'R':
+        memcpy(&time, cur, sizeof(time));
+        cur += sizeof(time);
+        Target.BeginReport(cur, time);
+        cur += strlen(cur) + 1;
+        break;
+
+      case 'S':
+        Target.BeginSensor(cur);
+        cur += strlen(cur) + 1;
+        break;
+
+      case 'V':
+      case 'N':
+        memcpy(&index, cur, sizeof(index));
+        cur += sizeof(index);
+        memcpy(&value, cur, sizeof(value));
+        cur += sizeof(value);
+        name = NULL;
+        if (tag == 'N')
+        {
+          name = cur;
+          cur += strlen(cur) + 1;
+        }
+        Target.Record(index, value, name);
+        break;
+
+      case 'E':
+        Target.EndReport();
+        break;
+
+      case 'T':
+        memcpy(&length, cur, sizeof(length));
+        cur += sizeof(length);
+        Target.WriteText(cur, length);
+        cur += length;
+        break;
+
+      default:
+        assert(0);
+    }
+  }
+}
+
+/******************************************************************************\
+ PEAsyncReportWriter: Implementierung
+\******************************************************************************/
+
+PEAsyncReportWriter::PEAsyncReportWriter(PEReportWriter * Target,
+                                         SCNatural        QueueSize,
+                                         SCBoolean        Text) :
+  target    (Target),
+  numSlots  (QueueSize),
+  head      (0),
+  count     (0),
+  filling   (NULL),
+  text      (NULL),
+  formatter (NULL),
+  current   (NULL),
+  stop      (false)
+{
+  assert(numSlots > 0);
+  slots = new PEReportSnapshot[numSlots];
+  if (Text)
+  {
+    text = new std::ostringstream;
+    formatter = new PETextReportWriter(*text);
+  }
+
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&filled, NULL);
+  pthread_cond_init(&written, NULL);
+  if (pthread_create(&writer, NULL, Write, this))
+  {
+    std::cerr << "Cannot create report thread!\n";
+    abort();
+  }
+}
+
+
+PEAsyncReportWriter::~PEAsyncReportWriter(void)
+{
+  Flush();
+  pthread_mutex_lock(&lock);
+  stop = true;
+  pthread_cond_signal(&filled);
+  pthread_mutex_unlock(&lock);
+  pthread_join(writer, NULL);
+
+  pthread_cond_destroy(&written);
+  pthread_cond_destroy(&filled);
+  pthread_mutex_destroy(&lock);
+
+  delete[] slots;
+  delete formatter;
+  delete text;
+  delete target;
+}
+
+
+// Wartet bei voller Warteschlange, bis der Schreibthread einen Platz frei
+// gibt (Gegendruck auf den Simulator)
+void PEAsyncReportWriter::BeginReport(const char * Experiment, SCTime Time)
+{
+  pthread_mutex_lock(&lock);
+  while (count == numSlots)
+  {
+    pthread_cond_wait(&written, &lock);
+  }
+  filling = &slots[(head + count) % numSlots];
+  pthread_mutex_unlock(&lock);
+
+  current = formatter ? formatter : filling;
+  current->BeginReport(Experiment, Time);
+}
+
+
+void PEAsyncReportWriter::WriteSensor(const PESensor & Sensor)
+{
+  current->WriteSensor(Sensor);
+}
+
+
+void PEAsyncReportWriter::WriteInstrument(const PEInstrument & Instrument)
+{
+  current->WriteInstrument(Instrument);
+}
+
+
+void PEAsyncReportWriter::Record(int ValIndex, double Value, const char * Name)
+{
+  filling->Record(ValIndex, Value, Name);
+}
+
+
+// Der Text-Report geht als ein Text in den Schnappschuss; text behaelt
+// seinen Zustand (z.B. die Genauigkeit) fuer den naechsten Report
+void PEAsyncReportWriter::EndReport(void)
+{
+  current->EndReport();
+  if (formatter)
+  {
+    std::string Text = text->str();
+
+    filling->SetText(Text.data(), Text.length());
+    text->str("");
+  }
+
+  pthread_mutex_lock(&lock);
+  filling = NULL;
+  count++;
+  pthread_cond_signal(&filled);
+  pthread_mutex_unlock(&lock);
+}
+
+
+void PEAsyncReportWriter::Flush(void)
+{
+  pthread_mutex_lock(&lock);
+  while (count)
+  {
+    pthread_cond_wait(&written, &lock);
+  }
+  pthread_mutex_unlock(&lock);
+  target->Flush();
+}
+
+
+void * PEAsyncReportWriter::Write(void * Writer)
+{
+  PEAsyncReportWriter * self = (PEAsyncReportWriter *)Writer;
+
+  pthread_mutex_lock(&self->lock);
+  for (;;)
+  {
+    while (!self->count && !self->stop)
+    {
+      pthread_cond_wait(&self->filled, &self->lock);
+    }
+    if (!self->count) break;   // beendet und alles geschrieben
+    pthread_mutex_unlock(&self->lock);
+
+    self->slots[self->head].Replay(*self->target);
+
+    pthread_mutex_lock(&self->lock);
+    self->head = (self->head + 1) % self->numSlots;
+    self->count--;
+    pthread_cond_broadcast(&self->written);
+  }
+  pthread_mutex_unlock(&self->lock);
+
+  return NULL;
+}
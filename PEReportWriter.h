@@ -0,0 +1,290 @@
+/******************************************************************************\
+ Datei : PEReportWriter.h
+ Inhalt: Deklaration der Ausgabeformate der Reports (PEReportWriter,
+         PETextReportWriter, PECSVReportWriter, PEJSONReportWriter,
+         PEBinaryReportWriter, PEReportSnapshot, PEAsyncReportWriter)
+ Status:
+\******************************************************************************/
+
+#ifndef __PEREPORTWRITER_H
+#define __PEREPORTWRITER_H
+
+#include <string.h>
+#include <pthread.h>
+#include <sstream>
+
+#include <SCL/SCBasicTypes.h>
+#include <SCL/SCStream.h>
+
+class PESensor;
+class PEInstrument;
+
+/******************************************************************************\
+ PEReportWriter: Schnittstelle fuer die Ausgabe eines Reports. Ein Report
+   besteht aus BeginReport, WriteSensor fuer jeden Sensor, evtl.
+   WriteInstrument und EndReport. Die maschinenlesbaren Formate erhalten
+   von WriteSensor ueber PESensor::Export je Wert einen Datensatz (Record):
+   Experiment, Simulationszeit, Name des Sensors, Wertindex (wie bei
+   GetValue, bei Haeufigkeiten die Nummer des Objekts) und Wert. Die
+   Messung des Eigenaufwands (WriteInstrument) erscheint dort als Sensor
+   "pev.instrument" mit benannten Werten (siehe PEInstrument::Export).
+\******************************************************************************/
+
+class PEReportWriter
+{
+  public:
+    enum                        // Ausgabeformate
+    {
+      text,                     // Text wie bisher (Sensor::Report)
+      csv,                      // eine Zeile je Wert, durch Kommata getrennt
+      jsonLines,                // ein JSON-Objekt je Zeile und Wert
+      binary,                   // kompakt, siehe PEBinaryReportWriter
+      numFormats
+    };
+
+    // QueueSize > 0: Reports asynchron schreiben (PEAsyncReportWriter);
+    // beim Textformat wird nur das Schreiben ausgelagert, formatiert wird
+    // weiter im Simulator-Thread
+    static PEReportWriter * Create(const char * FileName, int Format,
+                                   SCNatural QueueSize = 0);
+
+    virtual ~PEReportWriter(void) {}
+
+    virtual void BeginReport(const char * Experiment, SCTime Time);
+    virtual void WriteSensor(const PESensor & Sensor); // BeginSensor, Export
+    virtual void WriteInstrument(const PEInstrument & Instrument);
+    virtual void EndReport(void) = 0;
+    virtual void Flush(void) {}  // alle Reports vollstaendig in die Datei
+
+    // Ein Wert des gerade ausgegebenen Sensors; Name: Name des Objekts bei
+    // Haeufigkeiten, NULL: Name des Wertindex (z.B. "avg")
+    virtual void Record(int ValIndex, double Value,
+                        const char * Name = NULL) = 0;
+
+  protected:
+    PEReportWriter(void);
+
+    virtual void BeginSensor(const char * Name) { sensorName = Name; }
+    virtual void WriteText(const char *, SCNatural) {} // schon formatiert
+
+    friend class PEReportSnapshot;    // gibt Schnappschuesse weiter
+
+    const char * experiment;
+    SCTime       time;
+    const char * sensorName;    // des gerade ausgegebenen Sensors
+
+    static const char * IndexName(int ValIndex, const char * Name);
+    static const char   instrumentName[];     // "pev.instrument"
+};
+
+/******************************************************************************\
+ PETextReportWriter: Der bisherige Text-Report ueber SCStream. Die Sensoren
+   formatieren sich selbst (PESensor::Report), Record wird nicht benutzt.
+   Statt in eine Datei kann auch in einen anderen Stream (z.B. Speicher)
+   formatiert werden; schon formatierter Text geht mit WriteText unveraendert
+   in die Datei.
+\******************************************************************************/
+
+class PETextReportWriter: public PEReportWriter
+{
+  public:
+    PETextReportWriter(const char * FileName);
+    PETextReportWriter(std::ostream & Out);
+    ~PETextReportWriter(void);
+
+    void BeginReport(const char * Experiment, SCTime Time);
+    void WriteSensor(const PESensor & Sensor);
+    void WriteInstrument(const PEInstrument & Instrument);
+    void EndReport(void);
+    void Flush(void);
+    void Record(int, double, const char *) {}
+
+  protected:
+    void WriteText(const char * Text, SCNatural Length);
+
+  private:
+    SCStream * out;
+};
+
+/******************************************************************************\
+ PEBufferedReportWriter: Gemeinsame Basis der maschinenlesbaren Formate.
+   Die Datensaetze werden in einem grossen Puffer gesammelt, der bei Bedarf
+   und am Ende jedes Reports mit einem write in die Datei geht.
+\******************************************************************************/
+
+class PEBufferedReportWriter: public PEReportWriter
+{
+  public:
+    ~PEBufferedReportWriter(void);
+
+    void EndReport(void) { Flush(); }
+    void Flush(void);
+
+  protected:
+    PEBufferedReportWriter(const char * FileName);
+
+    enum { bufferSize = 1 << 20 };
+
+    void Put(const void * Data, SCNatural Length)
+      { if (used + Length > bufferSize) { PutLarge(Data, Length); return; }
+        memcpy(buffer + used, Data, Length); used += Length; }
+    void Put(const char * String) { Put(String, strlen(String)); }
+    void PutNumber(double Value);   // 17 Stellen (verlustfrei), "nan", "inf"
+
+  private:
+    int       fd;
+    char *    fileName;
+    char *    buffer;
+    SCNatural used;
+
+    void PutLarge(const void * Data, SCNatural Length); // passt nicht mehr
+    void WriteAll(const char * Data, SCNatural Length);
+};
+
+/******************************************************************************\
+ PECSVReportWriter: Kopfzeile "experiment,time,sensor,index,name,value",
+   danach eine Zeile je Wert. Texte werden nur bei Bedarf in Anfuehrungs-
+   zeichen gesetzt (RFC 4180).
+\******************************************************************************/
+
+class PECSVReportWriter: public PEBufferedReportWriter
+{
+  public:
+    PECSVReportWriter(const char * FileName);
+
+    void Record(int ValIndex, double Value, const char * Name = NULL);
+
+  private:
+    void PutField(const char * String);
+};
+
+/******************************************************************************\
+ PEJSONReportWriter: Ein Objekt je Zeile und Wert mit den Schluesseln
+   experiment, time, sensor, index, name und value. Nicht endliche Werte
+   werden als null ausgegeben.
+\******************************************************************************/
+
+class PEJSONReportWriter: public PEBufferedReportWriter
+{
+  public:
+    PEJSONReportWriter(const char * FileName);
+
+    void Record(int ValIndex, double Value, const char * Name = NULL);
+
+  private:
+    void PutString(const char * String);
+};
+
+/******************************************************************************\
+ PEBinaryReportWriter: Kennung "PEVREPRT" und Version (1 Byte), danach
+   Saetze, die mit einem Kennbuchstaben beginnen (Zahlen in der Byte-
+   Reihenfolge des Rechners, Texte mit vorangestellter Laenge (2 Byte)):
+     'R' Experiment, Zeit (double)    Beginn eines Reports
+     'S' Name                         folgende Werte gehoeren zu diesem Sensor
+     'V' Wertindex (4 Byte), Wert (double)
+     'N' Wertindex (4 Byte), Wert (double), Name
+                                      Wert eines benannten Objekts (bei
+                                      Haeufigkeiten)
+     'E'                              Ende eines Reports
+\******************************************************************************/
+
+class PEBinaryReportWriter: public PEBufferedReportWriter
+{
+  public:
+    PEBinaryReportWriter(const char * FileName);
+
+    enum { version = 2 };             // 2: 'N'-Saetze
+    static const char magic[8];
+
+    void BeginReport(const char * Experiment, SCTime Time);
+    void EndReport(void);
+    void Record(int ValIndex, double Value, const char * Name = NULL);
+
+  protected:
+    void BeginSensor(const char * Name);
+
+  private:
+    void PutString(const char * String);
+};
+
+/******************************************************************************\
+ PEReportSnapshot: Haelt einen Report als kompakt kodierte Folge von Werten
+   fest (Zahlen unausgerichtet, Texte mit '\0' abgeschlossen), ohne etwas
+   zu formatieren. Replay gibt ihn spaeter, evtl. in einem anderen Thread,
+   an einen anderen PEReportWriter weiter. Der Puffer waechst nur und wird
+   bei jedem BeginReport wiederverwendet. Statt der Werte kann er auch einen
+   fertig formatierten Text festhalten (SetText), der mit WriteText
+   weitergegeben wird.
+\******************************************************************************/
+
+class PEReportSnapshot: public PEReportWriter
+{
+  public:
+    PEReportSnapshot(void);
+    ~PEReportSnapshot(void);
+
+    void BeginReport(const char * Experiment, SCTime Time);
+    void BeginSensor(const char * Name);
+    void EndReport(void);
+    void Record(int ValIndex, double Value, const char * Name = NULL);
+    void SetText(const char * Text, SCNatural Length);
+
+    void Replay(PEReportWriter & Target) const;
+
+  private:
+    char *    data;
+    SCNatural used;
+    SCNatural size;
+
+    void Put(const void * Data, SCNatural Length);
+    void PutString(const char * String) { Put(String, strlen(String) + 1); }
+};
+
+/******************************************************************************\
+ PEAsyncReportWriter: Schreibt die Reports eines anderen PEReportWriter in
+   einem eigenen Thread. Der Simulator haelt beim Report nur die Werte der
+   Sensoren in einem PEReportSnapshot fest; Formatieren und Schreiben
+   uebernimmt der Thread. Der Text-Report (Text) wird dagegen im Simulator
+   von einem eigenen PETextReportWriter in den Speicher formatiert, der
+   Thread schreibt nur den fertigen Text: Die Sensoren formatieren sich
+   selbst aus ihrem aktuellen Zustand (PESensor::Report), das geht nicht
+   spaeter in einem anderen Thread. Wer den Simulator beim Report entlasten
+   will, waehlt ein maschinenlesbares Format. Es warten hoechstens QueueSize Schnappschuesse; ist die
+   Warteschlange voll, wartet BeginReport auf einen freien Platz. Flush
+   (auch beim Loeschen) wartet, bis alle Reports geschrieben sind.
+\******************************************************************************/
+
+class PEAsyncReportWriter: public PEReportWriter
+{
+  public:
+    PEAsyncReportWriter(PEReportWriter * Target, SCNatural QueueSize,
+                        SCBoolean Text = false);
+    ~PEAsyncReportWriter(void);     // loescht auch Target
+
+    void BeginReport(const char * Experiment, SCTime Time);
+    void WriteSensor(const PESensor & Sensor);
+    void WriteInstrument(const PEInstrument & Instrument);
+    void EndReport(void);
+    void Flush(void);
+    void Record(int ValIndex, double Value, const char * Name = NULL);
+
+  private:
+    PEReportWriter *   target;
+    PEReportSnapshot * slots;
+    SCNatural          numSlots;
+    SCNatural          head;        // naechster zu schreibender Schnappschuss
+    SCNatural          count;       // gefuellte Schnappschuesse
+    PEReportSnapshot * filling;     // gerade vom Simulator gefuellt
+    std::ostringstream * text;      // Text-Report im Speicher oder NULL
+    PEReportWriter *   formatter;   // formatiert nach text
+    PEReportWriter *   current;     // formatter oder filling
+    SCBoolean          stop;
+    pthread_mutex_t    lock;
+    pthread_cond_t     filled;
+    pthread_cond_t     written;
+    pthread_t          writer;
+
+    static void * Write(void * Writer);     // Schreibthread
+};
+
+#endif
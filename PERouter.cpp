@@ -0,0 +1,247 @@
+/******************************************************************************\
+ Datei : PERouter.cpp
+ Inhalt: Implementierung des Verteilers fuer Sensor-Ereignisse
+ Status:
+\******************************************************************************/
+
+#include "PERouter.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+/******************************************************************************\
+ PERouter: Implementierung
+\******************************************************************************/
+
+PERouter::PERouter(void) :
+  tableSize     (64),
+  numRoutes     (0),
+  numUnresolved (0)
+{
+  SCNatural i;
+
+  for (i = 0; i < scTraceMax; i++)
+  {
+    broadcast[i].SetDeleteElems(false);
+    unresolved[i].SetDeleteElems(false);
+  }
+  none.SetDeleteElems(false);
+
+  table = new PERoute * [tableSize];
+  for (i = 0; i < tableSize; i++)
+  {
+    table[i] = NULL;
+  }
+}
+
+
+PERouter::~PERouter(void)
+{
+  SCNatural i;
+  PERoute * route;
+
+  for (i = 0; i < tableSize; i++)
+  {
+    while ((route = table[i]) != NULL)
+    {
+      table[i] = route->next;
+      delete route;
+    }
+  }
+  delete[] table;
+}
+
+
+void PERouter::Insert(PESensor * Sensor, SCTraceAction Action)
+{
+  const void * key = Sensor->RoutingKey(Action);
+
+  if (key == PESensor::routeAll)
+  {
+    broadcast[Action].InsertBefore(Sensor);
+  }
+  else if (key == NULL)
+  {
+    unresolved[Action].InsertBefore(Sensor);
+    numUnresolved++;
+  }
+  else
+  {
+    Enter(Sensor, Action, key);
+  }
+}
+
+
+// Wird nach Create-Ereignissen aufgerufen: Sensoren, die ihren Prozesstyp
+// bzw. ihre Maschine inzwischen gefunden haben, verlassen die Liste der
+// unaufgeloesten Sensoren.
+void PERouter::Resolve(void)
+{
+  SCNatural        i;
+  PESensor *       sensor;
+  const void *     key;
+  SCList<PESensor> resolved;
+
+  resolved.SetDeleteElems(false);
+  for (i = 0; i < scTraceMax && numUnresolved; i++)
+  {
+    SCListIter<PESensor> iter(unresolved[i]);
+
+    for (sensor = iter++;
+         sensor;
+         sensor = iter++)
+    {
+      if (sensor->RoutingKey(SCTraceAction(i)) != NULL)
+      {
+        resolved.InsertAfter(sensor);
+      }
+    }
+
+    SCListIter<PESensor> resolvedIter(resolved);
+
+    for (sensor = resolvedIter++;
+         sensor;
+         sensor = resolvedIter++)
+    {
+      key = sensor->RoutingKey(SCTraceAction(i));
+      unresolved[i].Remove(sensor);
+      numUnresolved--;
+      if (key == PESensor::routeAll)
+        broadcast[i].InsertBefore(sensor);
+      else
+        Enter(sensor, SCTraceAction(i), key);
+    }
+    resolved.RemoveAllElements();
+  }
+}
+
+
+SCNatural PERouter::Hash(SCTraceAction Action, const void * Key) const
+{
+  unsigned long h = (unsigned long)Key;
+
+  h ^= (unsigned long)Action * 0x9e3779b9UL;
+  h ^= h >> 7;
+  h *= 0x45d9f3bUL;
+  h ^= h >> 13;
+
+  return (SCNatural)(h & (tableSize - 1));
+}
+
+
+PERouter::PERoute * PERouter::Lookup(SCTraceAction Action,
+                                     const void *  Key) const
+{
+  PERoute * route;
+
+  for (route = table[Hash(Action, Key)];
+       route;
+       route = route->next)
+  {
+    if (route->key == Key && route->action == Action)
+      return route;
+  }
+  return NULL;
+}
+
+
+const SCList<PESensor> & PERouter::Keyed(SCTraceAction Action,
+                                         const void *  Key) const
+{
+  PERoute * route = Key ? Lookup(Action, Key) : NULL;
+
+  return route ? route->sensors : none;
+}
+
+
+void PERouter::Enter(PESensor *    Sensor,
+                     SCTraceAction Action,
+                     const void *  Key)
+{
+  PERoute * route = Lookup(Action, Key);
+
+  if (!route)
+  {
+    if (numRoutes >= tableSize) Grow();
+
+    SCNatural index = Hash(Action, Key);
+
+    route = new PERoute;
+    route->action = Action;
+    route->key = Key;
+    route->sensors.SetDeleteElems(false);
+    route->next = table[index];
+    table[index] = route;
+    numRoutes++;
+  }
+  route->sensors.InsertBefore(Sensor);
+}
+
+
+void PERouter::Grow(void)
+{
+  PERoute ** oldTable = table;
+  SCNatural  oldSize = tableSize;
+  SCNatural  i, index;
+  PERoute *  route;
+
+  tableSize *= 2;
+  table = new PERoute * [tableSize];
+  for (i = 0; i < tableSize; i++)
+  {
+    table[i] = NULL;
+  }
+
+  for (i = 0; i < oldSize; i++)
+  {
+    while ((route = oldTable[i]) != NULL)
+    {
+      oldTable[i] = route->next;
+      index = Hash(route->action, route->key);
+      route->next = table[index];
+      table[index] = route;
+    }
+  }
+  delete[] oldTable;
+}
+
+
+/******************************************************************************\
+ PERouterIter: Implementierung
+\******************************************************************************/
+
+PERouterIter::PERouterIter(const PERouter & Router,
+                           SCTraceAction    Action,
+                           const void *     Key) :
+  broadcastIter  (Router.broadcast[Action]),
+  unresolvedIter (Router.unresolved[Action]),
+  keyedIter      (Router.Keyed(Action, Key)),
+  phase          (0)
+{
+}
+
+
+PESensor * PERouterIter::operator++(int)
+{
+  PESensor * sensor = NULL;
+
+  switch (phase)
+  {
+    case 0:
+      if ((sensor = broadcastIter++) != NULL) break;
+      phase++;
+      // fall through
+    case 1:
+      if ((sensor = unresolvedIter++) != NULL) break;
+      phase++;
+      // fall through
+    case 2:
+      if ((sensor = keyedIter++) != NULL) break;
+      phase++;
+      // fall through
+    default:
+      break;
+  }
+  return sensor;
+}
@@ -0,0 +1,87 @@
+/******************************************************************************\
+ Datei : PERouter.h
+ Inhalt: Deklaration des Verteilers fuer Sensor-Ereignisse (PERouter) und
+         des zugehoerigen Iterators (PERouterIter)
+ Status:
+\******************************************************************************/
+
+#ifndef __PEROUTER_H
+#define __PEROUTER_H
+
+#include <SCL/SCList.h>
+#include <SCL/SCTraceTypes.h>
+
+#ifndef __PESENSOR_H
+#include "PESensor.h"
+#endif
+
+/******************************************************************************\
+ PERouter: Index der angemeldeten Sensoren nach (Aktion, Schluessel). Der
+   Schluessel eines Sensors (PESensor::RoutingKey) ist der Prozesstyp bzw. die
+   Maschine, auf die sich der Sensor bezieht. Ein Ereignis wird nur an die
+   Sensoren mit passendem Schluessel verteilt sowie an alle Sensoren, die
+   jedes Ereignis der Aktion sehen wollen (routeAll).
+     Namensgebundene Sensoren kennen ihren Schluessel erst nach dem
+   zugehoerigen Create-Ereignis. Bis dahin erhalten sie alle Ereignisse der
+   Aktion; Resolve() traegt sie anschliessend unter ihrem Schluessel ein.
+\******************************************************************************/
+
+class PERouter
+{
+  public:
+    PERouter(void);
+    ~PERouter(void);
+
+    void Insert(PESensor * Sensor, SCTraceAction Action);
+    void Resolve(void);     // aufgeloeste Sensoren unter Schluessel eintragen
+    SCBoolean HasUnresolved(void) const { return numUnresolved > 0; }
+
+  private:
+    struct PERoute          // Sensoren einer Aktion mit gleichem Schluessel
+    {
+      SCTraceAction    action;
+      const void *     key;
+      SCList<PESensor> sensors;
+      PERoute *        next;
+    };
+
+    SCList<PESensor> broadcast[scTraceMax];  // Sensoren mit routeAll
+    SCList<PESensor> unresolved[scTraceMax]; // Schluessel noch unbekannt
+    SCList<PESensor> none;                   // leere Liste fuer Iteratoren
+    PERoute **       table;                  // Hashtabelle der Schluessel
+    SCNatural        tableSize;              // immer Zweierpotenz
+    SCNatural        numRoutes;
+    SCNatural        numUnresolved;
+
+    SCNatural  Hash(SCTraceAction Action, const void * Key) const;
+    PERoute *  Lookup(SCTraceAction Action, const void * Key) const;
+    const SCList<PESensor> & Keyed(SCTraceAction Action, const void * Key) const;
+    void       Enter(PESensor * Sensor, SCTraceAction Action, const void * Key);
+    void       Grow(void);
+
+    friend class PERouterIter;
+};
+
+/******************************************************************************\
+ PERouterIter: Liefert alle Sensoren, die ein Ereignis der Aktion Action mit
+   dem Schluessel Key erhalten sollen. Key == NULL liefert nur die Sensoren,
+   die alle Ereignisse sehen wollen.
+\******************************************************************************/
+
+class PERouterIter
+{
+  public:
+    PERouterIter(const PERouter & Router,
+                 SCTraceAction    Action,
+                 const void *     Key = NULL);
+
+    PESensor * operator++(int);
+
+  private:
+    SCListIter<PESensor> broadcastIter;
+    SCListIter<PESensor> unresolvedIter;
+    SCListIter<PESensor> keyedIter;
+    int                  phase;
+};
+
+#endif
@@ -6,6 +6,8 @@
  Status: 
 \******************************************************************************/   
 
+#include <string.h>
+
 #include <SCL/SCProcess.h>
 #include <SCL/SCProcessType.h>
 #include <SCL/SCMachine.h>
@@ -18,6 +20,20 @@
   #include <dmalloc.h>
 #endif
 
+// Namen werden verglichen, nicht Zeiger: Die Namen der Ereignisse stammen aus
+// der SCL bzw. der Aufzeichnung, die des Sensors aus der Konfiguration.
+static inline SCBoolean SameName(const char * Name1, const char * Name2)
+{
+  return Name1 && Name2 && !strcmp(Name1, Name2);
+}
+
+static char * CopyName(const char * Name)
+{
+  char * copy = new char[strlen(Name) + 1];
+
+  return strcpy(copy, Name);
+}
+
 /******************************************************************************\
  PESEvent: Sensor zur Registration einfacher Events   
 \******************************************************************************/
@@ -27,13 +43,19 @@ PESEvent::PESEvent(const char *        Name,
                    SCDuration          Interval) :
   PESTally   (Interval),
   PESCounter (Interval),
-  name       (Name),
+  name       (CopyName(Name)),
   evType     (EventType),
   runnable   (NULL)
 {
   Reset();
 }
 
+
+PESEvent::~PESEvent(void)
+{
+  delete[] name;
+}
+
 SCBoolean PESEvent::NotifyOnEvent(SCTraceAction Event) const
 {
   switch (Event)
@@ -65,6 +87,13 @@ void PESEvent::Report(SCStream& Out) const
 }
 
 
+void PESEvent::Export(PEReportWriter& Out) const
+{
+  PESTally::Export(Out);
+  PESCounter::Export(Out);
+}
+
+
 double PESEvent::GetValue(int ValIndex) const
 {
   if (ValIndex < PESTally::__T) 
@@ -78,31 +107,30 @@ double PESEvent::GetValue(int ValIndex) const
 }
 
  
-void PESEvent::EvProcessCreate(const SCProcess* Process, const SCProcess*)
+void PESEvent::EvProcessCreate(const PEEvent & Event)
 {
-  if (!runnable && Process->GetType()->GetName() == evType->nameProcMach)
+  if (!runnable && SameName(Event.runnableName, evType->nameProcMach))
   {
-    runnable = Process;
+    runnable = Event.runnable;
   }
 }
 
 
-void PESEvent::EvMachineCreate(const SCMachine* Machine)
+void PESEvent::EvMachineCreate(const PEEvent & Event)
 {
-  if (!runnable && Machine->GetName() == evType->nameProcMach)
+  if (!runnable && SameName(Event.runnableName, evType->nameProcMach))
   {
-    runnable = Machine;
+    runnable = Event.runnable;
   }
 }
 
     
-void PESEvent::EvSignalReceive(const SCProcess* Process,
-                               const SCSignal* Signal)
+void PESEvent::EvSignalReceive(const PEEvent & Event)
 {
-  if ((   (evType->isArrival && (Process == runnable)) 
-       || (!evType->isArrival && (Signal->GetSender() == runnable))
+  if ((   (evType->isArrival && (Event.runnable == runnable)) 
+       || (!evType->isArrival && (Event.partner == runnable))
       )
-      && (Signal->GetSignalType()->GetName() == evType->nameSigReq)) 
+      && SameName(Event.msgName, evType->nameSigReq)) 
   {
     UpdateCounter();
     UpdateTally(Now() - lastEvent);
@@ -111,13 +139,12 @@ void PESEvent::EvSignalReceive(const SCProcess* Process,
 }
 
 
-void PESEvent::EvServiceRequest(const SCMachine* Machine,
-                                const SCRequest* Request)
+void PESEvent::EvServiceRequest(const PEEvent & Event)
 {
-  if ((   (evType->isArrival && (Machine == runnable))
-       || (!evType->isArrival && (Request->GetCaller() == runnable))
+  if ((   (evType->isArrival && (Event.runnable == runnable))
+       || (!evType->isArrival && (Event.partner == runnable))
        )	   
-     && (Request->GetRequestType()->GetName() == evType->nameSigReq)) 
+     && SameName(Event.msgName, evType->nameSigReq)) 
   {
     UpdateCounter();
     UpdateTally(Now() - lastEvent);
@@ -136,7 +163,7 @@ PESActivity::PESActivity(const char *       Name,
                          SCDuration         Interval) :
   PESTally           (Interval),
   PESCounter         (Interval),
-  name               (Name),
+  name               (CopyName(Name)),
   evStart            (Start),
   evStop             (Stop),
   runnableStart      (NULL),
@@ -146,6 +173,12 @@ PESActivity::PESActivity(const char *       Name,
   assert(Start && Stop);
 }
 
+
+PESActivity::~PESActivity(void)
+{
+  delete[] name;
+}
+
 SCBoolean PESActivity::NotifyOnEvent(SCTraceAction Event) const
 {
   switch (Event)
@@ -187,6 +220,13 @@ void PESActivity::Report(SCStream& Out) const
 }
 
 
+void PESActivity::Export(PEReportWriter& Out) const
+{
+  PESTally::Export(Out);
+  PESCounter::Export(Out);
+}
+
+
 double PESActivity::GetValue(int ValIndex) const
 {
   if (ValIndex < PESTally::__T)
@@ -200,33 +240,32 @@ double PESActivity::GetValue(int ValIndex) const
 }
 
 
-void PESActivity::EvProcessCreate(const SCProcess* Process,
-                                  const SCProcess*)
+void PESActivity::EvProcessCreate(const PEEvent & Event)
 {
   if ((evStart->isSignal || !evStart->isArrival) && !runnableStart &&
-      (Process->GetType()->GetName() == evStart->nameProcMach))
+      SameName(Event.runnableName, evStart->nameProcMach))
   {
-    runnableStart = Process;
+    runnableStart = Event.runnable;
   }
   if ((evStop->isSignal || !evStop->isArrival) && !runnableStop &&
-      (Process->GetType()->GetName() == evStop->nameProcMach))
+      SameName(Event.runnableName, evStop->nameProcMach))
   {
-    runnableStop = Process;
+    runnableStop = Event.runnable;
   }
 }
 
 
-void PESActivity::EvMachineCreate(const SCMachine* Machine)
+void PESActivity::EvMachineCreate(const PEEvent & Event)
 {
   if ((!evStart->isSignal && evStart->isArrival) && !runnableStart && 
-      (Machine->GetName() == evStart->nameProcMach))
+      SameName(Event.runnableName, evStart->nameProcMach))
   {
-    runnableStart = Machine;
+    runnableStart = Event.runnable;
   }
   if ((!evStop->isSignal && evStop->isArrival) && !runnableStop && 
-      (Machine->GetName() == evStop->nameProcMach))
+      SameName(Event.runnableName, evStop->nameProcMach))
   {
-    runnableStop = Machine;
+    runnableStop = Event.runnable;
   }
 }
 
@@ -245,16 +284,15 @@ void PESActivity::ActivityStop(void)
 }
 
 
-void PESActivity::EvServiceRequest(const SCMachine* Machine,
-                                   const SCRequest* Request)
+void PESActivity::EvServiceRequest(const PEEvent & Event)
 {
   if (activityHasStopped)
   { 
     if (   !evStart->isSignal
-	&& (   (evStart->isArrival && (Machine == runnableStart)) 
-	    || (!evStart->isArrival && (Request->GetCaller() == runnableStart))
+	&& (   (evStart->isArrival && (Event.runnable == runnableStart)) 
+	    || (!evStart->isArrival && (Event.partner == runnableStart))
 	   )	
-	&& (Request->GetRequestType()->GetName() == evStart->nameSigReq)
+	&& SameName(Event.msgName, evStart->nameSigReq)
        )
     {
       ActivityStart();
@@ -263,10 +301,10 @@ void PESActivity::EvServiceRequest(const SCMachine* Machine,
   else
   {
     if (   !evStop->isSignal 
-	&& (   (evStop->isArrival && (Machine == runnableStop)) 
-	    || (!evStop->isArrival && (Request->GetCaller() == runnableStop))
+	&& (   (evStop->isArrival && (Event.runnable == runnableStop)) 
+	    || (!evStop->isArrival && (Event.partner == runnableStop))
 	   )
-	&& (Request->GetRequestType()->GetName() == evStop->nameSigReq)
+	&& SameName(Event.msgName, evStop->nameSigReq)
        )
     {
       ActivityStop();
@@ -275,16 +313,15 @@ void PESActivity::EvServiceRequest(const SCMachine* Machine,
 }
 
 
-void PESActivity::EvSignalReceive(const SCProcess * Process,
-                                  const SCSignal *  Signal)
+void PESActivity::EvSignalReceive(const PEEvent & Event)
 {
   if (activityHasStopped)
   { 
     if (   evStart->isSignal 
-	&& (   (evStart->isArrival && (Process == runnableStart))
-            || (!evStart->isArrival && (Signal->GetSender() == runnableStart))
+	&& (   (evStart->isArrival && (Event.runnable == runnableStart))
+            || (!evStart->isArrival && (Event.partner == runnableStart))
 	   )
-        && (Signal->GetSignalType()->GetName() == evStart->nameSigReq)
+        && SameName(Event.msgName, evStart->nameSigReq)
        )
     {
       ActivityStart();
@@ -293,10 +330,10 @@ void PESActivity::EvSignalReceive(const SCProcess * Process,
   else
   {
     if (   evStop->isSignal 
-	&& (   (evStop->isArrival && (Process == runnableStop))
-            || (!evStop->isArrival && (Signal->GetSender() == runnableStop))
+	&& (   (evStop->isArrival && (Event.runnable == runnableStop))
+            || (!evStop->isArrival && (Event.partner == runnableStop))
 	   )
-        && (Signal->GetSignalType()->GetName() == evStop->nameSigReq)
+        && SameName(Event.msgName, evStop->nameSigReq)
        )
     {
       ActivityStop();
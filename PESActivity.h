@@ -24,21 +24,23 @@ class PESEvent: public PESTally, public PESCounter
     PESEvent(const char *        Name, 
              const PDEventType * EventType,
              SCDuration          Interval);
+    ~PESEvent(void);
 
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
     void      Reset(void);
     void      Report(SCStream& Out) const;
+    void      Export(PEReportWriter& Out) const;
     double    GetValue(int ValueIndex) const;
     
-    void EvProcessCreate(const SCProcess* Process, const SCProcess*);
-    void EvSignalReceive(const SCProcess* Process, const SCSignal* Message);
-    void EvMachineCreate(const SCMachine* Machine); 
-    void EvServiceRequest(const SCMachine* Machine, const SCRequest* Request);
+    void EvProcessCreate(const PEEvent & Event);
+    void EvSignalReceive(const PEEvent & Event);
+    void EvMachineCreate(const PEEvent & Event); 
+    void EvServiceRequest(const PEEvent & Event);
 
   private:    
-    const char *             name;     // Name des Sensors im Report
+    char *                   name;     // Name des Sensors im Report
     const PDEventType* const evType;
-    const SCRunnable*        runnable;
+    const void*              runnable; // Prozess bzw. Maschine (Identitaet)
     SCTime                   lastEvent;
 };
 
@@ -54,27 +56,29 @@ class PESActivity: public PESTally, public PESCounter
 		const PDEventType* Start, 
 		const PDEventType* Stop,
 		SCDuration         Interval);
+    ~PESActivity(void);
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
     void      Reset(void);   
     void      Report(SCStream& Out) const;    
+    void      Export(PEReportWriter& Out) const;
     double    GetValue(int ValueIndex) const;
     
-    void EvProcessCreate(const SCProcess* Process, const SCProcess*);
-    void EvSignalReceive(const SCProcess* Process, const SCSignal* Message);
-    void EvMachineCreate(const SCMachine* Machine); 
-    void EvServiceRequest(const SCMachine* Machine, const SCRequest* Request);
+    void EvProcessCreate(const PEEvent & Event);
+    void EvSignalReceive(const PEEvent & Event);
+    void EvMachineCreate(const PEEvent & Event); 
+    void EvServiceRequest(const PEEvent & Event);
     
   protected:
     virtual void ActivityStart(void);
     virtual void ActivityStop(void);
 
   private:
-    const char *             name;
+    char *                   name;
     const PDEventType* const evStart;
     const PDEventType* const evStop;
-    const SCRunnable*        runnableStart;
-    const SCRunnable*        runnableStop;
+    const void*              runnableStart;
+    const void*              runnableStop;
     SCTime                   activityStart;
     SCBoolean                activityHasStopped;
 };
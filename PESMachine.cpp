@@ -25,9 +25,12 @@
 \******************************************************************************/  
 
 PESMachine::PESMachine(const SCMachine * Machine) :
-  machine (Machine),
-  machineName (NULL)
+  machine (Machine)
 {
+  if (Machine)
+    machineName = strdup(Machine->GetName());
+  else
+    machineName = NULL;
 }
 
   
@@ -55,13 +58,20 @@ SCBoolean PESMachine::NotifyOnEvent(SCTraceAction Event) const
   return (Event == scTraceMachineCreate);
 }
 
+
+// Alle Ereignisse eines Maschinen-Sensors beziehen sich auf seine Maschine
+const void * PESMachine::RoutingKey(SCTraceAction) const
+{
+  return machine;
+}
+
   
-void PESMachine::EvMachineCreate(const SCMachine * Machine)
+void PESMachine::EvMachineCreate(const PEEvent & Event)
 {
   if (!machine && machineName)
   {
-    if (!strcmp(Machine->GetName(), machineName))
-      machine = Machine;
+    if (!strcmp(Event.runnableName, machineName))
+      machine = (const SCMachine *)Event.runnable;
   }
 }
 
@@ -98,24 +108,21 @@ SCBoolean PESMachineQueue::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESMachineQueue::EvServiceRequest(const SCMachine * Machine,
-                                       const SCRequest *)
+void PESMachineQueue::EvServiceRequest(const PEEvent & Event)
 {
-  if (Machine == machine) UpdateQLen(1);
+  if (Event.runnable == machine) UpdateQLen(1);
 }
 
 
-void PESMachineQueue::EvServiceStart(const SCMachine * Machine,
-                                     const SCRequest *)
+void PESMachineQueue::EvServiceStart(const PEEvent & Event)
 {
-  if (Machine == machine) UpdateQLen(-1);
+  if (Event.runnable == machine) UpdateQLen(-1);
 }
 
 
-void PESMachineQueue::EvServiceInterrupt(const SCMachine * Machine,
-                                         const SCRequest *)
+void PESMachineQueue::EvServiceInterrupt(const PEEvent & Event)
 {
-  if (Machine == machine) UpdateQLen(1);
+  if (Event.runnable == machine) UpdateQLen(1);
 }
 
 
@@ -147,8 +154,8 @@ void PESMachineQLen::UpdateQLen(int QLenDiff)
 
 void PESMachineQLen::Report(SCStream& Out) const
 {
-  Out << "Queue length of '" << *machine << "':";
-  Underline(Out, strlen(machine->GetName()) + 42); 
+  Out << "Queue length of '" << machineName << "':";
+  Underline(Out, strlen(machineName) + 42); 
   PESTally::Report(Out);
 }
 
@@ -177,8 +184,8 @@ void PESMachineQLenFrequency::UpdateQLen(int QLenDiff)
 
 void PESMachineQLenFrequency::Report(SCStream& Out) const 
 {
-  Out << "Queue length frequency of '" << *machine << "':";
-  Underline(Out, strlen(machine->GetName()) + 52);
+  Out << "Queue length frequency of '" << machineName << "':";
+  Underline(Out, strlen(machineName) + 52);
   PESFrequency::Report(Out);
 }
 
@@ -192,9 +199,12 @@ PESRequestWaitTime::PESRequestWaitTime(const SCMachine *     Machine,
                                        const SCRequestType * RequestType) :
   PESMachine (Machine),
   PESTally   (Interval),
-  requestType(RequestType),
-  requestName(NULL)  
+  requestType(RequestType)
 {
+  if (RequestType)
+    requestName = strdup(RequestType->GetName());
+  else
+    requestName = NULL;
 }
 
 
@@ -228,21 +238,20 @@ SCBoolean PESRequestWaitTime::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESRequestWaitTime::EvServiceStart(const SCMachine * Machine,
-                                        const SCRequest * Request)
+void PESRequestWaitTime::EvServiceStart(const PEEvent & Event)
 {
   if (!requestType && requestName)
   {
-    if (!strcmp(requestName, Request->GetRequestType()->GetName()))
-      requestType = Request->GetRequestType();
+    if (!strcmp(requestName, Event.msgName))
+      requestType = (const SCRequestType *)Event.msgType;
   }
   
-  if (Machine == machine)
+  if (Event.runnable == machine)
   {
     if (requestType == NULL ||
-        Request->GetRequestType() == requestType)
+        Event.msgType == requestType)
     {
-      UpdateTally(Now() - Request->GetWaitStartTime());
+      UpdateTally(Now() - Event.msgWaitStart);
     }
   }
 }
@@ -250,20 +259,20 @@ void PESRequestWaitTime::EvServiceStart(const SCMachine * Machine,
 
 void PESRequestWaitTime::Report(SCStream& Out) const 
 {
-  int Len = strlen(machine->GetName()) + 38;
+  int Len = strlen(machineName) + 38;
   
   Out << "Wait time of ";
   if (requestType != NULL)
   {
-    Out << "request '" << *requestType << "'";
-    Len += strlen(requestType->GetName()) + 9;
+    Out << "request '" << requestName << "'";
+    Len += strlen(requestName) + 9;
   }
   else
   {
     Out << "all requests";
     Len += 16;
   }
-  Out << " at '" << *machine << "':";
+  Out << " at '" << machineName << "':";
   Underline(Out, Len);
   PESTally::Report(Out);
 }
@@ -278,9 +287,12 @@ PESRequestThruTime::PESRequestThruTime(const SCMachine *     Machine,
                                        const SCRequestType * RequestType) :
   PESMachine (Machine),
   PESTally   (Interval),
-  requestType(RequestType),
-  requestName(NULL)
+  requestType(RequestType)
 {
+  if (RequestType)
+    requestName = strdup(RequestType->GetName());
+  else
+    requestName = NULL;
 }
 
 
@@ -314,21 +326,20 @@ SCBoolean PESRequestThruTime::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESRequestThruTime::EvServiceFinish(const SCMachine * Machine,
-                                         const SCRequest * Request)
+void PESRequestThruTime::EvServiceFinish(const PEEvent & Event)
 {
   if (!requestType && requestName)
   {
-    if (!strcmp(requestName, Request->GetRequestType()->GetName()))
-      requestType = Request->GetRequestType();
+    if (!strcmp(requestName, Event.msgName))
+      requestType = (const SCRequestType *)Event.msgType;
   }
   
-  if (Machine == machine)
+  if (Event.runnable == machine)
   {
     if (requestType == NULL ||
-        Request->GetRequestType() == requestType)
+        Event.msgType == requestType)
     {
-      UpdateTally(Now() - Request->GetCreationTime());
+      UpdateTally(Now() - Event.msgCreation);
     }
   }
 }
@@ -336,21 +347,21 @@ void PESRequestThruTime::EvServiceFinish(const SCMachine * Machine,
 
 void PESRequestThruTime::Report(SCStream& Out) const 
 {
-  int Len = strlen(machine->GetName()) + 28;
+  int Len = strlen(machineName) + 28;
   
   Out << "Thru time of ";
 
   if (requestType != NULL)
   {
-    Out << "request '" << *requestType << "'";
-    Len += strlen(requestType->GetName()) + 9;
+    Out << "request '" << requestName << "'";
+    Len += strlen(requestName) + 9;
   }
   else
   {
     Out << "all requests";
     Len += 11;
   }
-  Out << " at '" << *machine << "':";
+  Out << " at '" << machineName << "':";
   Underline(Out, Len);
   PESTally::Report(Out);
 }
@@ -389,14 +400,25 @@ SCBoolean PESRequestFrequency::NotifyOnEvent(SCTraceAction Event) const
       || (!reqIn && PESProcess::NotifyOnEvent(Event));
 }
 
+
+const void * PESRequestFrequency::RoutingKey(SCTraceAction Event) const
+{
+  switch (Event)
+  {
+    case scTraceProcessCreate: return PESProcess::RoutingKey(Event);
+    case scTraceMachineCreate: return PESMachine::RoutingKey(Event);
+    default:                   return reqIn ? PESMachine::RoutingKey(Event)
+                                            : routeAll; // Aufrufer zaehlt
+  }
+}
+
     
-void PESRequestFrequency::EvServiceRequest(const SCMachine * Machine,
-                                           const SCRequest * Request)
+void PESRequestFrequency::EvServiceRequest(const PEEvent & Event)
 {
-  if ((reqIn && Machine == machine) ||
-      (!reqIn && ((SCProcess *)Request->GetCaller())->GetType() == processType))
+  if ((reqIn && Event.runnable == machine) ||
+      (!reqIn && Event.partnerType == processType))
   {
-    UpdateFreq(Request->GetRequestType()->GetID(), 1);
+    UpdateFreq(Event.msgID, 1);
   }
 }
 
@@ -407,14 +429,14 @@ void PESRequestFrequency::Report(SCStream& Out) const
   if (reqIn)
   {
     assert(machine);
-    Out << "at '" << *machine << "':";
-    Underline(Out, strlen(machine->GetName()) + 38);
+    Out << "at '" << machineName << "':";
+    Underline(Out, strlen(machineName) + 38);
   }
   else
   {
     assert(processType);
-    Out << "from '" << *processType << "':";
-    Underline(Out, strlen(processType->GetName()) + 38);
+    Out << "from '" << processName << "':";
+    Underline(Out, strlen(processName) + 38);
   } 
   PESFrequency::Report(Out);
 }
@@ -437,11 +459,9 @@ SCBoolean PESGlobalRequestFrequency::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESGlobalRequestFrequency::EvServiceRequest(const SCMachine *,
-                                                 const SCRequest * Request)
+void PESGlobalRequestFrequency::EvServiceRequest(const PEEvent & Event)
 {
-  SCInteger Key = Request->GetRequestType()->GetID();
-  UpdateFreq(Key, 1);
+  UpdateFreq(Event.msgID, 1);
 }
 
 
@@ -491,15 +511,14 @@ SCBoolean PESMachineUtilization::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESMachineUtilization::EvServiceStart(const SCMachine * Machine,
-                                           const SCRequest *)
+void PESMachineUtilization::EvServiceStart(const PEEvent & Event)
 {
-  if (Machine == machine)
+  if (Event.runnable == machine)
   {
     SCDuration weight = Now() - lastChange;
 
-    SCReal sample = 1.0 - (((SCReal)machine->NumOfFreeServers() + 1)/
-                           (SCReal)machine->NumOfServers());
+    SCReal sample = 1.0 - (((SCReal)Event.freeServers + 1)/
+                           (SCReal)Event.numServers);
     assert(sample >= 0.0);
     UpdateTally (sample, weight);
     
@@ -508,15 +527,14 @@ void PESMachineUtilization::EvServiceStart(const SCMachine * Machine,
 }
 
     
-void PESMachineUtilization::EvServiceInterrupt(const SCMachine * Machine,
-                                               const SCRequest *)
+void PESMachineUtilization::EvServiceInterrupt(const PEEvent & Event)
 {
-  if (Machine == machine)
+  if (Event.runnable == machine)
   {
     SCDuration weight = Now() - lastChange;
 
-    SCReal sample = 1.0 - (((SCReal)machine->NumOfFreeServers() - 1)/
-                           (SCReal)machine->NumOfServers());
+    SCReal sample = 1.0 - (((SCReal)Event.freeServers - 1)/
+                           (SCReal)Event.numServers);
     assert(sample >= 0.0);
     UpdateTally (sample, weight);
     
@@ -525,15 +543,14 @@ void PESMachineUtilization::EvServiceInterrupt(const SCMachine * Machine,
 }
 
 
-void PESMachineUtilization::EvServiceFinish(const SCMachine * Machine,
-                                            const SCRequest *)
+void PESMachineUtilization::EvServiceFinish(const PEEvent & Event)
 {
-  if (Machine == machine)
+  if (Event.runnable == machine)
   {
     SCDuration weight = Now() - lastChange;
 
-    SCReal sample = 1.0 - (((SCReal)machine->NumOfFreeServers() - 1)/
-                           (SCReal)machine->NumOfServers());
+    SCReal sample = 1.0 - (((SCReal)Event.freeServers - 1)/
+                           (SCReal)Event.numServers);
     assert(sample >= 0.0);
     UpdateTally (sample, weight);
     
@@ -544,7 +561,7 @@ void PESMachineUtilization::EvServiceFinish(const SCMachine * Machine,
 
 void PESMachineUtilization::Report(SCStream& Out) const
 {
-  Out << "Utilization of '" << *machine << "':";
+  Out << "Utilization of '" << machineName << "':";
   Underline(Out, 58);
   PESTally::Report(Out);
 }
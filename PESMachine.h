@@ -31,7 +31,8 @@ class PESMachine: virtual public PESensor
     ~PESMachine(void);
   
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvMachineCreate(const SCMachine * Machine);
+    const void * RoutingKey(SCTraceAction Event) const;
+    void EvMachineCreate(const PEEvent & Event);
 
   protected:   
     const SCMachine * machine;
@@ -51,12 +52,9 @@ class PESMachineQueue: public PESMachine, protected virtual PESQueue
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
     
-    void EvServiceRequest(const SCMachine * Machine,
-                          const SCRequest* Request); 
-    void EvServiceStart(const SCMachine * Machine,
-                        const SCRequest* Request);
-    void EvServiceInterrupt(const SCMachine * Machine,
-                            const SCRequest* Request);
+    void EvServiceRequest(const PEEvent & Event); 
+    void EvServiceStart(const PEEvent & Event);
+    void EvServiceInterrupt(const PEEvent & Event);
 };
 
 
@@ -113,9 +111,9 @@ class PESMachineUtilization: public PESMachine, public PESTally
     void Report(SCStream& Out) const;
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvServiceStart(const SCMachine* Machine, const SCRequest*);
-    void EvServiceFinish(const SCMachine* Machine, const SCRequest*);
-    void EvServiceInterrupt(const SCMachine* Machine, const SCRequest*);
+    void EvServiceStart(const PEEvent & Event);
+    void EvServiceFinish(const PEEvent & Event);
+    void EvServiceInterrupt(const PEEvent & Event);
     
   private:  
     SCTime lastChange;  // Zeitpunkt der letzte Aenderung der  
@@ -146,8 +144,7 @@ class PESRequestWaitTime: public PESMachine, public PESTally
     ~PESRequestWaitTime(void);
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvServiceStart(const SCMachine* Machine,
-                        const SCRequest* Request);
+    void EvServiceStart(const PEEvent & Event);
     void Report(SCStream& Out) const;    
     
   private:
@@ -173,8 +170,7 @@ class PESRequestThruTime: public PESMachine, public PESTally
     
     void Report(SCStream& Out) const;
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvServiceFinish(const SCMachine* Machine,
-                         const SCRequest* Request);
+    void EvServiceFinish(const PEEvent & Event);
     
   private:
     const SCRequestType * requestType;
@@ -198,8 +194,8 @@ class PESRequestFrequency: public PESMachine, public PESProcess,
 
     void Report(SCStream& Out) const;
     SCBoolean NotifyOnEvent(SCTraceAction Event) const; 
-    void EvServiceRequest(const SCMachine * Machine,
-                          const SCRequest* Request);
+    const void * RoutingKey(SCTraceAction Event) const;
+    void EvServiceRequest(const PEEvent & Event);
     
   private:
     SCBoolean reqIn;
@@ -216,8 +212,7 @@ class PESGlobalRequestFrequency: public PESFrequency //, public PDNameTable
     PESGlobalRequestFrequency(void);
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const; 
-    void EvServiceRequest(const SCMachine*,
-                          const SCRequest* Request);  
+    void EvServiceRequest(const PEEvent & Event);  
     void Report(SCStream& Out) const;    
 };
 
@@ -24,9 +24,12 @@
 \******************************************************************************/ 
 
 PESProcess::PESProcess(const SCProcessType * ProcessType) :
-  processType (ProcessType),
-  processName (NULL)
+  processType (ProcessType)
 {
+  if (ProcessType)
+    processName = strdup(ProcessType->GetName());
+  else
+    processName = NULL;
 }    
 
 
@@ -54,13 +57,21 @@ SCBoolean PESProcess::NotifyOnEvent(SCTraceAction Event) const
 {
   return (Event == scTraceProcessCreate);
 }
+
+
+// Alle Ereignisse eines Prozess-Sensors beziehen sich auf seinen Prozesstyp
+const void * PESProcess::RoutingKey(SCTraceAction) const
+{
+  return processType;
+}
+
     
-void PESProcess::EvProcessCreate(const SCProcess* Process, const SCProcess*)
+void PESProcess::EvProcessCreate(const PEEvent & Event)
 {
   if (!processType && processName)
   {
-    if (!strcmp(Process->GetType()->GetName(), processName))
-      processType = Process->GetType();
+    if (!strcmp(Event.runnableName, processName))
+      processType = (const SCProcessType *)Event.runnableType;
   }  
 }
 
@@ -90,21 +101,21 @@ SCBoolean PESProcessQueue::NotifyOnEvent(SCTraceAction Event) const
 }
 
  
-void PESProcessQueue::EvSignalReceive(const SCProcess* Process, const SCSignal*)
+void PESProcessQueue::EvSignalReceive(const PEEvent & Event)
 {
-  if (Process->GetType() == processType) UpdateQLen(1);
+  if (Event.runnableType == processType) UpdateQLen(1);
 }
 
  
-void PESProcessQueue::EvSignalConsume(const SCProcess* Process, const SCSignal*)
+void PESProcessQueue::EvSignalConsume(const PEEvent & Event)
 {
-  if (Process->GetType() == processType) UpdateQLen(-1);
+  if (Event.runnableType == processType) UpdateQLen(-1);
 }
 
 
-void PESProcessQueue::EvSignalDrop(const SCProcess* Process, const SCSignal*)
+void PESProcessQueue::EvSignalDrop(const PEEvent & Event)
 {
-  if (Process->GetType() == processType) UpdateQLen(-1);
+  if (Event.runnableType == processType) UpdateQLen(-1);
 }
 
 
@@ -136,8 +147,8 @@ void PESProcessQLen::UpdateQLen(int QLenDiff)
 
 void PESProcessQLen::Report(SCStream& Out) const
 {
-  Out << "Queue length of '" << *processType << "':";
-  Underline(Out, strlen(processType->GetName()) + 52); 
+  Out << "Queue length of '" << processName << "':";
+  Underline(Out, strlen(processName) + 52); 
   PESTally::Report(Out);
 }
 
@@ -166,8 +177,8 @@ void PESProcessQLenFrequency::UpdateQLen(int QLenDiff)
 
 void PESProcessQLenFrequency::Report(SCStream& Out) const
 {
-  Out << "Queue length frequency of '" << *processType << "':";
-  Underline(Out, strlen(processType->GetName()) + 36); 
+  Out << "Queue length frequency of '" << processName << "':";
+  Underline(Out, strlen(processName) + 36); 
   PESFrequency::Report(Out);
 }
 
@@ -181,9 +192,12 @@ PESSignalWaitTime::PESSignalWaitTime(const SCProcessType * ProcessType,
                                      const SCSignalType *  SignalType) :
   PESProcess (ProcessType),
   PESTally   (Interval),
-  signalType (SignalType),
-  signalName (NULL)
+  signalType (SignalType)
 {
+  if (SignalType)
+    signalName = strdup(SignalType->GetName());
+  else
+    signalName = NULL;
 }
 
 PESSignalWaitTime::PESSignalWaitTime(const char * ProcessName, 
@@ -216,21 +230,20 @@ SCBoolean PESSignalWaitTime::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESSignalWaitTime::EvSignalConsume(const SCProcess* Process,
-                                        const SCSignal * Signal)
+void PESSignalWaitTime::EvSignalConsume(const PEEvent & Event)
 {
   if (!signalType && signalName)
   {
-    if (!strcmp(signalName, Signal->GetSignalType()->GetName()))
-      signalType = Signal->GetSignalType();
+    if (!strcmp(signalName, Event.msgName))
+      signalType = (const SCSignalType *)Event.msgType;
   }
   
-  if (Process->GetType() == processType)
+  if (Event.runnableType == processType)
   {
     if (signalType == NULL ||
-        signalType == Signal->GetSignalType())
+        signalType == Event.msgType)
     {
-      UpdateTally(Now() - Signal->GetCreationTime());
+      UpdateTally(Now() - Event.msgCreation);
     }
   }
 }
@@ -238,20 +251,20 @@ void PESSignalWaitTime::EvSignalConsume(const SCProcess* Process,
 
 void PESSignalWaitTime::Report(SCStream& Out) const
 {
-  int Len = strlen(processType->GetName()) + 42;
+  int Len = strlen(processName) + 42;
   
   Out << "Wait time of ";
   if (signalType != NULL)
   {
-    Out << "signal '" << *signalType << "'";
-    Len += strlen(signalType->GetName()) + 8;
+    Out << "signal '" << signalName << "'";
+    Len += strlen(signalName) + 8;
   }
   else
   {
     Out << "all signals";
     Len += 10;
   }
-  Out << " at '" << *processType << "':";
+  Out << " at '" << processName << "':";
   Underline(Out, Len);
   PESTally::Report(Out);
 }
@@ -285,13 +298,21 @@ SCBoolean PESSignalFrequency::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESSignalFrequency::EvSignalReceive(const SCProcess* Process,
-                                         const SCSignal* Signal)
+const void * PESSignalFrequency::RoutingKey(SCTraceAction Event) const
 {
-  if ((sigIn && Process->GetType() == processType) ||
-      (!sigIn && Signal->GetSenderType() == processType))
+  if (!sigIn && Event == scTraceSignalReceive)
+    return routeAll; // Ereignis gehoert zum Empfaenger, nicht zum Sender
+
+  return PESProcess::RoutingKey(Event);
+}
+
+
+void PESSignalFrequency::EvSignalReceive(const PEEvent & Event)
+{
+  if ((sigIn && Event.runnableType == processType) ||
+      (!sigIn && Event.partnerType == processType))
   {
-    UpdateFreq(Signal->GetSignalType()->GetID(), 1);
+    UpdateFreq(Event.msgID, 1);
   }
 }
 
@@ -300,8 +321,8 @@ void PESSignalFrequency::Report(SCStream& Out) const
 {
   Out << "Signal frequency " 
       << (sigIn ? "at '" : "from '")
-      << *processType << "':";   
-  Underline(Out, strlen(processType->GetName()) + 38);
+      << processName << "':";   
+  Underline(Out, strlen(processName) + 38);
   PESFrequency::Report(Out);
 }
 
@@ -323,10 +344,9 @@ SCBoolean PESGlobalSignalFrequency::NotifyOnEvent(SCTraceAction Event) const
 }
 
 
-void PESGlobalSignalFrequency::EvSignalReceive(const SCProcess *,
-                                               const SCSignal * Signal)
+void PESGlobalSignalFrequency::EvSignalReceive(const PEEvent & Event)
 {
-  UpdateFreq(Signal->GetSignalType()->GetID(), 1);
+  UpdateFreq(Event.msgID, 1);
 }
 
 
@@ -345,7 +365,7 @@ void PESGlobalSignalFrequency::Report(SCStream& Out) const
 PESStateFrequency::PESStateFrequency(const SCProcessType * ProcessType) :
   PESProcess   (ProcessType),
   PESFrequency (SC_STATE),
-  currentState (NULL)
+  currentState (noState)
 {
 }
 
@@ -353,7 +373,7 @@ PESStateFrequency::PESStateFrequency(const SCProcessType * ProcessType) :
 PESStateFrequency::PESStateFrequency(const char * ProcessName) :
   PESProcess   (ProcessName),
   PESFrequency (SC_STATE),
-  currentState (NULL)
+  currentState (noState)
 {
 }
 
@@ -373,10 +393,10 @@ double PESStateFrequency::GetValue(int Index) const
 {
   if (Index == ganttState)
   {
-    if (currentState == NULL)
+    if (currentState == noState)
       return -1;
     else
-      return (currentState->GetID() - stateTable.GetMinStateID() + 1);
+      return (currentState - stateTable.GetMinStateID() + 1);
   }
   else
     return PESFrequency::GetValue(Index);
@@ -386,34 +406,33 @@ double PESStateFrequency::GetValue(int Index) const
 void PESStateFrequency::Reset()
 {
   PESFrequency::Reset();
-  currentState = NULL;
+  currentState = noState;
   stateTable.Reset();
 }
 
 
 void PESStateFrequency::Report(SCStream& Out) const
 {
-  Out << "State frequency of '" << *processType << "':";
-  Underline(Out, strlen(processType->GetName()) + 35);
+  Out << "State frequency of '" << processName << "':";
+  Underline(Out, strlen(processName) + 35);
   PESFrequency::Report(Out);
 }
 
 
-void PESStateFrequency::EvStateChange(const SCProcess* Process,
-                                      const SCStateType* NewState)
+void PESStateFrequency::EvStateChange(const PEEvent & Event)
 {
-  if (Process->GetType() == processType)
+  if (Event.runnableType == processType)
   {
-    if (currentState == NULL)
+    if (currentState == noState)
     { // Erstes Ereignis
       lastChange = Now();
-      currentState = NewState;
+      currentState = Event.msgID;
     }
     else
     {
-      UpdateFreq(currentState->GetID(), Now() - lastChange);
+      UpdateFreq(currentState, Now() - lastChange);
       lastChange = Now();
-      currentState = NewState;
+      currentState = Event.msgID;
     }
     stateTable.RegisterState(currentState);
   }
@@ -471,17 +490,22 @@ SCBoolean PESProcessNumber::NotifyOnEvent(SCTraceAction Event) const
   return (Event == scTraceProcessCreate || Event == scTraceProcessStop);
 }
 
+
+const void * PESProcessNumber::RoutingKey(SCTraceAction) const
+{
+  return processType;
+}
+
     
-void PESProcessNumber::EvProcessCreate(const SCProcess* Process,
-                                       const SCProcess*)
+void PESProcessNumber::EvProcessCreate(const PEEvent & Event)
 {
   if (!processType && processName)
   {
-    if (!strcmp(processName, Process->GetType()->GetName()))
-      processType = Process->GetType();
+    if (!strcmp(processName, Event.runnableName))
+      processType = (const SCProcessType *)Event.runnableType;
   }
   
-  if (Process->GetType() == processType)
+  if (Event.runnableType == processType)
   {
     UpdateTally(count, Now() - lastChange);
     count++;
@@ -489,9 +513,9 @@ void PESProcessNumber::EvProcessCreate(const SCProcess* Process,
   }  
 }
 
-void PESProcessNumber::EvProcessDelete(const SCProcess* Process)
+void PESProcessNumber::EvProcessDelete(const PEEvent & Event)
 {
-  if (Process->GetType() == processType)
+  if (Event.runnableType == processType)
   {
     UpdateTally(count, Now() - lastChange);
     count--;
@@ -501,7 +525,7 @@ void PESProcessNumber::EvProcessDelete(const SCProcess* Process)
 
 void PESProcessNumber::Report(SCStream& Out) const
 {
-  Out << "Number of '" << *processType << "' instances:";
-  Underline(Out, strlen(processType->GetName()) + 30);
+  Out << "Number of '" << processName << "' instances:";
+  Underline(Out, strlen(processName) + 30);
   PESTally::Report(Out);
 }
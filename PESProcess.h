@@ -30,7 +30,8 @@ class PESProcess: virtual public PESensor
     ~PESProcess(void);
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvProcessCreate(const SCProcess * Process, const SCProcess *);
+    const void * RoutingKey(SCTraceAction Event) const;
+    void EvProcessCreate(const PEEvent & Event);
     
   protected:
     const SCProcessType * processType;
@@ -50,9 +51,9 @@ class PESProcessQueue: public PESProcess, protected virtual PESQueue
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
     
-    void EvSignalReceive(const SCProcess* Process, const SCSignal*);
-    void EvSignalConsume(const SCProcess* Process, const SCSignal*);
-    void EvSignalDrop(const SCProcess* Process, const SCSignal*);
+    void EvSignalReceive(const PEEvent & Event);
+    void EvSignalConsume(const PEEvent & Event);
+    void EvSignalDrop(const PEEvent & Event);
 };
 
 
@@ -108,7 +109,7 @@ class PESSignalWaitTime: public PESProcess, public PESTally
     ~PESSignalWaitTime(void);
 
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvSignalConsume(const SCProcess* Process, const SCSignal* Message);
+    void EvSignalConsume(const PEEvent & Event);
     void Report(SCStream& Out) const;
     
   private:
@@ -130,7 +131,8 @@ class PESSignalFrequency: public PESProcess, public PESFrequency
                        SCBoolean             SignalIn);
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvSignalReceive(const SCProcess* Process, const SCSignal* Message);
+    const void * RoutingKey(SCTraceAction Event) const;
+    void EvSignalReceive(const PEEvent & Event);
     void Report(SCStream& Out) const;
     
   private:
@@ -152,7 +154,7 @@ class PESGlobalSignalFrequency: public PESFrequency //, public PDNameTable
     PESGlobalSignalFrequency(void);
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const; 
-    void EvSignalReceive(const SCProcess*, const SCSignal* Message);
+    void EvSignalReceive(const PEEvent & Event);
     void Report(SCStream& Out) const;    
 };
 
@@ -170,8 +172,7 @@ class PESStateFrequency: virtual public PESProcess,
     ~PESStateFrequency(void);
 
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void      EvStateChange(const SCProcess* Process,
-                            const SCStateType* NewState);
+    void EvStateChange(const PEEvent & Event);
     void Reset(void);
     void Report(SCStream& Out) const;
     
@@ -183,7 +184,9 @@ class PESStateFrequency: virtual public PESProcess,
     const  PDStateTable & GetStateTable (void) const { return stateTable; }
     
   private:
-    const SCStateType * currentState;
+    enum {noState = -1};              // noch kein Zustand bekannt
+
+    SCInteger           currentState; // ID des aktuellen Zustands
     SCTime              lastChange;
     PDStateTable        stateTable;
 };
@@ -203,8 +206,9 @@ class PESProcessNumber: public PESTally
     ~PESProcessNumber(void);
     
     SCBoolean NotifyOnEvent(SCTraceAction Event) const;
-    void EvProcessCreate(const SCProcess* Process, const SCProcess*);    
-    void EvProcessDelete(const SCProcess* Process);
+    const void * RoutingKey(SCTraceAction Event) const;
+    void EvProcessCreate(const PEEvent & Event);    
+    void EvProcessDelete(const PEEvent & Event);
  
     void Reset(void);
     void Report(SCStream& Out) const;
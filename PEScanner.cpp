@@ -1,5 +1,6 @@
 #include <ctype.h>
 #include <string.h>
+#include <assert.h>
 
 #include <SCL/SCScheduler.h>
 
@@ -15,10 +16,18 @@
 
 static const char * ValIndexTypeNames[numValIndexTypes] =
 {
-  "num", "min", "max", "avg", "avi", "var", "dev", "cnt", "cpt", "cpi", "cql"
+  "num", "min", "max", "avg", "avi", "var", "dev", "p50", "p90", "p95", "p99",
+  "cnt", "cpt", "cpi", "cql"
 };
 
 
+const char * ValIndexTypeName(long ValIndexType)
+{
+  assert(ValIndexType >= 0 && ValIndexType < numValIndexTypes);
+  return ValIndexTypeNames[ValIndexType];
+}
+
+
 SCBoolean SensorHasInterval(long SensorType)
 {
   static const long HasInterval = (1 << sProcQLen )       |
@@ -84,6 +93,18 @@ SCBoolean Scanner::CheckChar(char C)
 }
 
 
+// Fuer optionale Eintraege der Konfiguration: Prueft, ob als naechstes das
+// Schluesselwort KeyWord folgt, ohne es zu lesen.
+SCBoolean Scanner::CheckKeyWord(const char * KeyWord)
+{
+  int len = strlen(KeyWord);
+
+  SkipIt();
+  return !strncmp(buf + col, KeyWord, len) &&
+         !(isalnum(buf[col + len]) || buf[col + len] == '_');
+}
+
+
 void Scanner::SkipIt()
 {
   while ((col == maxCol) || !((buf[col] == ':')  || 
@@ -291,7 +312,9 @@ void Scanner::GetConParas(int& ValIndex, char * ColorName,
                           int DispType, int SensorType)
 {
   char Name[128];
-  SCBoolean   ColorOnly = !(DispType == dCurves || DispType == dFixedCurves);
+  SCBoolean   ColorOnly = !(DispType == dCurves || DispType == dFixedCurves ||
+                            DispType == dRunCurves ||
+                            DispType == dFixedRunCurves);
 
   if (DispType == dGantt) ValIndex = PESStateFrequency::ganttState;
   strcpy(ColorName, "");
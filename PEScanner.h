@@ -14,6 +14,7 @@ class Scanner
 
     void GetChar(char C, const char * Msg);
     SCBoolean CheckChar(char c);
+    SCBoolean CheckKeyWord(const char * KeyWord); // folgt KeyWord? (ohne Lesen)
     void GetString(char * Buffer);
     void GetInt(int& Buffer);
     void GetDbl(double& Buffer);
@@ -44,3 +45,6 @@ private:
   void SkipIt();
 };
 
+SCBoolean    IsFreqSensor(long SensorType);
+const char * ValIndexTypeName(long ValIndexType); // z.B. "avg"
+
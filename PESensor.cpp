@@ -10,9 +10,12 @@
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
+#include <iostream>
 #include <iomanip>
 
 #include "PESensor.h"
+#include "PEInstrument.h"
+#include "PEReportWriter.h"
 
 #if _SC_DMALLOC
   #include <dmalloc.h>
@@ -24,6 +27,10 @@ using namespace std;
  PESensor: Implementierung
 \******************************************************************************/
 
+const void * const PESensor::routeAll = &PESensor::routeAll; // eindeutige Marke
+
+__thread SCTime PESensor::clock = -1.0;
+
 void PESensor::Underline(SCStream& Out, int Len) const 
 {
   Out << std::endl;
@@ -32,6 +39,34 @@ void PESensor::Underline(SCStream& Out, int Len) const
 }
 
 
+void * PESensor::operator new(size_t Size)
+{
+  void * memory;
+
+  Size = (Size + cacheLine - 1) & ~(size_t)(cacheLine - 1);
+  if (posix_memalign(&memory, cacheLine, Size))
+  {
+    std::cerr << "Cannot allocate sensor!\n";
+    abort();
+  }
+  return memory;
+}
+
+
+void PESensor::operator delete(void * Memory)
+{
+  free(Memory);
+}
+
+
+void PESensor::SetName(const char * Name)
+{
+  delete[] sensorName;
+  sensorName = new char[strlen(Name) + 1];
+  strcpy(sensorName, Name);
+}
+
+
 SCStream& operator<< (SCStream& pStream, const PESensor&)
 {
   return pStream;
@@ -43,15 +78,24 @@ SCStream& operator<< (SCStream& pStream, const PESensor&)
 \******************************************************************************/
 
 PESTally::PESTally(SCDuration IntervalLength) :
+  histogram  (NULL),
   intervalLen(IntervalLength)
 {
   Reset();
 }
 
 
+PESTally::~PESTally(void)
+{
+  delete[] histogram;
+}
+
+
 void PESTally::Reset(void)
 {
-  minS = maxS = sumS = sumS2 = numS = 0.0;
+  if (histogram) memset(histogram, 0, numBuckets * sizeof(double));
+  minS = maxS = meanS = m2S = numS = 0.0;
+  quantileNum = -1.0;
   intervalStop = Now() + intervalLen;
   intervalAvg = intervalSum = intervalNum = 0.0;
 }
@@ -67,12 +111,95 @@ void PESTally::Report(SCStream& Out) const
       << std::setw(12) << GetValue(avg) 
       << std::setw(12) << GetValue(var) 
       << std::setw(12) << GetValue(dev) 
+      << "\n  P50         P90         P95         P99\n  "
+      << std::setw(12) << GetValue(p50) 
+      << std::setw(12) << GetValue(p90) 
+      << std::setw(12) << GetValue(p95) 
+      << std::setw(12) << GetValue(p99) 
       << "\n\n";	
 }
 
 
+// Klasse einer Stichprobe: Exponent und die oberen subBits Bits der Mantisse
+// des IEEE-Bitmusters, das fuer positive Zahlen monoton ist
+int PESTally::Bucket(double Sample)
+{
+  unsigned long long bits;
+  long long          key;
+
+  if (!(Sample > 0.0)) return 0;             // auch 0, negativ und NaN
+
+  memcpy(&bits, &Sample, sizeof(bits));
+  key = (long long)(bits >> (52 - subBits)) - ((1023LL + minExp) << subBits);
+
+  if (key < 0) return 0;
+  if (key >= numBuckets) return numBuckets - 1;
+  return (int)key;
+}
+
+
+double PESTally::BucketValue(int Bucket)
+{
+  unsigned long long bits;
+  double             lower, upper;
+
+  if (Bucket == 0) return 0.0;
+
+  bits = (unsigned long long)(Bucket + ((1023LL + minExp) << subBits))
+         << (52 - subBits);
+  memcpy(&lower, &bits, sizeof(lower));
+  bits += 1ULL << (52 - subBits);
+  memcpy(&upper, &bits, sizeof(upper));
+
+  return (lower + upper) / 2;
+}
+
+
+// Gewichtete Quantile in einem Durchlauf: jeweils die Mitte der Klasse, in
+// der das Q-fache des Gesamtgewichts erreicht wird (HUGE_VAL, falls
+// Rundungsfehler das verhindern, wird unten zum Maximum)
+void PESTally::Quantiles(void) const
+{
+  static const double q[numQuantiles] = {0.50, 0.90, 0.95, 0.99};
+  double sum = 0.0;
+  int    i, k = 0;
+
+  for (i = 0; i < numBuckets && k < numQuantiles; i++)
+  {
+    if (histogram[i] == 0.0) continue;
+    sum += histogram[i];
+    while (k < numQuantiles && sum >= q[k] * numS)
+    {
+      quantiles[k++] = BucketValue(i);
+    }
+  }
+  while (k < numQuantiles)
+  {
+    quantiles[k++] = HUGE_VAL;
+  }
+  quantileNum = numS;
+}
+
+
+// Quantil begrenzt auf Minimum und Maximum
+double PESTally::Quantile(int Index) const
+{
+  double value;
+
+  if (!histogram || numS == 0.0) return 0;
+
+  if (quantileNum != numS) Quantiles();
+  value = quantiles[Index];
+  if (value < minS) value = minS;
+  if (value > maxS) value = maxS;
+
+  return value;
+}
+
+
 void PESTally::UpdateTally(double Sample, double Weight)
 {
+  PE_WORK();
   if (numS == 0.0)
   {
     minS = maxS = Sample; 
@@ -82,10 +209,21 @@ void PESTally::UpdateTally(double Sample, double Weight)
     if (Sample < minS) minS = Sample;
     else if (Sample > maxS) maxS = Sample;
   }
-  numS += Weight;
-  Sample *= Weight;
-  sumS += Sample;
-  sumS2 += Sample * Sample; 
+  if (Weight > 0.0)
+  {
+    double delta = Sample - meanS;
+
+    numS += Weight;
+    meanS += delta * (Weight / numS);
+    m2S += Weight * delta * (Sample - meanS);
+
+    if (!histogram)
+    {
+      histogram = new double[numBuckets];
+      memset(histogram, 0, numBuckets * sizeof(double));
+    }
+    histogram[Bucket(Sample)] += Weight;
+  }
 
   while (Now() >= intervalStop)
   {
@@ -93,11 +231,66 @@ void PESTally::UpdateTally(double Sample, double Weight)
     intervalNum = intervalSum = 0.0;
     intervalStop += intervalLen;
   }
-  intervalSum += Sample;
+  intervalSum += Sample * Weight;
   intervalNum += Weight;
 }
 
 
+// Vereinigung zweier Tallies nach Chan et al.: Das Ergebnis ist dasselbe, als
+// waeren alle Stichproben von Other auch hier eingegangen. Fuer das laufende
+// Intervall werden die Summen addiert; der Wert des letzten abgeschlossenen
+// Intervalls bleibt der eigene, solange es einen gibt.
+void PESTally::Merge(const PESTally& Other)
+{
+  double total, delta;
+
+  if (Other.numS == 0.0) return;
+
+  if (numS == 0.0)
+  {
+    minS = Other.minS;
+    maxS = Other.maxS;
+  }
+  else
+  {
+    if (Other.minS < minS) minS = Other.minS;
+    if (Other.maxS > maxS) maxS = Other.maxS;
+  }
+  total = numS + Other.numS;
+  delta = Other.meanS - meanS;
+  meanS += delta * (Other.numS / total);
+  m2S += Other.m2S + delta * delta * (numS * Other.numS / total);
+  numS = total;
+  quantileNum = -1.0;
+
+  if (Other.histogram)
+  {
+    if (!histogram)
+    {
+      histogram = new double[numBuckets];
+      memset(histogram, 0, numBuckets * sizeof(double));
+    }
+    for (int i = 0; i < numBuckets; i++)
+    {
+      histogram[i] += Other.histogram[i];
+    }
+  }
+
+  intervalSum += Other.intervalSum;
+  intervalNum += Other.intervalNum;
+  if (intervalAvg == 0.0) intervalAvg = Other.intervalAvg;
+}
+
+
+void PESTally::Export(PEReportWriter& Out) const
+{
+  for (int i = num; i < __T; i++)
+  {
+    Out.Record(i, GetValue(i));
+  }
+}
+
+
 double PESTally::GetValue(int ValIndex) const
 {
   switch (ValIndex)
@@ -112,7 +305,7 @@ double PESTally::GetValue(int ValIndex) const
       return  numS ? maxS : 0;
       
     case avg: 
-      return numS ? double(sumS / numS) : 0;
+      return numS ? meanS : 0;
 
     case avi:
       return intervalAvg;
@@ -121,7 +314,7 @@ double PESTally::GetValue(int ValIndex) const
       if (numS <= 1)
         return 0;
       else
-        return double((sumS2 - ((sumS * sumS) /  numS)) / ( numS + 1));
+        return m2S / (numS + 1);
 
     case dev:
       {
@@ -129,6 +322,12 @@ double PESTally::GetValue(int ValIndex) const
         return (!numS || Var <= 0) ? 0 : sqrt(Var);
       }
 
+    case p50:
+    case p90:
+    case p95:
+    case p99:
+      return Quantile(ValIndex - p50);
+
     default:
       std::cout << "Illegal ValIndex in Tally!\n"; abort();
   }
@@ -167,6 +366,15 @@ void PESCounter::Report(SCStream& Out) const
 }
 
 
+void PESCounter::Export(PEReportWriter& Out) const
+{
+  for (int i = cnt; i < __C; i++)
+  {
+    Out.Record(i, GetValue(i));
+  }
+}
+
+
 double PESCounter::GetValue(int ValIndex) const
 {
   switch (ValIndex)
@@ -181,6 +389,7 @@ double PESCounter::GetValue(int ValIndex) const
 
 void PESCounter::UpdateCounter(void)
 {
+  PE_WORK();
   count++;
   while (Now() >= intervalStop)
   {
@@ -209,6 +418,33 @@ void PESFrequency::Reset(void)
 } 
 
 
+// Nur die Objekte, die im Text-Report erscheinen (absolute Haeufigkeit != 0)
+void PESFrequency::Export(PEReportWriter& Out) const
+{
+  for (int k = 0; k < freq.NumUsed(); k++)
+  {
+    int i = freq.IdAt(k);
+
+    if (freq.GetAbsVal(i) != 0)
+    {
+      Out.Record(i, freq.GetAbsVal(i), PEObjectNames::Get(objectType, i));
+    }
+  }
+}
+
+
+// Alle bisher aufgetretenen Objekte, auch nach Reset (Wert 0)
+void PESFrequency::ExportAll(PEReportWriter& Out) const
+{
+  for (int k = 0; k < freq.NumUsed(); k++)
+  {
+    int i = freq.IdAt(k);
+
+    Out.Record(i, freq.GetAbsVal(i), PEObjectNames::Get(objectType, i));
+  }
+}
+
+
 double PESFrequency::GetValue(int Index) const
 {
   return freq.GetRelVal(Index);
@@ -223,6 +459,7 @@ const PDFrequency& PESFrequency::GetFrequency(void) const // wird von PCUpdater
     
 void PESFrequency::UpdateFreq(int i, double Diff)
 {
+  PE_WORK();
   freq.ChangeVal(i, Diff);
 }
 
@@ -234,18 +471,22 @@ void PESFrequency::Report(SCStream& Out) const
   Out.GetStream().setf(ios::fixed|ios::right, ios::adjustfield|ios::floatfield);
   Out.GetStream().precision(2);
 
-  for (int i = 0; i < freq.Num(); i++)
+  for (int k = 0; k < freq.NumUsed(); k++)
   {
+    int i = freq.IdAt(k);
+
     if (freq.GetAbsVal(i) != 0)
     {
-      if (strlen(SCType::GetObjectName(objectType, i)) > 12)
+      const char * name = PEObjectNames::Get(objectType, i);
+
+      if (strlen(name) > 12)
       {
-        Out.GetStream().write(SCType::GetObjectName(objectType, i), 12);
+        Out.GetStream().write(name, 12);
       }
       else
       {
-        Out << SCType::GetObjectName(objectType, i);
-        for (int j = 12 - strlen(SCType::GetObjectName(objectType, i)); j--;) Out.GetStream().put(' ');
+        Out << name;
+        for (int j = 12 - strlen(name); j--;) Out.GetStream().put(' ');
       }
       Out.GetStream() << " | "
 	                    << std::setw(6)
@@ -277,6 +518,7 @@ void PESQueue::Reset(void)
 
 void PESQueue::UpdateQLen(int QLenDiff)
 {
+  PE_WORK();
   lastUpdate = Now();
   qLen += QLenDiff;
 }
@@ -298,6 +540,12 @@ double PESQueueLength::GetValue(int ValIndex) const
   else                 return PESTally::GetValue(ValIndex);
 }
 
+void PESQueueLength::Export(PEReportWriter& Out) const
+{
+  PESTally::Export(Out);
+  Out.Record(cql, GetValue(cql));
+}
+
 void PESQueueLength::UpdateQLen(int QLenDiff)
 {
   UpdateTally(QLen(), Duration());
@@ -309,10 +557,9 @@ void PESQueueLength::UpdateQLen(int QLenDiff)
  PESQueueLengthFrequency: Implementierung
 \******************************************************************************/
 
-int PESQueueLengthFrequency::maxNumber = -1;
-
 PESQueueLengthFrequency::PESQueueLengthFrequency(void) :
-  PESFrequency (SC_NONE)
+  PESFrequency (SC_NONE),
+  maxNumber    (-1)
 {
 }
 
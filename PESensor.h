@@ -12,6 +12,8 @@
 #ifndef __PESENSOR_H
 #define __PESENSOR_H
 
+#include <stdlib.h>
+
 #include <SCL/SCStream.h>
 
 #include <SCL/SCMachine.h>
@@ -25,6 +27,11 @@
 #ifndef __PDDATATYPE_H
 #include "PDDataType.h"
 #endif
+#ifndef __PEEVENT_H
+#include "PEEvent.h"
+#endif
+
+class PEReportWriter;
 
 #include <SCL/SCList.h>
 #include <SCL/SCSensor.h>
@@ -37,21 +44,52 @@ class PESensor
 {
   public:
 
-    PESensor(void) {}
-    virtual ~PESensor(void) {}  // Spezialisierung erwartet => Virtueller Destruktor
+    PESensor(void) : sensorName(NULL) {}
+    virtual ~PESensor(void) {delete[] sensorName;} // Spezialisierung erwartet => Virtueller Destruktor
+
+    // Sensoren belegen ganze Cache-Zeilen: Bei der parallelen Wiedergabe
+    // werten verschiedene Threads nacheinander angelegte Sensoren aus
+    enum {cacheLine = 64};
+    static void * operator new(size_t Size);
+    static void   operator delete(void * Memory);
     
     virtual SCBoolean NotifyOnEvent(SCTraceAction Event) const = 0; // TRUE, falls Benachrichtigung erwnscht
     virtual void Reset() = 0;                            // Zurcksetzen des Sensors     
     virtual void Report(SCStream& Out) const = 0;  
     virtual double GetValue(int ValueIndex) const = 0;
+    virtual void Export(PEReportWriter& /* Out */) const {} // Werte einzeln (PEReportWriter::Record)
+
+    // Feste Spalten fuer Leser, die je Update nur Werte kopieren (PCShmUpdater):
+    // ExportAll meldet wie Export alle Werte, auch solche, die Export
+    // auslaesst (Wert 0); ExportValue liefert den Wert einer Spalte wie
+    // Export; ExportCount aendert sich, sobald Spalten hinzukommen.
+    virtual void      ExportAll(PEReportWriter& Out) const { Export(Out); }
+    virtual double    ExportValue(int ValIndex) const { return GetValue(ValIndex); }
+    virtual SCNatural ExportCount(void) const { return 0; }
+
+    // Name aus der Konfiguration (beim Anmelden gesetzt, "" falls keiner)
+    void SetName(const char * Name);
+    const char * GetName(void) const {return sensorName ? sensorName : "";}
     
     virtual const PDDataType * GetData(void) const { return NULL; };
 
-    SCTime Now() const {return SCScheduler::GetCurrentTime();} 
+    // Schluessel fuer die Ereignisverteilung (siehe PERouter): routeAll fuer
+    // alle Ereignisse der Aktion, NULL solange der Schluessel unbekannt ist,
+    // sonst der Prozesstyp bzw. die Maschine, deren Ereignisse interessieren
+    static const void * const routeAll;
+    virtual const void * RoutingKey(SCTraceAction /* Event */) const { return routeAll; }
+
+    // Zeitpunkt des gerade ausgewerteten Ereignisses. Wertet ein eigener
+    // Thread die Ereignisse aus oder wird eine Aufzeichnung wiedergegeben,
+    // wird die Uhr mit SetClock gesetzt.
+    static SCTime Now(void) {return clock >= 0.0 ? clock : SCScheduler::GetCurrentTime();}
+    static void SetClock(SCTime Time) {clock = Time;}
     
     // Fuer jede Aktion wird eine Ereignisfunktion bereitgestellt, die
     // defaultmaessig gar nichts tut. Abgeleitete Sensor-Klassen ueberschreiben
-    // die Ereignisse, die sie zur Ermittlung ihrer Daten bentigen
+    // die Ereignisse, die sie zur Ermittlung ihrer Daten bentigen. Die
+    // Daten des Ereignisses stehen in PEEvent (siehe PEEvent.h, zu den
+    // frueheren Signaturen siehe ObsoleteEvent)
     // ----------------------------------------------------------------------
     
     // Allgemeine Ereignisse
@@ -63,59 +101,92 @@ class PESensor
     
     // Prozessverwaltung
     // ----------------
-    virtual void EvProcessCreate(const SCProcess*   /* Process */, 
-                                 const SCProcess*   /* Creator */)      {}
-    virtual void EvProcessDelete(const SCProcess*   /* Process */)      {}
-    virtual void EvStateChange  (const SCProcess*   /* Process */,
-                                 const SCStateType* /* NewState */)     {} 
-    virtual void EvSpontTrans   (const SCProcess*   /* Process */) {}
-    virtual void EvContSignal   (const SCProcess*   /* Process */) {}
+    virtual void EvProcessCreate(const PEEvent & /* Event */) {}
+    virtual void EvProcessDelete(const PEEvent & /* Event */) {}
+    virtual void EvStateChange  (const PEEvent & /* Event */) {} 
+    virtual void EvSpontTrans   (const PEEvent & /* Event */) {}
+    virtual void EvContSignal   (const PEEvent & /* Event */) {}
 
     // Prozess-Botschaften/Signale
     // --------------------------
-    virtual void EvSignalSend    (const SCProcess*    /* Sender */,
-                                  const SCProcess*    /* Receiver */,
-                                  const SCSignal* /* Signal */) {}
-    virtual void EvSignalConsume (const SCProcess*    /* Process */,
-                                  const SCSignal* /* Signal */) {}
-    virtual void EvSignalSave    (const SCProcess*    /* Process */,
-                                  const SCSignal* /* Signal */) {}
-    virtual void EvSignalDrop    (const SCProcess*    /* Process */,
-                                  const SCSignal* /* Signal */) {}
-    virtual void EvSignalReject  (const SCProcess*    /* Process */,
-                                  const SCSignal* /* Signal */) {}
-    virtual void EvSignalReceive (const SCProcess*    /* Process */, 
-                                  const SCSignal* /* Signal */) {}
+    virtual void EvSignalSend    (const PEEvent & /* Event */) {}
+    virtual void EvSignalConsume (const PEEvent & /* Event */) {}
+    virtual void EvSignalSave    (const PEEvent & /* Event */) {}
+    virtual void EvSignalDrop    (const PEEvent & /* Event */) {}
+    virtual void EvSignalReject  (const PEEvent & /* Event */) {}
+    virtual void EvSignalReceive (const PEEvent & /* Event */) {}
 				 
     // Maschinen und Requests
     // ----------------------
-    virtual void EvMachineCreate   (const SCMachine*      /* machine */) {}
-    virtual void EvMachineDelete   (const SCMachine*      /* machine */) {}
-    virtual void EvServiceRequest  (const SCMachine*      /* machine */,
-                                    const SCRequest* /* request */) {}
-    virtual void EvServiceFinish   (const SCMachine*      /* machine */,
-                                    const SCRequest* /* request */) {}
-    virtual void EvServiceStart    (const SCMachine*      /* machine */,
-                                    const SCRequest* /* request */) {}
-    virtual void EvServiceInterrupt(const SCMachine*      /* machine */,
-                                    const SCRequest* /* request */) {}
+    virtual void EvMachineCreate   (const PEEvent & /* Event */) {}
+    virtual void EvMachineDelete   (const PEEvent & /* Event */) {}
+    virtual void EvServiceRequest  (const PEEvent & /* Event */) {}
+    virtual void EvServiceFinish   (const PEEvent & /* Event */) {}
+    virtual void EvServiceStart    (const PEEvent & /* Event */) {}
+    virtual void EvServiceInterrupt(const PEEvent & /* Event */) {}
 
     // Timer
     // -----
-    virtual void EvTimerSet   (const SCTimer* /* timer */)   {}
-    virtual void EvTimerReset (const SCTimer* /* timer */)   {}
-    virtual void EvTimerFire  (const SCTimer* /* timer */,
-                               const SCSignal* /* message */) {}
+    virtual void EvTimerSet   (const PEEvent & /* Event */) {}
+    virtual void EvTimerReset (const PEEvent & /* Event */) {}
+    virtual void EvTimerFire  (const PEEvent & /* Event */) {}
     
     friend SCStream& operator<< (SCStream& pStream,
                                  const PESensor& pData);
 
   protected:
     void Underline(SCStream& Out, int len) const; // kleine Hilfsfunktion fr Reports
+
+  private:
+    static __thread SCTime clock; // < 0: Uhr des Schedulers
+    char *                 sensorName;
+
+    PESensor(const PESensor &);   // nicht kopierbar (Name)
+
+    // Bis zur Umstellung auf PEEvent erhielten die Ereignisfunktionen die
+    // Objekte der SCL. Weiterleiten laesst sich dahin nicht: Im Pipeline-
+    // Modus und bei der Wiedergabe einer Aufzeichnung existieren diese
+    // Objekte nicht mehr. Damit Sensoren, die noch die alten Funktionen
+    // ueberschreiben, nicht stillschweigend leer bleiben, sind die alten
+    // Signaturen hier mit anderem Rueckgabetyp deklariert: Jede solche
+    // Ueberschreibung fuehrt zu einem Uebersetzungsfehler ("conflicting
+    // return type") und muss auf die PEEvent-Variante umgestellt werden.
+    struct ObsoleteEvent {};
+    virtual ObsoleteEvent EvProcessCreate(const SCProcess *, const SCProcess *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvProcessDelete(const SCProcess *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvStateChange(const SCProcess *, const SCStateType *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvSpontTrans(const SCProcess *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvContSignal(const SCProcess *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvSignalSend(const SCProcess *, const SCProcess *, const SCSignal *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvSignalConsume(const SCProcess *, const SCSignal *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvSignalSave(const SCProcess *, const SCSignal *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvSignalDrop(const SCProcess *, const SCSignal *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvSignalReject(const SCProcess *, const SCSignal *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvSignalReceive(const SCProcess *, const SCSignal *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvMachineCreate(const SCMachine *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvMachineDelete(const SCMachine *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvServiceRequest(const SCMachine *, const SCRequest *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvServiceFinish(const SCMachine *, const SCRequest *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvServiceStart(const SCMachine *, const SCRequest *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvServiceInterrupt(const SCMachine *, const SCRequest *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvTimerSet(const SCTimer *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvTimerReset(const SCTimer *) {return ObsoleteEvent();}
+    virtual ObsoleteEvent EvTimerFire(const SCTimer *, const SCSignal *) {return ObsoleteEvent();}
 };
 
 /******************************************************************************\
- PESTally: Statistische Auswertung 
+ PESTally: Statistische Auswertung. Mittelwert und Summe der Abweichungs-
+   quadrate werden nach Welford (gewichtet nach West) fortgeschrieben statt
+   aus Summe und Quadratsumme berechnet; so gibt es auch bei langen Laeufen
+   keine Ausloeschung. Merge vereinigt zwei Tallies exakt (Chan et al.), etwa
+   Teilergebnisse mehrerer Threads oder unabhaengiger Replikationen.
+     Fuer die Quantile (p50 ... p99) fuehrt der Tally ein Histogramm mit
+   logarithmisch gestuften Klassen (HDR): 64 Stufen je Zweierpotenz von 2^-24
+   bis 2^40, d.h. hoechstens 0,8% relativer Fehler bei konstantem Speicher
+   (32 KB, erst mit der ersten Stichprobe angelegt). Die Klasse ergibt sich
+   direkt aus dem Bitmuster der Stichprobe. Alle vier Quantile entstehen in
+   einem Durchlauf durch das Histogramm und bleiben gespeichert, bis sich
+   die Anzahl der Stichproben aendert (Export bei jedem Update).
 \******************************************************************************/ 
 
 class PESTally: virtual public PESensor
@@ -123,6 +194,7 @@ class PESTally: virtual public PESensor
   public:
 
     PESTally(SCDuration IntervalLength = 1.0);
+    ~PESTally(void);
     
     enum { // Indices fr GetValue zum Auslesen statistischer Informationen
       num, // Anzahl der Stichproben 
@@ -132,27 +204,49 @@ class PESTally: virtual public PESensor
       avi, // Durchsnitt im letzten Interval
       var, // Varianz
       dev, // Standardabweichung
+      p50, // Median
+      p90, // 90%-Quantil
+      p95, // 95%-Quantil
+      p99, // 99%-Quantil
       __T  // Ende Kennzeichen fr Tally
     };
     double GetValue(int ValIndex) const;
   
     void Reset(void);
     void Report(SCStream& Out) const;
+    void Export(PEReportWriter& Out) const;
+    void Merge(const PESTally& Other); // Stichproben von Other hinzunehmen
 
   protected:  
     void UpdateTally(double Sample, double Weight = 1.0);
     
   private:  
     double      numS;  // Anzahl Stichproben (Summe der Gewichte)
-    long double sumS;  // Summe aller Stichproben
-    long double sumS2; // Summe aller Stichprobenquadrate
+    double      meanS; // gewichteter Mittelwert
+    double      m2S;   // gewichtete Summe der Abweichungsquadrate
     double      minS;  // Minimum aller Stichproben
     double      maxS;  // Maximum
+    double *    histogram;      // Gewichte je Klasse (NULL: noch leer)
     double      intervalAvg;    // Mittelwert im letzten Intervall
     double      intervalNum;    // Summe Gewichte im laufenden Intervall
     double      intervalSum; // Aktueller Mittelwert im laufenden Intervall
     SCDuration  intervalLen;
     SCTime      intervalStop;
+
+    enum
+    {
+      subBits    = 6,                  // 2^subBits Klassen je Zweierpotenz
+      minExp     = -24,                // kleinste Klasse ab 2^minExp
+      numBuckets = 64 << subBits       // Klasse 0: Werte <= 2^minExp
+    };
+    enum {numQuantiles = p99 - p50 + 1};
+    mutable double quantiles[numQuantiles]; // Mitte der Klasse, unbegrenzt
+    mutable double quantileNum;             // numS dazu (< 0: ungueltig)
+
+    double        Quantile(int Index) const; // p50 ... p99 ab 0
+    void          Quantiles(void) const;
+    static int    Bucket(double Sample);
+    static double BucketValue(int Bucket);  // Mitte der Klasse
 };
 
 /******************************************************************************\
@@ -174,6 +268,7 @@ class PESCounter: virtual public PESensor
   
     void Reset();
     void Report(SCStream& Out) const;
+    void Export(PEReportWriter& Out) const;
 
   protected:
     void UpdateCounter(); // Erhoeht Counter um eins
@@ -199,6 +294,10 @@ class PESFrequency: virtual  public PESensor
     
     void   Reset(void);
     void   Report(SCStream& Out) const;
+    void   Export(PEReportWriter& Out) const;
+    void   ExportAll(PEReportWriter& Out) const;
+    double ExportValue(int Index) const { return freq.GetAbsVal(Index); }
+    SCNatural ExportCount(void) const { return freq.NumUsed(); }
     double GetValue(int Index) const;
     const  PDFrequency& GetFrequency() const;
     
@@ -251,6 +350,7 @@ class PESQueueLength: public PESTally, protected virtual PESQueue
       _QL                     // Ende Kennzeichen fuer QueueLength
     };	
     double GetValue(int ValIndex) const;
+    void   Export(PEReportWriter& Out) const;
     
     void Reset();
     
@@ -275,7 +375,7 @@ class PESQueueLengthFrequency: public PESFrequency,
     void UpdateQLen(int QLenDiff);
     
   private:
-    static int         maxNumber;
+    int                maxNumber;   // je Sensor (parallele Wiedergabe)
 };
 
 #endif
@@ -0,0 +1,124 @@
+/******************************************************************************\
+ Datei : PESeries.cpp
+ Inhalt: Auslesen einer Zeitreihendatei (pevseries): ohne Zeitbereich werden
+         die Spalten, die Anzahl der Zeilen und der Zeitbereich ausgegeben,
+         sonst die Zeilen im Zeitbereich (durch Tabulatoren getrennt).
+ Status:
+\******************************************************************************/
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "PESeriesFile.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+static void Usage(void)
+{
+  std::cerr <<
+    "Usage: pevseries [options] file\n"
+    "  -f time        first simulation time            (start of file)\n"
+    "  -t time        last simulation time             (end of file)\n"
+    "  -c column      print only this column (repeatable)\n";
+  exit(1);
+}
+
+
+static void Describe(const PESeriesReader & Series)
+{
+  SCNatural i;
+
+  printf("%lu columns, %lu rows", Series.NumColumns(), Series.NumRows());
+  if (Series.NumRows())
+  {
+    printf(", time %.10g .. %.10g", Series.Time(0),
+           Series.Time(Series.NumRows() - 1));
+  }
+  printf("\n");
+  for (i = 0; i < Series.NumColumns(); i++)
+  {
+    printf("  %s\n", Series.ColumnName(i));
+  }
+}
+
+
+int main(int argc, char ** argv)
+{
+  SCTime        from = -1.0, to = -1.0;
+  const char ** names = new const char *[argc];
+  SCNatural *   select;
+  SCNatural     numSelect = 0;
+  SCNatural     row, i;
+  int           option, column;
+
+  while ((option = getopt(argc, argv, "f:t:c:")) != -1)
+  {
+    switch (option)
+    {
+      case 'f': from = atof(optarg); break;
+      case 't': to = atof(optarg); break;
+      case 'c':
+        names[numSelect++] = optarg;
+        break;
+      default: Usage();
+    }
+  }
+  if (optind != argc - 1)
+  {
+    Usage();
+  }
+
+  PESeriesReader series(argv[optind]);
+
+  if (from < 0.0 && to < 0.0 && !numSelect)
+  {
+    Describe(series);
+    delete[] names;
+    return 0;
+  }
+
+  select = new SCNatural[numSelect ? numSelect : series.NumColumns()];
+  for (i = 0; i < numSelect; i++)
+  {
+    if ((column = series.FindColumn(names[i])) < 0)
+    {
+      std::cerr << "Cannot find column " << names[i] << "!\n";
+      exit(1);
+    }
+    select[i] = column;
+  }
+  if (!numSelect)
+  {
+    for (; numSelect < series.NumColumns(); numSelect++)
+    {
+      select[numSelect] = numSelect;
+    }
+  }
+
+  printf("time");
+  for (i = 0; i < numSelect; i++)
+  {
+    printf("\t%s", series.ColumnName(select[i]));
+  }
+  printf("\n");
+
+  for (row = from < 0.0 ? 0 : series.FindRow(from);
+       row < series.NumRows() && (to < 0.0 || series.Time(row) <= to);
+       row++)
+  {
+    printf("%.10g", series.Time(row));
+    for (i = 0; i < numSelect; i++)
+    {
+      printf("\t%.10g", series.Value(row, select[i]));
+    }
+    printf("\n");
+  }
+
+  delete[] select;
+  delete[] names;
+  return 0;
+}
@@ -0,0 +1,344 @@
+/******************************************************************************\
+ Datei : PESeriesFile.cpp
+ Inhalt: Implementierung der Zeitreihendatei fuer angezeigte Sensorwerte
+ Status:
+\******************************************************************************/
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <iostream>
+
+#include "PESeriesFile.h"
+#include "PESensor.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+const char PESeriesFile::magic[8] = {'P', 'E', 'V', 'S', 'E', 'R', 'I', 'E'};
+
+
+/******************************************************************************\
+ PESeriesWriter: Implementierung
+\******************************************************************************/
+
+PESeriesWriter::PESeriesWriter(const char * FileName) :
+  fd           (-1),
+  numColumns   (0),
+  maxColumns   (8),
+  rowsPerBlock (0),
+  headerSize   (0),
+  alignment    (0),
+  block        (NULL),
+  numBlocks    (0),
+  numRows      (0)
+{
+  fileName = new char[strlen(FileName) + 1];
+  strcpy(fileName, FileName);
+  columns = new PEColumn[maxColumns];
+}
+
+
+PESeriesWriter::~PESeriesWriter(void)
+{
+  SCNatural i;
+
+  if (fd >= 0)
+  {
+    UnmapBlock();
+    WriteRowCount();
+    close(fd);
+  }
+  for (i = 0; i < numColumns; i++)
+  {
+    delete[] columns[i].name;
+  }
+  delete[] columns;
+  delete[] fileName;
+}
+
+
+SCBoolean PESeriesWriter::AddColumn(const PESensor * Sensor, int ValIndex,
+                                    const char * Name)
+{
+  PEColumn * column;
+  SCNatural  i;
+
+  assert(fd < 0);              // Spalten nur vor dem ersten Sample
+
+  for (i = 0; i < numColumns; i++)
+  {
+    if (columns[i].sensor == Sensor && columns[i].valIndex == ValIndex)
+      return false;            // mehrere Kurven zeigen denselben Wert
+  }
+
+  if (numColumns == maxColumns)
+  {
+    column = new PEColumn[maxColumns * 2];
+    memcpy(column, columns, numColumns * sizeof(PEColumn));
+    delete[] columns;
+    columns = column;
+    maxColumns *= 2;
+  }
+  column = &columns[numColumns++];
+  column->sensor = Sensor;
+  column->valIndex = ValIndex;
+  column->name = new char[strlen(Name) + 1];
+  strcpy(column->name, Name);
+
+  return true;
+}
+
+
+void PESeriesWriter::Open(void)
+{
+  PEHeader  header;
+  char *    buffer;
+  char *    cur;
+  SCNatural i;
+  SCNatural pageRows;           // Werte je Seite
+
+  // Zeilen je Block: Vielfaches der Werte je Seite, damit jeder Block
+  // ganze Seiten belegt und einzeln eingeblendet werden kann
+  alignment = sysconf(_SC_PAGESIZE);
+  pageRows = alignment / sizeof(double);
+  rowsPerBlock = blockSize / ((numColumns + 1) * sizeof(double));
+  rowsPerBlock -= rowsPerBlock % pageRows;
+  if (rowsPerBlock < pageRows) rowsPerBlock = pageRows;
+
+  headerSize = sizeof(PEHeader);
+  for (i = 0; i < numColumns; i++)
+  {
+    headerSize += strlen(columns[i].name) + 1;
+  }
+  headerSize = (headerSize + alignment - 1) / alignment * alignment;
+
+  if ((fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+  {
+    std::cerr << "Cannot open series file " << fileName << "!\n";
+    abort();
+  }
+
+  buffer = new char[headerSize];
+  memset(buffer, 0, headerSize);
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.numColumns = numColumns;
+  header.rowsPerBlock = rowsPerBlock;
+  header.headerSize = headerSize;
+  header.alignment = alignment;
+  header.numRows = 0;
+  memcpy(buffer, &header, sizeof(header));
+  cur = buffer + sizeof(header);
+  for (i = 0; i < numColumns; i++)
+  {
+    strcpy(cur, columns[i].name);
+    cur += strlen(cur) + 1;
+  }
+  if (pwrite(fd, buffer, headerSize, 0) != (ssize_t)headerSize)
+  {
+    std::cerr << "Cannot write series file " << fileName << "!\n";
+    abort();
+  }
+  delete[] buffer;
+}
+
+
+void PESeriesWriter::MapBlock(void)
+{
+  off_t length = (off_t)rowsPerBlock * (numColumns + 1) * sizeof(double);
+  off_t offset = headerSize + numBlocks * length;
+
+  if (ftruncate(fd, offset + length) < 0)
+  {
+    std::cerr << "Cannot extend series file " << fileName << "!\n";
+    abort();
+  }
+  block = (double *)mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd, offset);
+  if (block == (double *)MAP_FAILED)
+  {
+    std::cerr << "Cannot map series file " << fileName << "!\n";
+    abort();
+  }
+  numBlocks++;
+}
+
+
+void PESeriesWriter::UnmapBlock(void)
+{
+  if (!block) return;
+
+  munmap(block, rowsPerBlock * (numColumns + 1) * sizeof(double));
+  block = NULL;
+}
+
+
+// Die Zeilenzahl steht im Kopf; ein Leser sieht nur die bis hierher
+// vollstaendig geschriebenen Zeilen.
+void PESeriesWriter::WriteRowCount(void)
+{
+  if (pwrite(fd, &numRows, sizeof(numRows),
+             offsetof(PEHeader, numRows)) != sizeof(numRows))
+  {
+    std::cerr << "Cannot write series file " << fileName << "!\n";
+    abort();
+  }
+}
+
+
+void PESeriesWriter::Sample(SCTime Now)
+{
+  SCNatural row, i;
+  double *  value;
+
+  if (!numColumns) return;
+
+  if (fd < 0) Open();
+  if (!block) MapBlock();
+
+  row = numRows % rowsPerBlock;
+  block[row] = Now;
+  value = block + rowsPerBlock + row;
+  for (i = 0; i < numColumns; i++, value += rowsPerBlock)
+  {
+    *value = columns[i].sensor->GetValue(columns[i].valIndex);
+  }
+  numRows++;
+
+  if (row == rowsPerBlock - 1) // Block voll
+  {
+    UnmapBlock();
+    WriteRowCount();
+  }
+}
+
+
+void PESeriesWriter::Flush(void)
+{
+  if (fd < 0) return;
+
+  if (block)
+  {
+    msync(block, rowsPerBlock * (numColumns + 1) * sizeof(double), MS_ASYNC);
+  }
+  WriteRowCount();
+}
+
+
+/******************************************************************************\
+ PESeriesReader: Implementierung
+\******************************************************************************/
+
+PESeriesReader::PESeriesReader(const char * FileName) :
+  names (NULL)
+{
+  struct stat      status;
+  int              fd;
+  PEHeader         header;
+  const char *     cur;
+  const char *     end;
+  unsigned long    blockLength;
+  SCNatural        i;
+
+  if ((fd = open(FileName, O_RDONLY)) < 0 || fstat(fd, &status) < 0)
+  {
+    std::cerr << "Cannot open series file " << FileName << "!\n";
+    abort();
+  }
+  length = status.st_size;
+  if (length < sizeof(header))
+  {
+    Corrupt();
+  }
+  base = (const char *)mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == (const char *)MAP_FAILED)
+  {
+    std::cerr << "Cannot map series file " << FileName << "!\n";
+    abort();
+  }
+
+  memcpy(&header, base, sizeof(header));
+  if (memcmp(header.magic, magic, sizeof(magic)) ||
+      header.version != version ||
+      header.rowsPerBlock == 0 ||
+      header.alignment == 0 ||
+      header.headerSize % header.alignment ||
+      header.headerSize < sizeof(header) ||
+      header.headerSize > length)
+  {
+    Corrupt();
+  }
+  numColumns = header.numColumns;
+  numRows = header.numRows;
+  rowsPerBlock = header.rowsPerBlock;
+  headerSize = header.headerSize;
+
+  blockLength = (unsigned long)rowsPerBlock * (numColumns + 1) * sizeof(double);
+  if (headerSize + (numRows + rowsPerBlock - 1) / rowsPerBlock * blockLength >
+      length)
+  {
+    Corrupt();
+  }
+
+  names = new const char *[numColumns];
+  cur = base + sizeof(header);
+  end = base + headerSize;
+  for (i = 0; i < numColumns; i++)
+  {
+    names[i] = cur;
+    cur = (const char *)memchr(cur, '\0', end - cur);
+    if (!cur) Corrupt();
+    cur++;
+  }
+}
+
+
+PESeriesReader::~PESeriesReader(void)
+{
+  munmap((void *)base, length);
+  delete[] names;
+}
+
+
+int PESeriesReader::FindColumn(const char * Name) const
+{
+  SCNatural i;
+
+  for (i = 0; i < numColumns; i++)
+  {
+    if (!strcmp(names[i], Name)) return i;
+  }
+  return -1;
+}
+
+
+SCNatural PESeriesReader::FindRow(SCTime Time) const
+{
+  SCNatural low = 0, high = numRows, mid;
+
+  while (low < high)
+  {
+    mid = low + (high - low) / 2;
+    if (this->Time(mid) < Time)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low;
+}
+
+
+void PESeriesReader::Corrupt(void) const
+{
+  std::cerr << "Corrupt series file!\n";
+  abort();
+}
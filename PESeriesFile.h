@@ -0,0 +1,133 @@
+/******************************************************************************\
+ Datei : PESeriesFile.h
+ Inhalt: Deklaration der Zeitreihendatei fuer angezeigte Sensorwerte
+         (PESeriesWriter, PESeriesReader)
+ Status:
+\******************************************************************************/
+
+#ifndef __PESERIESFILE_H
+#define __PESERIESFILE_H
+
+#include <SCL/SCBasicTypes.h>
+
+class PESensor;
+
+/******************************************************************************\
+ Format der Zeitreihendatei: Der Kopf (Kennung "PEVSERIE", Version, Anzahl
+   Spalten, Zeilen je Block, Ausrichtung, Anzahl Zeilen, Spaltennamen) belegt
+   ganze Seiten. Es folgen Bloecke mit je rowsPerBlock Zeilen, spaltenweise
+   abgelegt: erst die Zeiten, dann die Werte jeder Spalte (alle als double).
+   Der letzte Block ist nur bis zur Anzahl der Zeilen aus dem Kopf gueltig.
+     Die Seitengroesse des schreibenden Systems (sysconf) steht als
+   Ausrichtung im Kopf; Kopf und Bloecke sind Vielfache davon.
+\******************************************************************************/
+
+class PESeriesFile
+{
+  public:
+    enum
+    {
+      version   = 2,
+      blockSize = 1 << 20           // angestrebte Bytes je Block
+    };
+
+    struct PEHeader
+    {
+      char               magic[8];
+      unsigned int       version;
+      unsigned int       numColumns;
+      unsigned int       rowsPerBlock;
+      unsigned int       headerSize; // Bytes, Vielfaches von alignment
+      unsigned int       alignment;  // Seitengroesse beim Schreiben
+      unsigned int       reserved;   // 0
+      unsigned long long numRows;
+      // es folgen numColumns Namen, jeweils mit '\0' abgeschlossen
+    };
+
+    static const char magic[8];
+};
+
+/******************************************************************************\
+ PESeriesWriter: Schreibt bei jedem Update die Werte aller Spalten (je Paar
+   aus Sensor und Wertindex einer Kurve) als eine Zeile. Die Spalten werden
+   vor dem ersten Sample angemeldet; die Datei wird beim ersten Sample
+   angelegt. Geschrieben wird in einen eingeblendeten Block (mmap), der beim
+   Wechsel zum naechsten Block freigegeben wird; der Kopf wird dabei und bei
+   Flush aktualisiert.
+\******************************************************************************/
+
+class PESeriesWriter: public PESeriesFile
+{
+  public:
+    PESeriesWriter(const char * FileName);
+    ~PESeriesWriter(void);
+
+    SCBoolean AddColumn(const PESensor * Sensor, int ValIndex,
+                        const char * Name);     // false: schon vorhanden
+    void      Sample(SCTime Now);
+    void      Flush(void);
+
+  private:
+    struct PEColumn
+    {
+      const PESensor * sensor;
+      int              valIndex;
+      char *           name;
+    };
+
+    char *             fileName;
+    int                fd;
+    PEColumn *         columns;
+    SCNatural          numColumns;
+    SCNatural          maxColumns;
+    SCNatural          rowsPerBlock;
+    SCNatural          headerSize;
+    SCNatural          alignment;    // Seitengroesse
+    double *           block;        // eingeblendeter Block oder NULL
+    unsigned long long numBlocks;    // angelegte Bloecke
+    unsigned long long numRows;
+
+    void Open(void);
+    void MapBlock(void);
+    void UnmapBlock(void);
+    void WriteRowCount(void);
+};
+
+/******************************************************************************\
+ PESeriesReader: Liest eine Zeitreihendatei (mmap). FindRow liefert die erste
+   Zeile mit einer Zeit >= Time (binaere Suche, die Zeiten sind steigend).
+\******************************************************************************/
+
+class PESeriesReader: public PESeriesFile
+{
+  public:
+    PESeriesReader(const char * FileName);
+    ~PESeriesReader(void);
+
+    SCNatural    NumColumns(void) const { return numColumns; }
+    SCNatural    NumRows(void) const    { return numRows; }
+    const char * ColumnName(SCNatural Column) const { return names[Column]; }
+    int          FindColumn(const char * Name) const; // -1: unbekannt
+    SCNatural    FindRow(SCTime Time) const;
+
+    SCTime Time(SCNatural Row) const
+      { return Block(Row)[Row % rowsPerBlock]; }
+    double Value(SCNatural Row, SCNatural Column) const
+      { return Block(Row)[(Column + 1) * rowsPerBlock + Row % rowsPerBlock]; }
+
+  private:
+    const char *       base;
+    unsigned long      length;
+    SCNatural          numColumns;
+    SCNatural          numRows;
+    SCNatural          rowsPerBlock;
+    SCNatural          headerSize;
+    const char **      names;
+
+    const double * Block(SCNatural Row) const
+      { return (const double *)(base + headerSize + (Row / rowsPerBlock) *
+                                (numColumns + 1) * rowsPerBlock * sizeof(double)); }
+    void Corrupt(void) const;
+};
+
+#endif
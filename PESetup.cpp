@@ -11,8 +11,10 @@
 \******************************************************************************/   
 
 #include "PEEventDispatcher.h"
+#ifndef _PEV_HEADLESS
 #include "PCController.h"
 #include "PVDataDisplay.h"
+#endif
 #include "PESMachine.h"
 #include "PESProcess.h"
 #include "PESActivity.h"
@@ -53,13 +55,43 @@ static const char * SensorTypeNames[numSensorTypes + 1] =
 };
 
 
+static const char * ReportFormatNames[PEReportWriter::numFormats + 1] =
+{
+  "Text", "CSV", "JSONLines", "Binary",
+  "" // Leerer String als Ende Kennzeichen
+};
+
+
+static const char * PlotFormatNames[PVPlotImage::numFormats + 1] =
+{
+  "PPM", "PNG", "SVG",
+  "" // Leerer String als Ende Kennzeichen
+};
+
+
 static const char * DisplayTypeNames[numDisplayTypes + 1] = 
 {
   "Curves", "FixedCurves", "Gantt", "Freqs",
+  "RunCurves", "FixedRunCurves",
   "" // Leerer String als Ende Kennzeichen
 };
 
 
+// Spaltenname fuer die Zeitreihendatei, z.B. "Queue.avg", "Server.state"
+static void SeriesColumnName(char *           Name,
+                             const SensorDef& Sensor,
+                             int              DispType,
+                             int              ValIndex)
+{
+  if (DispType == dGantt)
+    sprintf(Name, "%s.state", Sensor.name);
+  else if (IsFreqSensor(Sensor.type))
+    sprintf(Name, "%s.%d", Sensor.name, ValIndex);
+  else
+    sprintf(Name, "%s.%s", Sensor.name, ValIndexTypeName(ValIndex));
+}
+
+
 SCBoolean IsDiscreteValIndex(long ValIndexType)
 {
   static const long IsDiscrete = (1 << vNum) |
@@ -225,6 +257,8 @@ void InstantiateSensor(SensorDef &                 Sensor,
   }
 }
 
+#ifndef _PEV_HEADLESS
+
 PVFrameDisplay* InstantiateFrame(Display*                    Dpy,
                                  int                         DispType,
                                  const char *                Name,
@@ -240,6 +274,12 @@ PVFrameDisplay* InstantiateFrame(Display*                    Dpy,
     case dFixedCurves:
       return new PVCurvesFrame(Dpy, Name, Adaption, true);
       
+    case dRunCurves: 
+      return new PVCurvesFrame(Dpy, Name, Adaption, false, true);
+    
+    case dFixedRunCurves:
+      return new PVCurvesFrame(Dpy, Name, Adaption, true, true);
+      
     case dGantt:
       return new PVGanttFrame(Dpy, Name, Adaption);
 	
@@ -269,12 +309,16 @@ PVFrameDisplay* InstantiateFrame(Display*                    Dpy,
   }
 }
 
+#endif
+
 PDDataType* InstantiateDataType(PEEventDispatcher* dispatcher,
                                 int                DispType,
                                 PESensor *         Sensor,
                                 int                ValIndex,
                                 int                Points,
-                                const long         color)
+                                PDCurveStore *     Store,
+                                const long         color,
+                                const char *       Name)
 {
   PDDataType* Data;
   
@@ -284,9 +328,11 @@ PDDataType* InstantiateDataType(PEEventDispatcher* dispatcher,
     static const int GS = PESStateFrequency::ganttState;
     Data = DCurve = new PDDiscreteCurve(Points, color);
 
-    dispatcher->RegisterUpdater(new PCCurveUpdater(DCurve, Sensor, GS)); 
+    dispatcher->RegisterUpdater(new PCCurveUpdater(DCurve, Sensor, GS),
+                                Name);
   }  
-  else if (DispType == dCurves || DispType == dFixedCurves)
+  else if (DispType == dCurves || DispType == dFixedCurves ||
+           DispType == dRunCurves || DispType == dFixedRunCurves)
   { 
     PDCurve* Curve;
 
@@ -294,13 +340,18 @@ PDDataType* InstantiateDataType(PEEventDispatcher* dispatcher,
     {
       Curve = new PDDiscreteCurve(Points, color);
     }
+    else if (Store)
+    {
+      Curve = new PDCurve(Store, color); // Spalte des Rahmens
+    }
     else
     {
       Curve = new PDCurve(Points, color);
     }
     Data = Curve;
 
-    dispatcher->RegisterUpdater(new PCCurveUpdater(Curve, Sensor, ValIndex));
+    dispatcher->RegisterUpdater(new PCCurveUpdater(Curve, Sensor, ValIndex),
+                                Name);
   }
   else
   {
@@ -309,11 +360,12 @@ PDDataType* InstantiateDataType(PEEventDispatcher* dispatcher,
     Data = Freq = (PDFrequency *)Sensor->GetData();
     Freq->SetColor(color);
 
-    dispatcher->RegisterUpdater(new PCFreqUpdater(Freq, Sensor));
+    dispatcher->RegisterUpdater(new PCFreqUpdater(Freq, Sensor), Name);
   }
   return Data;
 }
 
+#ifndef _PEV_HEADLESS
 
 void ConnectFrameWithData(int                  DispType, 
                           PVFrameDisplay *     Frame,
@@ -324,6 +376,8 @@ void ConnectFrameWithData(int                  DispType,
   {
     case dCurves:
     case dFixedCurves:
+    case dRunCurves:
+    case dFixedRunCurves:
       ((PVCurvesFrame*)Frame)->AddDataType((PDCurve*)Data);
       break;
     case dGantt:
@@ -336,6 +390,85 @@ void ConnectFrameWithData(int                  DispType,
   }
 }
 
+#endif
+
+// Gegenstueck zu InstantiateFrame fuer die Ausgabe als Bild
+PVPlot* InstantiatePlot(int                         DispType,
+                        const char *                Name,
+                        int                         Adaption,
+                        const SensorDef&            FirstSensor)
+{
+  switch (DispType)
+  {
+    case dCurves: 
+      return new PVPlot(Name, PVPlot::curves, Adaption);
+    
+    case dFixedCurves:
+      return new PVPlot(Name, PVPlot::curves, Adaption, true);
+      
+    case dRunCurves: 
+      return new PVPlot(Name, PVPlot::curves, Adaption, false, true);
+    
+    case dFixedRunCurves:
+      return new PVPlot(Name, PVPlot::curves, Adaption, true, true);
+      
+    case dGantt:
+      return new PVPlot(Name, PVPlot::gantt, Adaption);
+	
+    case dFreqs: 
+      
+      switch(FirstSensor.type)
+      {
+        case sProcStateFreq: 
+          return new PVPlot(Name, PVPlot::freqs, Adaption, false, false,
+                            SC_STATE);
+	  
+        case sProcInSigFreq:
+        case sProcOutSigFreq:
+        case sGlobalSigFreq:
+          return new PVPlot(Name, PVPlot::freqs, Adaption, false, false,
+                            SC_SIGNAL);
+ 
+        case sProcOutReqFreq:
+        case sMachInReqFreq:
+        case sGlobalReqFreq:
+          return new PVPlot(Name, PVPlot::freqs, Adaption, false, false,
+                            SC_REQUEST);
+ 
+        case sProcQLenFreq:
+        case sMachQLenFreq:
+          return new PVPlot(Name, PVPlot::freqs, Adaption);
+      }
+ 
+    default: std::cout << "Internal Error while creation Plot\n"; abort();
+  }
+}
+
+
+void ConnectPlotWithData(int                  DispType, 
+                         PVPlot *             Plot,
+                         PDDataType *         Data,
+                         unsigned long        RGB,
+                         const PDStateTable * StateTable)
+{
+  switch (DispType)
+  {
+    case dCurves:
+    case dFixedCurves:
+    case dRunCurves:
+    case dFixedRunCurves:
+      Plot->AddCurve((PDCurve*)Data, RGB);
+      break;
+    case dGantt:
+      Plot->AddCurve((PDCurve*)Data, RGB);
+      Plot->AddStateTable(StateTable);
+      break;
+    default:
+      Plot->AddFrequency((PDFrequency*)Data, RGB);
+      break;
+  }
+}
+
 // Einleseroutine
 // --------------
 
@@ -346,6 +479,7 @@ void PEEventDispatcher::Setup(const char * Configuration,
   DataTypeTable DataTypeInstances;
   Scanner       Scan(Configuration);
   int           Points;
+  int           HistoryTiers = 16;
   int           Adaption;
   SCDuration    DefaultInterval;
 
@@ -354,11 +488,13 @@ void PEEventDispatcher::Setup(const char * Configuration,
   char Buffer[128];
   
   Scan.GetKeyString("Experiment", experiment);  
+#ifndef _PEV_HEADLESS
   {
     PCController* t = new PCController(this, xEventDispatcher, experiment);
-    RegisterSensor(t);
+    RegisterSensor(t, "Controller");
     xEventDispatcher.AddDisplay(t);
   }
+#endif
   
   Scan.GetKeyString("Specification", Buffer);
   if (strcmp(Buffer, Specification)) Scan.Error("Wrong specification error");
@@ -366,7 +502,6 @@ void PEEventDispatcher::Setup(const char * Configuration,
   Scan.GetKeyWord(Buffer); 
   if (strcmp(Buffer, "Report")) Scan.Error("Keyword 'Report' expected");
   Scan.GetChar(':', "after 'Report'"); Scan.GetString(Buffer);
-  OpenReport(Buffer);
   if (Scan.CheckChar(','))
   {
     double Interval;
@@ -375,14 +510,144 @@ void PEEventDispatcher::Setup(const char * Configuration,
     SetReportInterval(Interval);
   }
   Scan.GetChar(';', "");
+
+  // Optional: Format des Reports (Voreinstellung Text), evtl. mit
+  // Warteschlange fuer asynchrones Schreiben (beim Text nur das Schreiben,
+  // formatiert wird im Simulator-Thread)
+  // ----------------------------------------------------------------------
+  if (Scan.CheckKeyWord("ReportFormat"))
+  {
+    char Format[128];
+    int  FormatIndex;
+    int  QueueSize = 0;
+
+    Scan.GetKeyWord(Format);
+    Scan.GetChar(':', "after 'ReportFormat'");
+    if (!Scan.GetKeyWordIndex(ReportFormatNames, FormatIndex))
+      Scan.Error("Unknown report format");
+    if (Scan.CheckChar(','))
+    {
+      Scan.GetChar(',', "before report queue size");
+      Scan.GetInt(QueueSize);
+      if (QueueSize < 0 || QueueSize > 1024) Scan.Error("Range error");
+    }
+    Scan.GetChar(';', "");
+    OpenReport(Buffer, FormatIndex, QueueSize);
+  }
+  else
+  {
+    OpenReport(Buffer);
+  }
   
   Scan.GetKeyInt("CurvePoints", Points);
   if (Points < 8 || Points > 256) Scan.Error("Range error");
+
+  // Optional: Stufen des gesamten Verlaufs fuer RunCurves-Displays
+  // ---------------------------------------------------------------
+  if (Scan.CheckKeyWord("CurveHistory"))
+  {
+    Scan.GetKeyInt("CurveHistory", HistoryTiers);
+    if (HistoryTiers < 1 || HistoryTiers > 32) Scan.Error("Range error");
+  }
   
   Scan.GetKeyInt("ScaleAdaption", Adaption);
   if (Adaption < 5 || Adaption > 50) Scan.Error("Range error");
 
   Scan.GetKeyDbl("DefaultInterval", DefaultInterval);
+
+  // Optional: Auswertung der Sensoren in eigenem Thread (Voreinstellung:
+  // im Simulator-Thread, siehe PEEventDispatcher.h)
+  // ---------------------------------------------------------------------
+  if (Scan.CheckKeyWord("Pipeline"))
+  {
+    int QueueSize;
+
+    Scan.GetKeyInt("Pipeline", QueueSize);
+    if (QueueSize < 0 || QueueSize > (1 << 24)) Scan.Error("Range error");
+    SetPipelineMode(QueueSize);
+  }
+
+  // Optional: Aufzeichnung aller Ereignisse fuer eine spaetere Wiedergabe
+  // ---------------------------------------------------------------------
+  if (Scan.CheckKeyWord("Record"))
+  {
+    Scan.GetKeyString("Record", Buffer);
+    SetRecordMode(Buffer);
+  }
+
+  // Optional: Messung des Eigenaufwands, evtl. mit Ausgabe in eine Datei
+  // --------------------------------------------------------------------
+  if (Scan.CheckKeyWord("Instrument"))
+  {
+    Scan.GetKeyWord(Buffer);
+    if (Scan.CheckChar(':'))
+    {
+      Scan.GetChar(':', "after 'Instrument'");
+      Scan.GetString(Buffer);
+      SetInstrumentMode(true, Buffer);
+    }
+    else
+    {
+      SetInstrumentMode(true);
+    }
+    Scan.GetChar(';', "");
+  }
+
+  // Optional: Speichern aller angezeigten Sensorwerte (Zeitreihendatei)
+  // -------------------------------------------------------------------
+  if (Scan.CheckKeyWord("Series"))
+  {
+    Scan.GetKeyString("Series", Buffer);
+    SetSeriesMode(Buffer);
+  }
+
+  // Optional: aktuelle Werte am Unix-Socket (OpenMetrics)
+  // -----------------------------------------------------
+  if (Scan.CheckKeyWord("Metrics"))
+  {
+    Scan.GetKeyString("Metrics", Buffer);
+    SetMetricsMode(Buffer);
+  }
+
+  // Optional: aktuelle Werte im Shared Memory (PCShmUpdater)
+  // --------------------------------------------------------
+  if (Scan.CheckKeyWord("SharedMemory"))
+  {
+    Scan.GetKeyString("SharedMemory", Buffer);
+    RegisterUpdater(new PCShmUpdater(Buffer, registeredSensors), "SharedMemory");
+  }
+
+  // Optional: Displays bei jedem Report als Bilder ausgeben (PVPlotter)
+  // -------------------------------------------------------------------
+  if (Scan.CheckKeyWord("Plot"))
+  {
+    int FormatIndex = PVPlotImage::defaultFormat;
+    int Width = 640;
+    int Height = 400;
+
+    Scan.GetKeyWord(Buffer);
+    Scan.GetChar(':', "after 'Plot'");
+    Scan.GetString(Buffer);
+    if (Scan.CheckChar(','))
+    {
+      Scan.GetChar(',', "before plot format");
+      if (!Scan.GetKeyWordIndex(PlotFormatNames, FormatIndex))
+        Scan.Error("Unknown plot format");
+      if (!PVPlotImage::Available(FormatIndex))
+        Scan.Error("Plot format not available (PNG needs ZLIB = yes)");
+      if (Scan.CheckChar(','))
+      {
+        Scan.GetChar(',', "before plot width");
+        Scan.GetInt(Width);
+        Scan.GetChar(',', "before plot height");
+        Scan.GetInt(Height);
+        if (Width < 100 || Width > 4096 || Height < 100 || Height > 4096)
+          Scan.Error("Range error");
+      }
+    }
+    Scan.GetChar(';', "");
+    SetPlotMode(Buffer, FormatIndex, Width, Height);
+  }
     
   // SensorCreation
   // --------------
@@ -415,7 +680,7 @@ void PEEventDispatcher::Setup(const char * Configuration,
       }
       assert(Sensor.sensor);
       SensorInstances.Add(Sensor);
-      RegisterSensor(Sensor.sensor);
+      RegisterSensor(Sensor.sensor, Sensor.name);
     } 	
     Scan.GetChar('}', "or unknown sensortype");
   }  
@@ -427,10 +692,20 @@ void PEEventDispatcher::Setup(const char * Configuration,
     int             DispType;
     char            DispName[128];
     char            ColorName[128];
-    PVFrameDisplay* Frame;
+#ifndef _PEV_HEADLESS
+    PVFrameDisplay* Frame = NULL;
+    const SCBoolean Connect = true;
+#else
+    // Ohne X11 werden Datentypen nur fuer die Bilder (Plot) gebraucht,
+    // sonst werden die Displaybeschreibungen nur ueberlesen
+    const SCBoolean Connect = plots != NULL;
+#endif
+    PVPlot*         Plot;
     SensorDef       Sensor;
     int             ValIndex;
+    int             NumSensors; // bisher im Display
     PDDataType*     Data;
+    PDCurveStore*   Store;     // gemeinsame Zeitachse der Kurven eines Rahmens
     
     Scan.GetKeyBlock("DisplayCreation");
     while (Scan.GetKeyWordIndex(DisplayTypeNames, DispType))
@@ -438,7 +713,9 @@ void PEEventDispatcher::Setup(const char * Configuration,
       Scan.GetString(DispName);
       Scan.GetChar(':', "after displayname");
       ValIndex = -1;
-      Frame = NULL;
+      NumSensors = 0;
+      Plot = NULL;
+      Store = NULL;
       while (!Scan.CheckChar(';'))
       {
         Scan.GetKeyWord(Sensor.name);
@@ -448,14 +725,21 @@ void PEEventDispatcher::Setup(const char * Configuration,
         } 
         Scan.GetConParas(ValIndex, ColorName, DispType, Sensor.type);
 	
-        // Erzeuge Display, falls noch nicht existent
-        // ------------------------------------------
-        if (!Frame)
+        // Erzeuge Display und evtl. Plot, falls noch nicht existent
+        // ---------------------------------------------------------
+        if (!NumSensors++)
         {
+#ifndef _PEV_HEADLESS
           Frame = InstantiateFrame(xEventDispatcher.GetXDisplay(),
                                    DispType, DispName, Adaption,
                                    Sensor);
           xEventDispatcher.AddDisplay(Frame);
+#endif
+          if (plots)
+          {
+            Plot = InstantiatePlot(DispType, DispName, Adaption, Sensor);
+            plots->Add(Plot);
+          }
         }
         else if (DispType == dFreqs && Sensor.type == sProcStateFreq)
         {
@@ -464,14 +748,48 @@ void PEEventDispatcher::Setup(const char * Configuration,
 
         // Finde oder erzeuge korrekten Datentyp
         // -------------------------------------
-        if (!DataTypeInstances.Get(Sensor.sensor, ValIndex, Data))
+        if (Connect && !DataTypeInstances.Get(Sensor.sensor, ValIndex, Data))
         {
+          char UpdaterName[260];  // fuer die Messung des Eigenaufwands
+          long Color = 1L;        // Pixelwert, nur fuer X11
+
+          sprintf(UpdaterName, "%s: %s", DispName, Sensor.name);
+          if (!Store && !IsDiscreteValIndex(ValIndex) &&
+              (DispType == dCurves || DispType == dFixedCurves ||
+               DispType == dRunCurves || DispType == dFixedRunCurves))
+          {
+            Store = new PDCurveStore(Points); // gehoert seinen Kurven
+          }
+#ifndef _PEV_HEADLESS
+          Color = Frame->GetColor(ColorName);
+#endif
           Data = InstantiateDataType(this, DispType, Sensor.sensor,
-                                     ValIndex, Points,
-                                     Frame->GetColor(ColorName));
+                                     ValIndex, Points, Store, Color,
+                                     UpdaterName);
           DataTypeInstances.Add(Sensor.sensor, ValIndex, Data);
         }
-        ConnectFrameWithData(DispType, Frame, Data, Sensor.stateTable);
+        if (Connect)
+        {
+          if (DispType == dRunCurves || DispType == dFixedRunCurves)
+          {
+            ((PDCurve*)Data)->EnableHistory(HistoryTiers);
+          }
+#ifndef _PEV_HEADLESS
+          ConnectFrameWithData(DispType, Frame, Data, Sensor.stateTable);
+#endif
+          if (Plot)
+          {
+            ConnectPlotWithData(DispType, Plot, Data,
+                                Plot->GetColor(ColorName), Sensor.stateTable);
+          }
+        }
+        if (ValIndex >= 0)     // Kurven und Gantt-Diagramme
+        {
+          char ColumnName[260];
+
+          SeriesColumnName(ColumnName, Sensor, DispType, ValIndex);
+          AddSeriesColumn(Sensor.sensor, ValIndex, ColumnName);
+        }
 
         if (Scan.CheckChar(',')) Scan.GetChar(',', "");
       }  // naechstes Argument
@@ -480,7 +798,9 @@ void PEEventDispatcher::Setup(const char * Configuration,
     Scan.GetChar('}', "or unknown display type");
   }
   
+#ifndef _PEV_HEADLESS
   xEventDispatcher.ArrangeDisplays();
+#endif
 }
 
 
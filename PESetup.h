@@ -29,12 +29,14 @@ enum SensorType
 enum DisplayType
 {
   dCurves, dFixedCurves, dGantt, dFreqs,
+  dRunCurves, dFixedRunCurves,      // gesamter Verlauf (PDCurveHistory)
   numDisplayTypes
 };
 
 enum ValIndexType // Achtung, muessen mit den entsprechenden PESTally und
 {                 // PESCounter-Werten wertemaessig uebereinstimmen
-  vNum, vMin, vMax, vAvg, vAvI, vVar, vDev, vCNT, vCPT, vCPI, vCQL,
+  vNum, vMin, vMax, vAvg, vAvI, vVar, vDev, vP50, vP90, vP95, vP99,
+  vCNT, vCPT, vCPI, vCQL,
   numValIndexTypes
 };
 
@@ -14,7 +14,9 @@
 template class SCList<PDDataType>;
 template class SCList<PESensor>;
 template class SCList<PCUpdater>;
+#ifndef _PEV_HEADLESS
 template class SCList<PVDisplay>;
+#endif
 template class SCList<PDCurve>;
 template class SCList<PDFrequency>;
 template class SCList<SensorTable::TEntry>;
@@ -24,7 +26,9 @@ template class SCList<PDStateTable>;
 template class SCListCons<PDDataType>;
 template class SCListCons<PESensor>;
 template class SCListCons<PCUpdater>;
+#ifndef _PEV_HEADLESS
 template class SCListCons<PVDisplay>;
+#endif
 template class SCListCons<PDCurve>;
 template class SCListCons<PDFrequency>;
 template class SCListCons<SensorTable::TEntry>;
@@ -34,7 +38,9 @@ template class SCListCons<PDStateTable>;
 template class SCListIter<PDDataType>;
 template class SCListIter<PESensor>;
 template class SCListIter<PCUpdater>;
+#ifndef _PEV_HEADLESS
 template class SCListIter<PVDisplay>;
+#endif
 template class SCListIter<PDCurve>;
 template class SCListIter<PDFrequency>;
 template class SCListIter<SensorTable::TEntry>;
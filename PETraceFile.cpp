@@ -0,0 +1,552 @@
+/******************************************************************************\
+ Datei : PETraceFile.cpp
+ Inhalt: Implementierung der Aufzeichnung und Wiedergabe von Ereignissen
+ Status:
+\******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <iostream>
+
+#include "PETraceFile.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+const char PETraceFile::magic[8] = {'P', 'E', 'V', 'T', 'R', 'A', 'C', 'E'};
+
+
+// Objekttyp der Namen von msgType (fuer Haeufigkeits-Reports)
+static SCObjectType MsgKind(SCTraceAction Action)
+{
+  switch (Action)
+  {
+    case scTraceStateChange:
+      return SC_STATE;
+
+    case scTraceServiceRequest:
+    case scTraceServiceStart:
+    case scTraceServiceFinish:
+    case scTraceServiceInterrupt:
+      return SC_REQUEST;
+
+    default:
+      return SC_SIGNAL;
+  }
+}
+
+
+static inline unsigned long long TimeBits(SCTime Time)
+{
+  unsigned long long bits;
+
+  memcpy(&bits, &Time, sizeof(bits));
+  return bits;
+}
+
+
+/******************************************************************************\
+ PETraceWriter: Implementierung
+\******************************************************************************/
+
+PETraceWriter::PETraceWriter(const char * FileName) :
+  file       (NULL),
+  fill       (0),
+  tableSize  (1024),
+  numObjects (0),
+  lastTime   (0.0)
+{
+  SCNatural i;
+
+  fileName = strdup(FileName);
+  table = new PEObject[tableSize];
+  for (i = 0; i < tableSize; i++)
+  {
+    table[i].object = NULL;
+  }
+}
+
+
+PETraceWriter::~PETraceWriter(void)
+{
+  if (file)
+  {
+    Flush();
+    fclose(file);
+  }
+  delete[] table;
+  free(fileName);
+}
+
+
+void PETraceWriter::Open(void)
+{
+  int i;
+
+  if ((file = fopen(fileName, "wb")) == NULL)
+  {
+    std::cerr << "Cannot open trace file " << fileName << "!\n";
+    abort();
+  }
+  for (i = 0; i < (int)sizeof(magic); i++)
+  {
+    PutByte(magic[i]);
+  }
+  PutByte(version);
+}
+
+
+void PETraceWriter::Record(const PEEvent & Event)
+{
+  SCNatural     runnable = 0, runnableType = 0;
+  SCNatural     partner = 0, partnerType = 0;
+  SCNatural     msgType = 0;
+  unsigned char flags = 0;
+
+  if (!file) Open();
+
+  // Typen zuerst, damit ihre Definitionen vor dem Ereignis stehen
+  if (Event.runnableType)
+  {
+    runnableType = Type(Event.runnableType, SC_NONE, 0, Event.runnableName);
+    flags |= hasRunnableType;
+  }
+  if (Event.partnerType)
+  {
+    partnerType = Type(Event.partnerType, SC_NONE, 0, NULL);
+    flags |= hasPartnerType;
+  }
+  if (Event.msgType)
+  {
+    msgType = Type(Event.msgType, MsgKind(Event.action),
+                   Event.msgID, Event.msgName);
+    flags |= hasMsgType;
+  }
+  if (Event.runnable)
+  {
+    runnable = Intern(Event.runnable)->id;
+    flags |= hasRunnable;
+  }
+  if (Event.partner)
+  {
+    partner = Intern(Event.partner)->id;
+    flags |= hasPartner;
+  }
+  if (Event.time != lastTime)
+    flags |= hasTime;
+  if (Event.msgCreation != 0.0 || Event.msgWaitStart != 0.0)
+    flags |= hasMsgTimes;
+  if (Event.freeServers || Event.numServers)
+    flags |= hasServers;
+
+  PutByte(Event.action);
+  PutByte(flags);
+  if (flags & hasTime)
+  {
+    PutDelta(Event.time, lastTime);
+    lastTime = Event.time;
+  }
+  if (flags & hasRunnable)     PutNumber(runnable);
+  if (flags & hasRunnableType) PutNumber(runnableType);
+  if (flags & hasPartner)      PutNumber(partner);
+  if (flags & hasPartnerType)  PutNumber(partnerType);
+  if (flags & hasMsgType)      PutNumber(msgType);
+  if (flags & hasMsgTimes)
+  {
+    PutDelta(Event.msgCreation, Event.time);
+    PutDelta(Event.msgWaitStart, Event.time);
+  }
+  if (flags & hasServers)
+  {
+    PutSigned(Event.freeServers);
+    PutSigned(Event.numServers);
+  }
+}
+
+
+void PETraceWriter::Flush(void)
+{
+  if (!file) return;
+
+  if (fill && fwrite(buffer, 1, fill, file) != fill)
+  {
+    std::cerr << "Cannot write trace file " << fileName << "!\n";
+    abort();
+  }
+  fill = 0;
+  fflush(file);
+}
+
+
+PETraceWriter::PEObject * PETraceWriter::Intern(const void * Object)
+{
+  unsigned long h;
+  PEObject *    entry;
+
+  if (2 * (numObjects + 1) > tableSize) Grow();
+
+  h = (unsigned long)Object;
+  h ^= h >> 7;
+  h *= 0x45d9f3bUL;
+  h ^= h >> 13;
+
+  for (entry = &table[h & (tableSize - 1)];
+       entry->object && entry->object != Object;
+       entry = (entry == &table[tableSize - 1]) ? table : entry + 1)
+    ;
+
+  if (!entry->object)
+  {
+    entry->object = Object;
+    entry->id = ++numObjects;          // ID 0 steht fuer NULL
+    entry->named = 0;
+  }
+  return entry;
+}
+
+
+// Liefert die ID eines Typs und schreibt beim ersten Auftreten (bzw. sobald
+// der Name bekannt ist) seinen Definitionssatz
+SCNatural PETraceWriter::Type(const void * Type,
+                              SCObjectType Kind,
+                              SCInteger    ID,
+                              const char * Name)
+{
+  PEObject * entry = Intern(Type);
+  SCNatural  len;
+
+  if (entry->named < (Name ? 2 : 1))
+  {
+    entry->named = Name ? 2 : 1;
+    len = Name ? strlen(Name) : 0;
+
+    PutByte(defineTag);
+    PutNumber(entry->id);
+    PutByte(Kind);
+    PutSigned(ID);
+    PutNumber(len);
+    while (len--)
+    {
+      PutByte(*Name++);
+    }
+  }
+  return entry->id;
+}
+
+
+void PETraceWriter::Grow(void)
+{
+  PEObject * oldTable = table;
+  SCNatural  oldSize = tableSize;
+  SCNatural  i;
+  PEObject * entry;
+
+  tableSize *= 2;
+  table = new PEObject[tableSize];
+  for (i = 0; i < tableSize; i++)
+  {
+    table[i].object = NULL;
+  }
+  numObjects = 0;
+
+  for (i = 0; i < oldSize; i++)
+  {
+    if (oldTable[i].object)
+    {
+      entry = Intern(oldTable[i].object);
+      *entry = oldTable[i];
+    }
+  }
+  // Intern hat beim Umkopieren neu gezaehlt; die alten IDs bleiben gueltig
+  delete[] oldTable;
+}
+
+
+inline void PETraceWriter::PutByte(unsigned char Byte)
+{
+  if (fill == bufferSize) Flush();
+  buffer[fill++] = Byte;
+}
+
+
+void PETraceWriter::PutNumber(unsigned long long Number)
+{
+  while (Number >= 0x80)
+  {
+    PutByte((unsigned char)(Number | 0x80));
+    Number >>= 7;
+  }
+  PutByte((unsigned char)Number);
+}
+
+
+void PETraceWriter::PutSigned(long long Number)
+{
+  PutNumber(((unsigned long long)Number << 1) ^ (unsigned long long)(Number >> 63));
+}
+
+
+void PETraceWriter::PutDelta(SCTime Time, SCTime Base)
+{
+  PutSigned((long long)(TimeBits(Time) - TimeBits(Base)));
+}
+
+
+/******************************************************************************\
+ PETraceReader: Implementierung
+\******************************************************************************/
+
+PETraceReader::PETraceReader(const char * FileName,
+                             SCBoolean    RegisterNames) :
+  types         (NULL),
+  numTypes      (0),
+  lastTime      (0.0),
+  registerNames (RegisterNames),
+  truncated     (false)
+{
+  struct stat status;
+  int         fd;
+
+  if ((fd = open(FileName, O_RDONLY)) < 0 || fstat(fd, &status) < 0)
+  {
+    std::cerr << "Cannot open trace file " << FileName << "!\n";
+    abort();
+  }
+  length = status.st_size;
+  if (length < sizeof(magic) + 1)
+  {
+    Corrupt();
+  }
+  base = (const unsigned char *)mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == (const unsigned char *)MAP_FAILED)
+  {
+    std::cerr << "Cannot map trace file " << FileName << "!\n";
+    abort();
+  }
+  madvise((void *)base, length, MADV_SEQUENTIAL);
+
+  end = base + length;
+  cur = released = base;
+  if (memcmp(cur, magic, sizeof(magic)) || cur[sizeof(magic)] != version)
+  {
+    Corrupt();
+  }
+  cur += sizeof(magic) + 1;
+}
+
+
+PETraceReader::~PETraceReader(void)
+{
+  SCNatural i;
+
+  munmap((void *)base, length);
+  for (i = 0; i < numTypes; i++)
+  {
+    free(types[i].name);
+  }
+  free(types);
+}
+
+
+SCBoolean PETraceReader::Next(PEEvent & Event)
+{
+  unsigned char flags;
+  SCNatural     id;
+
+  if (truncated) return false;     // schon gemeldet
+
+  while (cur < end && *cur == defineTag)
+  {
+    cur++;
+    Define();
+  }
+  if (truncated) return Truncated();
+  if (cur >= end) return false;
+
+  memset(&Event, 0, sizeof(Event));
+  Event.action = SCTraceAction(GetByte());
+  flags = GetByte();
+
+  if (flags & hasTime)
+  {
+    lastTime = GetDelta(lastTime);
+  }
+  Event.time = lastTime;
+
+  if (flags & hasRunnable)
+  {
+    Event.runnable = Object(GetNumber());
+  }
+  if (flags & hasRunnableType)
+  {
+    id = GetNumber();
+    Event.runnableType = Object(id);
+    Event.runnableName = GetType(id).name;
+  }
+  if (flags & hasPartner)
+  {
+    Event.partner = Object(GetNumber());
+  }
+  if (flags & hasPartnerType)
+  {
+    Event.partnerType = Object(GetNumber());
+  }
+  if (flags & hasMsgType)
+  {
+    id = GetNumber();
+    Event.msgType = Object(id);
+    Event.msgName = GetType(id).name;
+    Event.msgID = GetType(id).id;
+  }
+  if (flags & hasMsgTimes)
+  {
+    Event.msgCreation = GetDelta(Event.time);
+    Event.msgWaitStart = GetDelta(Event.time);
+  }
+  if (flags & hasServers)
+  {
+    Event.freeServers = GetSigned();
+    Event.numServers = GetSigned();
+  }
+  if (truncated) return Truncated();
+
+  // Gelesene Seiten freigeben, damit der Speicherbedarf nicht mit der
+  // Dateigroesse waechst
+  if (cur - released > releaseSize)
+  {
+    long page = sysconf(_SC_PAGESIZE);
+    const unsigned char * upTo = base + ((cur - base) & ~(page - 1));
+
+    madvise((void *)released, upTo - released, MADV_DONTNEED);
+    released = upTo;
+  }
+  return true;
+}
+
+
+void PETraceReader::Define(void)
+{
+  SCNatural    id = GetNumber();
+  SCObjectType kind = SCObjectType(GetByte());
+  SCInteger    msgID = GetSigned();
+  SCNatural    len = GetNumber();
+  SCNatural    i;
+
+  if (truncated || len > (SCNatural)(end - cur))
+  {
+    truncated = true;
+    return;
+  }
+
+  if (id >= numTypes)
+  {
+    SCNatural newNum = numTypes ? numTypes : 64;
+
+    while (newNum <= id) newNum <<= 1;
+    types = (PEType *)realloc(types, newNum * sizeof(PEType));
+    assert(types);
+    for (i = numTypes; i < newNum; i++)
+    {
+      types[i].name = NULL;
+      types[i].id = 0;
+    }
+    numTypes = newNum;
+  }
+
+  free(types[id].name);
+  types[id].name = (char *)malloc(len + 1);
+  memcpy(types[id].name, cur, len);
+  types[id].name[len] = '\0';
+  types[id].id = msgID;
+  cur += len;
+
+  if (registerNames &&
+      (kind == SC_STATE || kind == SC_SIGNAL || kind == SC_REQUEST))
+  {
+    PEObjectNames::Set(kind, msgID, types[id].name);
+  }
+}
+
+
+// Nach dem Ende einer abgeschnittenen Datei sind die IDs bedeutungslos
+const PETraceReader::PEType & PETraceReader::GetType(SCNatural ID) const
+{
+  static const PEType none = {(char *)"", 0};
+
+  if (ID >= numTypes || !types[ID].name)
+  {
+    if (truncated) return none;
+    Corrupt();
+  }
+  return types[ID];
+}
+
+
+// Am Dateiende: 0 und truncated, der Satz wird von Next verworfen
+inline unsigned char PETraceReader::GetByte(void)
+{
+  if (cur >= end)
+  {
+    truncated = true;
+    return 0;
+  }
+  return *cur++;
+}
+
+
+unsigned long long PETraceReader::GetNumber(void)
+{
+  unsigned long long number = 0;
+  unsigned char      byte;
+  int                shift = 0;
+
+  do
+  {
+    byte = GetByte();
+    number |= (unsigned long long)(byte & 0x7f) << shift;
+    shift += 7;
+  }
+  while (byte & 0x80);
+
+  return number;
+}
+
+
+long long PETraceReader::GetSigned(void)
+{
+  unsigned long long number = GetNumber();
+
+  return (long long)((number >> 1) ^ (~(number & 1) + 1));
+}
+
+
+SCTime PETraceReader::GetDelta(SCTime Base)
+{
+  unsigned long long bits = TimeBits(Base) + (unsigned long long)GetSigned();
+  SCTime             time;
+
+  memcpy(&time, &bits, sizeof(time));
+  return time;
+}
+
+
+SCBoolean PETraceReader::Truncated(void)
+{
+  std::cerr << "Warning: trace file ends within a record, "
+               "replay stops here!\n";
+  return false;
+}
+
+
+void PETraceReader::Corrupt(void) const
+{
+  std::cerr << "Corrupt trace file!\n";
+  abort();
+}
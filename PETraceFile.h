@@ -0,0 +1,152 @@
+/******************************************************************************\
+ Datei : PETraceFile.h
+ Inhalt: Deklaration der Aufzeichnung (PETraceWriter) und der Wiedergabe
+         (PETraceReader) von Ereignissen in einer binaeren Trace-Datei
+ Status:
+\******************************************************************************/
+
+#ifndef __PETRACEFILE_H
+#define __PETRACEFILE_H
+
+#include <stdio.h>
+
+#include <SCL/SCBasicTypes.h>
+
+#ifndef __PEEVENT_H
+#include "PEEvent.h"
+#endif
+
+/******************************************************************************\
+ Format der Trace-Datei: Auf die Kennung "PEVTRACE" und eine Versionsnummer
+   folgen die Datensaetze. Zahlen werden als Varint (7 Bit je Byte, hoechstes
+   Bit = Fortsetzung) abgelegt, vorzeichenbehaftete Zahlen zusaetzlich im
+   ZigZag-Format.
+     Objekte (Prozesse, Maschinen, Typen) werden beim ersten Auftreten auf
+   fortlaufende IDs abgebildet. Fuer Typen (Prozesstyp, Maschine, Signal-,
+   Request- und Zustandstyp) geht dem ersten Ereignis ein Definitionssatz mit
+   Name und ID des Typs voraus.
+     Zeiten werden als Differenz der IEEE-Bitmuster zur Zeit des vorigen
+   Ereignisses abgelegt (exakt und fuer kleine Zeitschritte kurz). Erzeugung
+   und Wartebeginn eines Signals/Requests beziehen sich auf die Ereigniszeit.
+\******************************************************************************/
+
+class PETraceFile
+{
+  public:
+    enum
+    {
+      version    = 1,
+      defineTag  = 0xff,            // Definitionssatz statt Ereignis
+
+      hasTime         = 0x01,       // Flags im Ereignissatz
+      hasRunnable     = 0x02,
+      hasRunnableType = 0x04,
+      hasPartner      = 0x08,
+      hasPartnerType  = 0x10,
+      hasMsgType      = 0x20,
+      hasMsgTimes     = 0x40,
+      hasServers      = 0x80
+    };
+
+    static const char magic[8];
+};
+
+/******************************************************************************\
+ PETraceWriter: Schreibt jedes Ereignis, das der EventDispatcher verteilt, in
+   eine Trace-Datei. Die Datei wird erst beim ersten Ereignis angelegt.
+\******************************************************************************/
+
+class PETraceWriter: public PETraceFile
+{
+  public:
+    PETraceWriter(const char * FileName);
+    ~PETraceWriter(void);
+
+    void Record(const PEEvent & Event);
+    void Flush(void);
+    const char * GetFileName(void) const { return fileName; }
+
+  private:
+    enum {bufferSize = 1 << 16};
+
+    struct PEObject              // Eintrag der Hashtabelle der Objekte
+    {
+      const void * object;
+      SCNatural    id;
+      int          named;        // Definition geschrieben (1: ohne Name)
+    };
+
+    char *          fileName;
+    FILE *          file;
+    unsigned char   buffer[bufferSize];
+    SCNatural       fill;
+    PEObject *      table;       // offene Adressierung, Zweierpotenz
+    SCNatural       tableSize;
+    SCNatural       numObjects;
+    SCTime          lastTime;
+
+    void        Open(void);
+    PEObject *  Intern(const void * Object);
+    SCNatural   Type(const void * Type, SCObjectType Kind,
+                     SCInteger ID, const char * Name);
+    void        Grow(void);
+    void        PutByte(unsigned char Byte);
+    void        PutNumber(unsigned long long Number);
+    void        PutSigned(long long Number);
+    void        PutDelta(SCTime Time, SCTime Base);
+};
+
+/******************************************************************************\
+ PETraceReader: Liest eine Trace-Datei. Die Datei wird in den Speicher
+   eingeblendet (mmap) und sequentiell gelesen; bereits gelesene Bereiche
+   werden wieder freigegeben, so dass auch sehr grosse Aufzeichnungen nicht
+   in den Hauptspeicher passen muessen.
+     Die Objekte der gelieferten Ereignisse sind keine SCL-Objekte, sondern
+   nur eindeutige Kennungen; die Namen der Typen stammen aus der Datei und
+   werden in PEObjectNames eingetragen.
+     Endet die Datei mitten in einem Satz (z.B. nach einem Absturz des
+   Simulators), gilt das als Ende der Aufzeichnung: Next meldet es einmal
+   als Warnung und liefert false. Andere Formatfehler brechen ab.
+\******************************************************************************/
+
+class PETraceReader: public PETraceFile
+{
+  public:
+    PETraceReader(const char * FileName,
+                  SCBoolean    RegisterNames = true); // Namen in PEObjectNames
+    ~PETraceReader(void);
+
+    SCBoolean Next(PEEvent & Event);       // false am Dateiende
+
+  private:
+    enum {releaseSize = 1 << 26};          // Bytes zwischen zwei Freigaben
+
+    struct PEType
+    {
+      char *    name;
+      SCInteger id;
+    };
+
+    const unsigned char * base;
+    const unsigned char * end;
+    const unsigned char * cur;
+    const unsigned char * released;        // bis hier freigegeben
+    unsigned long         length;
+    PEType *              types;           // Typen nach Objekt-ID
+    SCNatural             numTypes;
+    SCTime                lastTime;
+    SCBoolean             registerNames;
+    SCBoolean             truncated;       // Datei endet mitten in einem Satz
+
+    void                  Define(void);
+    const PEType &        GetType(SCNatural ID) const;
+    unsigned char         GetByte(void);
+    unsigned long long    GetNumber(void);
+    long long             GetSigned(void);
+    SCTime                GetDelta(SCTime Base);
+    SCBoolean             Truncated(void);
+    void                  Corrupt(void) const;
+    static const void *   Object(SCNatural ID) { return (const void *)ID; }
+};
+
+#endif
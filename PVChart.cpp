@@ -0,0 +1,975 @@
+/******************************************************************************\
+ Datei : PVChart.cpp
+ Inhalt: Implementierung der Diagramme PVCurvesChart, PVGanttChart und
+         PVFreqChart
+ Status:
+\******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "PVChart.h"
+#include "PEEvent.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+/******************************************************************************\
+ PVCurvesChart: Implementierung
+\******************************************************************************/
+
+PVCurvesChart::PVCurvesChart(int       AdaptRange,
+                             SCBoolean FixedBottom,
+                             SCBoolean WholeRun) :
+  numEntries            (0),
+  maxEntries            (4),
+  fixedBottom           (FixedBottom),
+  wholeRun              (WholeRun),
+  adaptRange            (AdaptRange),
+  leftAdaptRange        (0),
+  rightAdaptRange       (0),
+  lowerBottomAdaptRange (0),
+  lowerTopAdaptRange    (0),
+  upperBottomAdaptRange (0),
+  upperTopAdaptRange    (0),
+  yAxisDirty            (true),
+  scroll                (-1),
+  numDrawn              (0),
+  maxPoints             (64),
+  maxXRow               (64),
+  maxRunPoints          (64)
+{
+  assert(adaptRange > 5 && adaptRange < 60); // Sinnvolle Bereiche
+
+  mapX.SetOrgPixel(0);
+  mapY.SetOrgPixel(-1);
+  min.x = min.y = max.x = max.y = 0;
+  entries = new PVEntry[maxEntries];
+  lastX = new double[maxEntries];
+  points = new PVPoint[maxPoints];
+  xRow = new short[maxXRow];
+  runPoints = new PDPoint[maxRunPoints];
+}
+
+
+PVCurvesChart::~PVCurvesChart(void)
+{
+  delete[] entries;
+  delete[] lastX;
+  delete[] points;
+  delete[] xRow;
+  delete[] runPoints;
+}
+
+
+void PVCurvesChart::AddCurve(const PDCurve * Curve, unsigned long Color)
+{
+  if (numEntries == maxEntries)
+  {
+    PVEntry * grown = new PVEntry[2 * maxEntries];
+
+    memcpy(grown, entries, numEntries * sizeof(PVEntry));
+    delete[] entries;
+    delete[] lastX;
+    entries = grown;
+    maxEntries *= 2;
+    lastX = new double[maxEntries];
+    numDrawn = 0;                       // lastX ist verloren
+  }
+  entries[numEntries].curve = Curve;
+  entries[numEntries].color = Color;
+  numEntries++;
+}
+
+
+int PVCurvesChart::LeftMargin(PVSurface & Axis) const
+{
+  Axis.SetFont(PVSurface::axisFont);
+  return Axis.TextWidth("00.000e-00");
+}
+
+
+void PVCurvesChart::Resize(int Width, int Height)
+{
+  width = Width;
+  height = Height;
+
+  rightAdaptRange = width;
+  leftAdaptRange  = width * (100 - adaptRange) / 100;
+
+  upperTopAdaptRange    = 1;
+  lowerTopAdaptRange    = (height * adaptRange) / 100;
+  upperBottomAdaptRange = height * (100 - adaptRange) / 100;
+  lowerBottomAdaptRange = height;
+
+  mapX.SetDistPixel(width - 1);
+  mapY.SetOrgPixel(height - 1);
+  mapY.SetDistPixel(-(height - 1));
+}
+
+
+// Puffer fuer Linienzuege, waechst nur
+PVPoint * PVCurvesChart::GetPoints(int Num)
+{
+  if (Num > maxPoints)
+  {
+    delete[] points;
+    while (maxPoints < Num) maxPoints *= 2;
+    points = new PVPoint[maxPoints];
+  }
+  return points;
+}
+
+
+// Puffer fuer die Zeitspalte eines PDCurveStore, waechst nur
+short * PVCurvesChart::GetXRow(int Num)
+{
+  if (Num > maxXRow)
+  {
+    delete[] xRow;
+    while (maxXRow < Num) maxXRow *= 2;
+    xRow = new short[maxXRow];
+  }
+  return xRow;
+}
+
+
+// Puffer fuer PDCurveHistory::GetPoints, waechst nur
+PDPoint * PVCurvesChart::GetRunPoints(int Num)
+{
+  if (Num > maxRunPoints)
+  {
+    delete[] runPoints;
+    while (maxRunPoints < Num) maxRunPoints *= 2;
+    runPoints = new PDPoint[maxRunPoints];
+  }
+  return runPoints;
+}
+
+
+// Setzt den Ursprung der X-Achse (OrgX auf Pixel 0). Ist bei gleicher
+// Skalierung nur die Zeit weitergerueckt, bleibt die virtuelle Position des
+// Ursprungs, und nur der Pixel-Ursprung rueckt um ganze scroll Pixel nach
+// links: Alle bereits gezeichneten Punkte liegen dann exakt um scroll Pixel
+// verschoben, und der Besitzer des Bildes muss es nur verschieben.
+void PVCurvesChart::SetOrgX(double OrgX, SCBoolean Valid)
+{
+  if (Valid && !wholeRun && mapX.SameScale(drawnX) &&
+      (scroll = drawnX(OrgX)) >= 0)
+  {
+    mapX.SetOrgPos(drawnX.GetOrgPos());
+    mapX.SetOrgPixel(drawnX.GetOrgPixel() - scroll);
+  }
+  else
+  {
+    scroll = -1;
+    mapX.SetOrgPos(OrgX);
+    mapX.SetOrgPixel(0);
+  }
+}
+
+
+// Autoskalierung der X-Achse: neu skaliert wird erst, wenn das Ende der
+// Kurven den Adaptionsbereich verlaesst
+void PVCurvesChart::AdaptX(const PDPoint& TMin, const PDPoint& TMax,
+                           SCBoolean Valid)
+{
+  SetOrgX(TMin.x, Valid);
+  int XPos = mapX(TMax.x);
+  if (XPos < leftAdaptRange || XPos > rightAdaptRange)
+  {
+    mapX.SetDistPos((TMax.x - TMin.x) * 100 / (100 - adaptRange / 2));
+    SetOrgX(TMin.x, Valid);   // neue Skalierung => neu zeichnen
+  }
+  min.x = mapX.ReMap(0);
+  max.x = mapX.ReMap(width - 1);
+}
+
+
+void PVCurvesChart::Update(SCBoolean Valid)
+{
+  const PDCurve * curve = numEntries ? entries[0].curve : NULL;
+  int             c;
+
+  scroll = -1;
+
+  if (curve && wholeRun && curve->GetHistory() &&
+      !curve->GetHistory()->IsEmpty())
+  {
+    // Gesamter Verlauf: X-Bereich vom Anfang bis zum letzten Punkt
+    // ------------------------------------------------------------
+    PDPoint TMin, TMax; // Temporaere Min/Max Werte
+
+    curve->GetHistory()->GetMinMax(TMin, TMax);
+
+    for (c = 1; c < numEntries; c++)
+    {
+      PDPoint CMin, CMax;
+
+      curve = entries[c].curve;
+      if (curve->GetHistory())
+        curve->GetHistory()->GetMinMax(CMin, CMax);
+      else
+        curve->GetMinMax(CMin, CMax);
+      if (CMin.y < TMin.y) TMin.y = CMin.y;
+      if (CMax.y > TMax.y) TMax.y = CMax.y;
+    }
+    if (TMax.x <= TMin.x) TMax.x = TMin.x + 1.0;
+
+    mapX.SetOrgPos(TMin.x);
+    mapX.SetDistPos(TMax.x - TMin.x);
+    min.x = TMin.x;
+    max.x = TMax.x;
+
+    Rescale(TMin, TMax);
+  }
+  else if (curve && curve->GetNumPoints() > 3)  // curven da und genug Punkte?
+  {
+    // Ermittle Minimum und Maximum aller Kurven
+    // -----------------------------------------
+    PDPoint TMin, TMax; // Temporaere Min/Max Werte
+
+    curve->GetMinMax(TMin, TMax);
+
+    if (curve->GetNumPoints() < curve->maxPoints) // Approximation des Maximums
+    {
+      TMax.x = TMin.x + ((TMax.x - TMin.x) * curve->maxPoints) /
+                        curve->GetNumPoints();
+    }
+
+    for (c = 1; c < numEntries; c++)
+    {                                // Da die X-Koordinaten fuer alle Kurven
+      PDPoint CMin, CMax;            // gleich sind, brauchen nur die Y-Minima
+                                     // und Maxima ermittelt werden.
+      entries[c].curve->GetMinMax(CMin, CMax);
+      if (CMin.y < TMin.y) TMin.y = CMin.y;
+      if (CMax.y > TMax.y) TMax.y = CMax.y;
+      if (CMin.x > TMin.x) TMin.x = CMin.x; // wegen Kurvenkomprimierung erforderlich
+    }
+
+    AdaptX(TMin, TMax, Valid);
+    Rescale(TMin, TMax);
+  }
+}
+
+
+// Autoskalierung der Y-Achse fuer die Werte TMin.y bis TMax.y
+void PVCurvesChart::Rescale(PDPoint& TMin, PDPoint& TMax)
+{
+  // Sonderfaelle der Y-Skalierung - Patch vom 16.10.95 by CR
+  if (fixedBottom) TMin.y = 0.0;
+  if (TMax.y == TMin.y)
+  {
+    TMax.y *= 1.8;
+    TMin.y = 0.0;
+  }
+
+  int YMaxPos = mapY(TMax.y);
+  int YMinPos = mapY(TMin.y);
+
+  if ( (YMinPos > lowerBottomAdaptRange) || (YMinPos < upperBottomAdaptRange) ||
+       (YMaxPos > lowerTopAdaptRange)    || (YMaxPos < upperTopAdaptRange) )
+  {
+    double Dist, Org;
+
+    Dist = (TMax.y - TMin.y) * 100 / (100 - adaptRange);
+    Org  = TMin.y - Dist * (adaptRange / 2) / 100;
+    if (Org < 0.0)
+    {
+      Dist += Org;
+      Org  = 0.0;
+    }
+    if (Dist <= 0.0) Dist = 0.001;
+
+    mapY.SetOrgPos(Org);
+    mapY.SetDistPos(Dist);
+    max.y = mapY.ReMap(0);
+    min.y = mapY.ReMap(height - 1);
+    yAxisDirty = true;
+  }
+  else
+  {
+    yAxisDirty = false;
+  }
+}
+
+
+// Zeichnet die Punkte From bis zum Ende einer Kurve
+void PVCurvesChart::DrawCurve(PVSurface &     Surface,
+                              const PDCurve * Curve,
+                              int             From,
+                              double          Offset,
+                              int             X,
+                              int             Y)
+{
+  const int num = Curve->GetNumPoints() - From;
+  PVPoint * line;
+  PDPoint   point;
+  int       i;
+
+  if (num < 2) return;
+  line = GetPoints(num);
+  for (i = 0; i < num; i++)
+  {
+    point = Curve->GetPoint(From + i);
+    line[i].x = mapX(point.x) + X;
+    line[i].y = mapY(point.y + Offset) + Y;
+  }
+  Surface.Lines(line, num);
+}
+
+
+// Zeichnet den Datenbereich mit allen Kurven vollstaendig
+void PVCurvesChart::Draw(PVSurface & Surface, int X, int Y)
+{
+  const PDCurveStore * xStore = NULL; // Zeitspalte in xRow (ab First())
+  int                  c;
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::selected));
+  Surface.FillRect(X, Y, width, height);
+
+  for (c = 0; c < numEntries; c++)
+  {
+    const PDCurve * curve = entries[c].curve;
+    const double    offset = YOffset(c);
+    const int       num = curve->GetNumPoints();
+
+    Surface.SetColor(entries[c].color);
+    lastX[c] = num ? curve->GetPoint(num - 1).x : -HUGE_VAL;
+    if (!wholeRun && curve->GetStore())
+    {
+      // Spaltenweise Ablage: die gemeinsame Zeitspalte wird nur einmal je
+      // Speicher abgebildet, danach nur noch die Wertespalte der Kurve.
+      const PDCurveStore * store = curve->GetStore();
+
+      if (store != xStore)
+      {
+        const double * x = store->XColumn();
+        int            n1 = store->maxRows - store->First();
+
+        if (n1 > store->NumRows()) n1 = store->NumRows();
+        GetXRow(store->NumRows());
+        for (int i = 0; i < n1; i++)
+          xRow[i] = mapX(x[store->First() + i]) + X;
+        for (int i = n1; i < store->NumRows(); i++)
+          xRow[i] = mapX(x[i - n1]) + X;
+        xStore = store;
+      }
+      if (num > 3)
+      {
+        const double * y = store->YColumn(curve->GetColumn());
+        const short *  xs = xRow + store->NumRows() - num;
+        const int      start = store->First(curve->GetColumn());
+        int            n1 = store->maxRows - start;
+        PVPoint *      line = GetPoints(num);
+
+        if (n1 > num) n1 = num;
+        for (int i = 0; i < n1; i++)
+        {
+          line[i].x = xs[i];
+          line[i].y = mapY(y[start + i] + offset) + Y;
+        }
+        for (int i = n1; i < num; i++)
+        {
+          line[i].x = xs[i];
+          line[i].y = mapY(y[i - n1] + offset) + Y;
+        }
+        Surface.Lines(line, num);
+      }
+    }
+    else if (wholeRun && curve->GetHistory())
+    {
+      const PDCurveHistory * history = curve->GetHistory();
+      PDPoint *              run = GetRunPoints(history->MaxPoints());
+      int                    n = history->GetPoints(run);
+
+      if (n > 1)
+      {
+        PVPoint * line = GetPoints(n);
+
+        for (int i = 0; i < n; i++)
+        {
+          line[i].x = mapX(run[i].x) + X;
+          line[i].y = mapY(run[i].y + offset) + Y;
+        }
+        Surface.Lines(line, n);
+      }
+    }
+    else if (num > 3)
+    {
+      DrawCurve(Surface, curve, 0, offset, X, Y);
+    }
+  }
+  drawnX = mapX;
+  numDrawn = numEntries;
+}
+
+
+// Zeichnet nur das Ende der Kurven in einen Puffer, der genau den
+// Datenbereich enthaelt und bereits um GetScroll() Pixel verschoben ist:
+// Alles rechts vom vorletzten bereits gezeichneten Punkt (der letzte kann
+// sich seitdem noch geaendert haben) wird geloescht und neu gezeichnet.
+// Liefert den linken Rand dieses Streifens oder -1, wenn doch alles neu
+// gezeichnet werden muss.
+int PVCurvesChart::DrawTail(PVSurface & Surface)
+{
+  int left = width;
+  int c, i, num;
+
+  if (numDrawn != numEntries) return -1;  // neue Kurven
+  for (c = 0; c < numEntries; c++)
+  {
+    const PDCurve * curve = entries[c].curve;
+
+    num = curve->GetNumPoints();
+    for (i = num; i > 0 && curve->GetPoint(i - 1).x >= lastX[c]; i--);
+    if (i == num && num) return -1;  // Kurve zurueckgesetzt
+    if (i > 0) i--;
+    if (num > 3 && mapX(curve->GetPoint(i).x) < left)
+      left = mapX(curve->GetPoint(i).x);
+  }
+  drawnX = mapX;
+  if (left < 0) left = 0;
+  if (left >= width) return width;
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::selected));
+  Surface.FillRect(left, 0, width - left, height);
+  Surface.Clip(left, 0, width - left, height);
+
+  for (c = 0; c < numEntries; c++)
+  {
+    const PDCurve * curve = entries[c].curve;
+
+    num = curve->GetNumPoints();
+    if (num > 3)
+    {
+      for (i = num; i > 0 && mapX(curve->GetPoint(i - 1).x) >= left; i--);
+      Surface.SetColor(entries[c].color);
+      DrawCurve(Surface, curve, i > 0 ? i - 1 : 0, YOffset(c), 0, 0);
+    }
+    lastX[c] = num ? curve->GetPoint(num - 1).x : -HUGE_VAL;
+  }
+  Surface.Clip(0, 0, 0, 0);
+
+  return left;
+}
+
+
+void PVCurvesChart::DrawXAxis(PVSurface & Surface, int X, int Y,
+                              int Width, int Height) const
+{
+  Surface.SetFont(PVSurface::axisFont);
+
+  const int    YOffset  = Y + Height + 2;
+  const int    YTxPos   = YOffset + Surface.Ascent() + 4;
+  const int    YPos1    = YOffset + 2;
+  const int    YPos2    = YPos1 + 2;
+  const double MaxX     = max.x;
+  const double MinX     = min.x;
+  const int    TxWidth  = Surface.TextWidth("00.000e-00") + 4;
+  const int    TxFields = Width / TxWidth;
+
+  double MarkDist = -1.0;  // (virtueller) Abstand zwischen Markierung
+  double FirstMark = -1.0; // erste Hauptmarkierung
+  double x;                // Schleifenvariable fuer MD
+  char   Number[32];       // Lieber zuviel als zuwenig
+
+  if (!PVMapper::Marks(MinX, MaxX, TxFields, MarkDist, FirstMark)) return;
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::foreground));
+  if (TxFields != 0)
+  {
+    Surface.Clip(X - 2, YOffset, Width + 4, BottomMargin());
+    for (x = FirstMark; x < MaxX; x += MarkDist)
+    {
+      sprintf(Number, "%.5g", x);
+      Surface.Text(MapX(x) + X, YTxPos, Number, PVSurface::center);
+    }
+    Surface.Clip(0, 0, 0, 0);
+  }
+
+  // Markierungen zeichnen
+  // ---------------------
+  int    XPos;
+  double MarkOffset = MarkDist / 2;
+
+  for (x = FirstMark; x < MaxX; x += MarkDist)
+  {
+    XPos = MapX(x) + X;
+    Surface.Line(XPos, YOffset, XPos, YPos2);
+  }
+  FirstMark += (FirstMark - MarkOffset < MinX) ? MarkOffset : -MarkOffset;
+  for (x = FirstMark; x < MaxX; x += MarkDist)
+  {
+    XPos = MapX(x) + X;
+    Surface.Line(XPos, YOffset, XPos, YPos1);
+  }
+}
+
+
+void PVCurvesChart::DrawYAxis(PVSurface & Surface, int X, int Y,
+                              int, int Height) const
+{
+  Surface.SetFont(PVSurface::axisFont);
+
+  const int    XOffset  = X - 3;
+  const int    XTxPos   = XOffset - 5;
+  const int    XPos1    = XOffset - 4;
+  const int    XPos2    = XOffset - 2;
+  const int    YTxPos   = Y + Surface.Ascent() / 2;
+  const double MaxY     = max.y;
+  const double MinY     = min.y;
+  const int    TxHeight = Surface.Ascent() + Surface.Descent() + 10;
+  const int    TxFields = Height / TxHeight;
+
+  double MarkDist = -1.0;  // (virtueller) Abstand zwischen Markierung
+  double FirstMark = -1.0; // erste Hauptmarkierung
+  double y;                // Schleifenvariable fuer MD
+  char   Number[32];       // Lieber zuviel als zuwenig
+
+  if (!PVMapper::Marks(MinY, MaxY, TxFields, MarkDist, FirstMark)) return;
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::foreground));
+  if (TxFields != 0)
+  {
+    for (y = FirstMark; y < MaxY; y += MarkDist)
+    {
+      sprintf(Number, "%.5g", y);
+      Surface.Text(XTxPos, MapY(y) + YTxPos, Number, PVSurface::right);
+    }
+  }
+
+  // Markierungen zeichnen
+  // ---------------------
+  int    YPos;
+  double MarkOffset = MarkDist / 2;
+
+  for (y = FirstMark; y < MaxY; y += MarkDist)
+  {
+    YPos = MapY(y) + Y;
+    Surface.Line(XOffset, YPos, XPos1, YPos);
+  }
+  FirstMark += (FirstMark - MarkOffset < MinY) ? MarkOffset : -MarkOffset;
+  for (y = FirstMark; y < MaxY; y += MarkDist)
+  {
+    YPos = MapY(y) + Y;
+    Surface.Line(XOffset, YPos, XPos2, YPos);
+  }
+}
+
+
+/******************************************************************************\
+ PVGanttChart: Implementierung
+\******************************************************************************/
+
+PVGanttChart::PVGanttChart(int AdaptRange) :
+  PVCurvesChart  (AdaptRange, true),
+  numStateTables (0),
+  maxStateTables (4)
+{
+  stateTables = new const PDStateTable *[maxStateTables];
+}
+
+
+PVGanttChart::~PVGanttChart(void)
+{
+  delete[] stateTables;
+}
+
+
+void PVGanttChart::AddStateTable(const PDStateTable * StateTable)
+{
+  if (numStateTables == maxStateTables)
+  {
+    const PDStateTable ** grown = new const PDStateTable *[2 * maxStateTables];
+
+    memcpy(grown, stateTables, numStateTables * sizeof(PDStateTable *));
+    delete[] stateTables;
+    stateTables = grown;
+    maxStateTables *= 2;
+  }
+  stateTables[numStateTables++] = StateTable;
+}
+
+
+int PVGanttChart::LeftMargin(PVSurface & Axis) const
+{
+  Axis.SetFont(PVSurface::axisFont);
+  return Axis.TextWidth("xxxxxXXXXX");
+}
+
+
+// Jedes Diagramm liegt um die Zustaende der vorherigen nach oben versetzt
+double PVGanttChart::YOffset(int Curve) const
+{
+  double Offset = 0.0;
+  int    t;
+
+  for (t = 0; t < numStateTables && t < Curve; t++)
+  {
+    Offset += stateTables[t]->GetNumOfStates();
+  }
+  return Offset;
+}
+
+
+void PVGanttChart::Update(SCBoolean Valid)
+{
+  const PDCurve * curve = numEntries ? entries[0].curve : NULL;
+  int             c;
+
+  scroll = -1;
+
+  if (curve && curve->GetNumPoints() > 3)  // Falls ueberhaupt Kurven existieren
+  {
+    // Ermittle Minimum und Maximum aller Kurven
+    // -----------------------------------------
+    PDPoint TMin, TMax; // Temporaere Min/Max Werte
+
+    curve->GetMinMax(TMin, TMax);
+
+    for (c = 1; c < numEntries; c++)
+    {
+      PDPoint CMin, CMax;
+
+      entries[c].curve->GetMinMax(CMin, CMax);
+      if (CMin.x > TMin.x) TMin.x = CMin.x;
+    }
+
+    if (curve->GetNumPoints() < curve->maxPoints) // Approximation des Maximums
+    {
+      TMax.x = TMin.x + ((TMax.x - TMin.x) * curve->maxPoints) /
+                        curve->GetNumPoints();
+    }
+
+    TMin.y = 0;
+    TMax.y = YOffset(numStateTables);
+
+    // Autoskalierung
+    // --------------
+    AdaptX(TMin, TMax, Valid);
+
+    // Eigentlich muss immer dann ein Update durchgefuehrt werden, wenn ein
+    // neuer Zustandsname entdeckt wird. Leider fehlt die Zeit fuer eine
+    // Routine, die diese Situation entdecken kann.
+
+    if (TMax.y > max.y)
+    {
+      max.y = TMax.y;
+      mapY.SetDistPos(max.y);
+      yAxisDirty = true;
+    }
+    else
+    {
+      yAxisDirty = false;
+    }
+  }
+}
+
+
+// Ein Strich und der Name je Zustand
+void PVGanttChart::DrawYAxis(PVSurface & Surface, int X, int Y,
+                             int, int) const
+{
+  Surface.SetFont(PVSurface::axisFont);
+
+  const int    XOffset = X - 3;
+  const int    XTxPos  = XOffset - 5;
+  const int    XPos    = XOffset - 4;
+  const int    YTxPos  = Surface.Ascent() / 2;
+  const char * stateName;
+  int          t, i;
+  int          y = 1;
+  int          YPos;
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::foreground));
+
+  for (t = 0; t < numStateTables; t++)
+  {
+    if (stateTables[t]->GetNumOfStates() > 0)
+    {
+      for (i = stateTables[t]->GetMinStateID();
+           i <= stateTables[t]->GetMaxStateID();
+           i++, y++)
+      {
+        YPos = MapY(y) + Y;
+
+        Surface.Line(XOffset, YPos, XPos, YPos);
+        if ((stateName = PEObjectNames::Get(SC_STATE, i)))
+        {
+          Surface.Text(XTxPos, YPos + YTxPos, stateName, PVSurface::right);
+        }
+      }
+      y++; // Luecke lassen
+    }
+  }
+}
+
+
+/******************************************************************************\
+ PVFreqChart: Implementierung
+\******************************************************************************/
+
+PVFreqChart::PVFreqChart(SCObjectType ObjectType) :
+  objectType     (ObjectType),
+  numEntries     (0),
+  maxEntries     (4),
+  columnsChanged (false),
+  beamWidth      (0),
+  beamColWidth   (0),
+  numVisible     (0),
+  maxBeams       (16)
+{
+  // Konstante Mappingwerte setzen:
+  // Y-Achse 0.0 - 1.1, Ursrpung in 0|0
+  // ----------------------------------
+  mapY.SetOrgPos(0.0);
+  mapY.SetDistPos(1.0);
+  entries = new PVEntry[maxEntries];
+  beams = new PVBeam[maxBeams];
+}
+
+
+PVFreqChart::~PVFreqChart(void)
+{
+  delete[] entries;
+  delete[] beams;
+}
+
+
+void PVFreqChart::AddFrequency(const PDFrequency * Frequency,
+                               unsigned long       Color)
+{
+  if (numEntries == maxEntries)
+  {
+    PVEntry * grown = new PVEntry[2 * maxEntries];
+
+    memcpy(grown, entries, numEntries * sizeof(PVEntry));
+    delete[] entries;
+    entries = grown;
+    maxEntries *= 2;
+  }
+  entries[numEntries].frequency = Frequency;
+  entries[numEntries].color = Color;
+  numEntries++;
+}
+
+
+// Spaltenbreiten aus der Breite des Datenbereichs
+void PVFreqChart::Columns(void)
+{
+  if (numVisible)
+  {
+    beamColWidth = width / numVisible;
+    beamWidth = (beamColWidth - colDist) / numEntries - beamDist;
+  }
+}
+
+
+void PVFreqChart::Resize(int Width, int Height)
+{
+  width = Width;
+  height = Height;
+
+  mapY.SetOrgPixel(height - 1);
+  mapY.SetDistPixel(-(height - 16)); // Rand falls 100% erreicht werden
+  Columns();
+}
+
+
+void PVFreqChart::Update(SCBoolean)
+{
+  const PDFrequency * first = numEntries ? entries[0].frequency : NULL;
+  int                 oldNumVisible = numVisible;
+  int                 i;
+
+  numVisible = 0;
+  for (i = 0; first && i < first->NumUsed(); i++)
+  {
+    if (first->GetRelVal(first->IdAt(i)) != 0.0)
+      numVisible++;
+  }
+  Columns();
+
+  columnsChanged = (numVisible != oldNumVisible);
+}
+
+
+// Loescht den Bereich ueber einem Balken bis auf den Text mit der
+// Prozentangabe (TxWidth 0: ohne Text)
+void PVFreqChart::WhiteOut(PVSurface & Surface, int XPos, int YPos,
+                           int TxWidth, int TxHeight) const
+{
+  // Feintuning fehlt noch, aber andere Sachen sind erst mal wichtiger
+
+  const int x0 = XPos - 1;
+  const int w0 = beamWidth + beamDist;
+  const int h0 = YPos - TxHeight;
+
+  // Diese etwas komplizierte Formel sorgt dafuer, dass die gleichen
+  // Rundungsfehler wie beim zentrieren des Strings auftreten.
+  // Vielleicht faellt jemandem ja eine logischere Formel ein.
+
+  const int w1 = (w0 >> 1) - (TxWidth >> 1);
+  const int x2 = XPos + w1 + TxWidth - 1;
+
+  Surface.FillRect(x0, 0, w0, h0);
+  Surface.FillRect(x0, h0, w1, TxHeight);
+  Surface.FillRect(x2, h0, XPos + beamWidth + beamDist - x2, TxHeight);
+}
+
+
+void PVFreqChart::Draw(PVSurface & Surface, int X, int Y)
+{
+  static const char Wide[]  = "%.1f%%";
+  static const char Small[] = "%.0f%%";
+  int               numBeams = 0;
+  int               f, j, k, XPos;
+  double            value;
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::selected));
+  Surface.FillRect(X, Y, width, height);
+  if (!numVisible) return;
+
+  if (numEntries * numVisible > maxBeams)
+  {
+    delete[] beams;
+    while (maxBeams < numEntries * numVisible) maxBeams *= 2;
+    beams = new PVBeam[maxBeams];
+  }
+
+  // Farbige Balken zeichnen
+  // -----------------------
+  for (f = 0; f < numEntries; f++)
+  {
+    const PDFrequency * frequency = entries[f].frequency;
+
+    Surface.SetColor(entries[f].color);
+    XPos = f * (beamWidth + beamDist) + beamDist;
+    for (j = 0, k = 0; j < frequency->NumUsed() && k < numVisible; j++)
+    {
+      if ((value = frequency->GetRelVal(frequency->IdAt(j))) > 0.0)
+      {
+        PVBeam & beam = beams[numBeams++];
+
+        beam.x = XPos;
+        beam.y = mapY(value);
+        beam.value = value;
+        Surface.FillRect(X + beam.x, Y + beam.y, beamWidth, height - beam.y);
+        XPos += beamColWidth;
+        k++;
+      }
+    }
+  }
+
+  // Prozentangaben ueber den Balken plazieren, dann den Hintergrund
+  // darueber und daneben loeschen (auch ueberstehende Nachbartexte)
+  // ---------------------------------------------------------------
+  Surface.SetFont(PVSurface::boldFont);
+
+  const int wideTxWidth  = Surface.TextWidth("00.0%") - beamDist;
+  const int txHeight     = Surface.Ascent() + Surface.Descent();
+
+  Surface.SetFont(PVSurface::mediumFont);
+
+  const int smallTxWidth = Surface.TextWidth("00%") - beamDist;
+  const int XOffset      = beamWidth / 2;
+
+  if (beamWidth >= smallTxWidth)
+  {
+    const char * Format = (beamWidth >= wideTxWidth) ? Wide : Small;
+    char         Perc[16];
+    int          YPos;
+
+    Surface.SetFont(beamWidth >= wideTxWidth ? PVSurface::boldFont :
+                                               PVSurface::mediumFont);
+    Surface.SetColor(Surface.MotifColor(PVSurface::foreground));
+    for (j = 0; j < numBeams; j++)
+    {
+      sprintf(Perc, Format, beams[j].value * 100);
+      YPos = beams[j].y - Surface.Descent();
+      if (YPos - Surface.Ascent() < 1) YPos = Surface.Ascent() + 1;
+      Surface.Text(X + beams[j].x + XOffset, Y + YPos, Perc, PVSurface::center);
+    }
+  }
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::selected));
+  for (j = 0; j < numBeams; j++)
+  {
+    char Perc[16];
+    int  TxWidth = 0;
+
+    if (beamWidth >= smallTxWidth)
+    {
+      sprintf(Perc, beamWidth >= wideTxWidth ? Wide : Small,
+              beams[j].value * 100);
+      TxWidth = Surface.TextWidth(Perc);
+    }
+    WhiteOut(Surface, X + beams[j].x, Y + beams[j].y, TxWidth, txHeight);
+  }
+}
+
+
+// Namen der Objekte unter den Spalten
+void PVFreqChart::DrawXAxis(PVSurface & Surface, int X, int Y,
+                            int, int Height) const
+{
+  const PDFrequency * first = numEntries ? entries[0].frequency : NULL;
+  const char *        name;
+  int                 XPos, YPos, k;
+
+  if (!first || !numVisible) return;
+
+  Surface.SetFont(PVSurface::axisFont);
+  Surface.SetColor(Surface.MotifColor(PVSurface::foreground));
+  XPos = X - 4 + beamColWidth / 2;
+  YPos = Y + Height + 2 + Surface.Ascent() + 2;
+
+  for (k = 0; k < first->NumUsed(); k++)
+  {
+    int i = first->IdAt(k);
+
+    if (first->GetRelVal(i) > 0.0)
+    {
+      if ((name = PEObjectNames::Get(objectType, i)))
+      {
+        Surface.Text(XPos, YPos, name, PVSurface::center);
+      }
+      XPos += beamColWidth;
+    }
+  }
+}
+
+
+// 0% bis 100% in Schritten von 20%, dazwischen kurze Markierungen
+void PVFreqChart::DrawYAxis(PVSurface & Surface, int X, int Y,
+                            int, int) const
+{
+  Surface.SetFont(PVSurface::axisFont);
+
+  const int XOffset = X - 3;
+  const int XTxPos  = XOffset - 5;
+  const int XPos1   = XOffset - 4;
+  const int XPos2   = XOffset - 2;
+  const int YTxPos  = Y + Surface.Ascent() / 2;
+  char      Percent[8];
+  int       p, YPos;
+
+  Surface.SetColor(Surface.MotifColor(PVSurface::foreground));
+  for (p = 0; p <= 100; p += 20)
+  {
+    sprintf(Percent, "%i%%", p);
+    Surface.Text(XTxPos, mapY(p / 100.0) + YTxPos, Percent, PVSurface::right);
+  }
+
+  // Markierungen zeichnen
+  // ---------------------
+  for (p = 0; p <= 100; p += 10)
+  {
+    YPos = mapY(p / 100.0) + Y;
+    Surface.Line(XOffset, YPos, p % 20 ? XPos2 : XPos1, YPos);
+  }
+}
@@ -0,0 +1,276 @@
+/******************************************************************************\
+ Datei : PVChart.h
+ Inhalt: Deklaration der Diagramme, die die X-Displays und die Plots
+         zeichnen: PVChart, PVCurvesChart, PVGanttChart, PVFreqChart
+ Status:
+\******************************************************************************/
+
+#ifndef __PVCHART_H
+#define __PVCHART_H
+
+#include <SCL/SCBasicTypes.h>
+
+#ifndef __PVMAPPER_H
+#include "PVMapper.h"
+#endif
+#ifndef __PVSURFACE_H
+#include "PVSurface.h"
+#endif
+#ifndef __PDDATATYPE_H
+#include "PDDataType.h"
+#endif
+
+/******************************************************************************\
+ PVChart: Skalierung, Datenbereich und Achsen eines Diagramms unabhaengig
+   davon, wohin gezeichnet wird. Ein Rahmen (PVFrameDisplay, PVPlot) ist so
+   aufgeteilt: links LeftMargin, rechts und oben margin, unten BottomMargin
+   fuer die Achsen; der vertiefte Rand liegt 2, der Datenbereich (Width x
+   Height) 4 Pixel innerhalb. Gezeichnet wird immer relativ zur linken oberen
+   Ecke X, Y des Datenbereichs auf der jeweiligen Flaeche.
+     Resize teilt die Groesse des Datenbereichs mit, Update passt die
+   Skalierung an die aktuellen Daten an. Valid gibt an, ob das zuletzt
+   gezeichnete Bild noch gilt; nur dann darf Update die X-Achse um ganze
+   Pixel weiterruecken, statt sie neu auszurichten.
+\******************************************************************************/
+
+class PVChart
+{
+  public:
+    enum {margin = 5};        // rechter und oberer Rand eines Rahmens
+
+    virtual ~PVChart(void) {}
+
+    virtual int  LeftMargin(PVSurface & Axis) const = 0;
+    virtual int  BottomMargin(void) const = 0;
+
+    virtual void Resize(int Width, int Height) = 0;
+    virtual void Update(SCBoolean Valid) = 0;
+
+    virtual void Draw(PVSurface & Surface, int X, int Y) = 0; // Datenbereich
+    virtual void DrawXAxis(PVSurface & Surface, int X, int Y,
+                           int Width, int Height) const = 0;
+    virtual void DrawYAxis(PVSurface & Surface, int X, int Y,
+                           int Width, int Height) const = 0;
+
+    int GetWidth(void) const  {return width;}
+    int GetHeight(void) const {return height;}
+
+  protected:
+    PVChart(void) : width(0), height(0) {}
+
+    int width;                // Groesse des Datenbereichs
+    int height;
+};
+
+
+/******************************************************************************\
+ PVCurvesChart: 2D-Kurven mit schrittweiser Autoskalierung: Die X-Achse wird
+   erst neu skaliert, wenn das Ende der Kurven den Adaptionsbereich verlaesst,
+   die Y-Achse erst, wenn Minimum oder Maximum ihn verlassen.
+     Neben dem vollstaendigen Zeichnen (Draw) kann ein Puffer, der den
+   Datenbereich enthaelt, fortgeschrieben werden: Hat Update die Achse nur
+   um GetScroll() Pixel weitergerueckt, verschiebt der Besitzer das Bild
+   und DrawTail zeichnet das Ende der Kurven neu.
+\******************************************************************************/
+
+class PVCurvesChart: public PVChart
+{
+  public:
+    PVCurvesChart(int AdaptRange, SCBoolean FixedBottom = false,
+                  SCBoolean WholeRun = false);
+    ~PVCurvesChart(void);
+
+    void AddCurve(const PDCurve * Curve, unsigned long Color);
+
+    int  LeftMargin(PVSurface & Axis) const;
+    int  BottomMargin(void) const {return 16;}
+
+    void Resize(int Width, int Height);
+    void Update(SCBoolean Valid);
+
+    void Draw(PVSurface & Surface, int X, int Y);
+    int  DrawTail(PVSurface & Surface); // linker Rand oder -1: alles neu
+    void DrawXAxis(PVSurface & Surface, int X, int Y,
+                   int Width, int Height) const;
+    void DrawYAxis(PVSurface & Surface, int X, int Y,
+                   int Width, int Height) const;
+
+    // Skalierungsinformation
+    // ----------------------
+    int MapX(double XPos) const {return mapX(XPos);}
+    int MapY(double YPos) const {return mapY(YPos);}
+
+    double GetMinX(void) const {return min.x;}
+    double GetMaxX(void) const {return max.x;}
+    double GetMinY(void) const {return min.y;}
+    double GetMaxY(void) const {return max.y;}
+
+    SCBoolean YAxisDirty(void) const {return yAxisDirty;}
+    SCBoolean IsWholeRun(void) const {return wholeRun;}
+    int       GetScroll(void) const  {return scroll;} // -1: neu zeichnen
+
+  protected:
+    struct PVEntry
+    {
+      const PDCurve * curve;
+      unsigned long   color;
+    };
+
+    void Rescale(PDPoint& TMin, PDPoint& TMax); // Y-Autoskalierung
+    void SetOrgX(double OrgX, SCBoolean Valid); // X-Ursprung
+    void AdaptX(const PDPoint& TMin, const PDPoint& TMax, SCBoolean Valid);
+
+    virtual double YOffset(int) const {return 0.0;} // Versatz der n-ten Kurve
+
+    PVEntry *       entries;
+    int             numEntries;
+    int             maxEntries;
+
+    // Skalierungsobjekte fuer X und Y Dimension
+    // ----------------------------------------
+    PVMapper        mapX; // X-Koordinaten Abbildung
+    PVMapper        mapY; // Y-Koordinaten Abbildung
+    PDPoint         min;  // linke untere Ecke des virtuellen Koordinatensystems
+    PDPoint         max;  // obere rechte Ecke des virtuellen Koordinatensystems
+
+    // Steuerung der Autoskalierung
+    // ----------------------------
+    const SCBoolean fixedBottom;
+    const SCBoolean wholeRun;        // gesamten Verlauf statt letzter Punkte
+    const int       adaptRange;      // Adaptionsbereich in Prozent (0..100);
+    int             leftAdaptRange;  // Linke und
+    int             rightAdaptRange; // rechte Grenze fuer Autoskalierung
+    int             lowerBottomAdaptRange;
+    int             lowerTopAdaptRange;
+    int             upperBottomAdaptRange;
+    int             upperTopAdaptRange;
+    SCBoolean       yAxisDirty;
+
+    // Fortschreiben: Abbildung und je Kurve X-Wert des letzten Punkts beim
+    // letzten Zeichnen, Verschiebung seitdem
+    // --------------------------------------------------------------------
+    int             scroll;      // Verschiebung seit dem Zeichnen, -1: neu
+    PVMapper        drawnX;      // X-Abbildung beim letzten Zeichnen
+    double *        lastX;       // je Kurve X-Wert des letzten Punkts
+    int             numDrawn;    // Kurven beim letzten Draw
+
+    // Puffer, wachsen nur
+    // -------------------
+    PVPoint *       points;      // Linienzug einer Kurve
+    int             maxPoints;
+    short *         xRow;        // abgebildete Zeitspalte eines PDCurveStore
+    int             maxXRow;
+    PDPoint *       runPoints;   // gesamter Verlauf (PDCurveHistory)
+    int             maxRunPoints;
+
+  private:
+    PVPoint * GetPoints(int Num);
+    short *   GetXRow(int Num);
+    PDPoint * GetRunPoints(int Num);
+    void      DrawCurve(PVSurface & Surface, const PDCurve * Curve, int From,
+                        double Offset, int X, int Y);
+};
+
+
+/******************************************************************************\
+ PVGanttChart: Gantt-Diagramme nach [Klar]: je Kurve ein Diagramm mit einer
+   Zeile je Zustand, jedes um die Zustaende der vorherigen nach oben versetzt.
+   Die Y-Achse waechst nur.
+\******************************************************************************/
+
+class PVGanttChart: public PVCurvesChart
+{
+  public:
+    PVGanttChart(int AdaptRange);
+    ~PVGanttChart(void);
+
+    void AddStateTable(const PDStateTable * StateTable); // je Kurve eine
+
+    int  LeftMargin(PVSurface & Axis) const;
+    void Update(SCBoolean Valid);
+    void DrawYAxis(PVSurface & Surface, int X, int Y,
+                   int Width, int Height) const;
+
+  protected:
+    double YOffset(int Curve) const; // Zeilen der vorherigen Diagramme
+
+  private:
+    const PDStateTable ** stateTables;
+    int                   numStateTables;
+    int                   maxStateTables;
+};
+
+
+/******************************************************************************\
+ PVFreqChart: Staebchendiagramm von Haeufigkeitszaehlern. An der Y-Achse wird
+   die prozentuale Haeufigkeit aufgetragen, an der X-Achse die Namen der
+   Objekte; die Spalten richten sich nach den Werten des ersten Zaehlers.
+\******************************************************************************/
+
+class PVFreqChart: public PVChart
+{
+  public:
+    PVFreqChart(SCObjectType ObjectType);
+    ~PVFreqChart(void);
+
+    void AddFrequency(const PDFrequency * Frequency, unsigned long Color);
+
+    int  LeftMargin(PVSurface &) const {return 35;} // experimentell ermittelt
+    int  BottomMargin(void) const {return 15;}
+
+    void Resize(int Width, int Height);
+    void Update(SCBoolean Valid);
+
+    void Draw(PVSurface & Surface, int X, int Y);
+    void DrawXAxis(PVSurface & Surface, int X, int Y,
+                   int Width, int Height) const;
+    void DrawYAxis(PVSurface & Surface, int X, int Y,
+                   int Width, int Height) const;
+
+    // true, wenn sich beim letzten Update die Spalten geaendert haben
+    SCBoolean ColumnsChanged(void) const {return columnsChanged;}
+
+  private:
+    struct PVEntry
+    {
+      const PDFrequency * frequency;
+      unsigned long       color;
+    };
+
+    const SCObjectType objectType;
+    PVEntry *          entries;
+    int                numEntries;
+    int                maxEntries;
+    SCBoolean          columnsChanged;
+
+    // Variablen zur X-Skalierung
+    // ---------------------------
+    enum
+    {
+      colDist = 5,  // Pixel-Abstand zwischen Balkenspalten
+      beamDist = 2  // Pixel-Abstand zwischen Balken in Spalten
+    };
+    int         beamWidth;    // Pixel-Breite eines Balkens + 2
+    int         beamColWidth; // Pixel-Abstand zwischen den Spalten
+    int         numVisible;   // Anzahl sichtbarer Balken je Zaehler
+
+    // Y-Skalierung
+    // ------------
+    PVMapper mapY;
+
+    // Balken und Prozentangaben (je Balken)
+    // -------------------------------------
+    struct PVBeam
+    {
+      int    x, y;
+      double value;
+    };
+    PVBeam *    beams;
+    int         maxBeams;
+
+    void Columns(void);
+    void WhiteOut(PVSurface & Surface, int XPos, int YPos, int TxWidth,
+                  int TxHeight) const;
+};
+
+#endif
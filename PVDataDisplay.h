@@ -17,8 +17,8 @@
 #ifndef __PVDISPLAY_H
 #include "PVDisplay.h"
 #endif
-#ifndef __PVMAPPER_H
-#include "PVMapper.h"
+#ifndef __PVCHART_H
+#include "PVChart.h"
 #endif
 #ifndef __PDDATATYPE_H
 #include "PDDataType.h"
@@ -33,7 +33,7 @@ class PVDataDisplay: public PVSubDisplay
 { 
   public:
     
-    void AddDataType(T * ToAdd) 
+    virtual void AddDataType(T * ToAdd) 
     {
       dataList.InsertAfter(ToAdd);
     }
@@ -41,6 +41,19 @@ class PVDataDisplay: public PVSubDisplay
     typedef SCListIter<T> DataIter;
   
     const SCList<T> &  GetDataList(void) const { return dataList; }
+
+    // Summe der Versionen aller Datentypen; sie wachsen nur, also aendert
+    // sich die Summe genau dann, wenn sich einer geaendert hat
+    unsigned long GetDataVersion(void) const
+    {
+      unsigned long Version = 0;
+      DataIter      iter(dataList);
+      T *           data;
+
+      for (data = iter++; data; data = iter++)
+        Version += data->GetVersion();
+      return Version;
+    }
     
   protected:
     PVDataDisplay(Display* XDisplay) : PVSubDisplay(XDisplay), dataList(false) {}
@@ -70,7 +83,8 @@ class PVDataFrame: public PVFrameDisplay
 
 
 /******************************************************************************\ 
- PVCurvesFrame: Rahmenfenster zur Darstellung von 2D-Kurven. 
+ PVCurvesFrame: Rahmenfenster zur Darstellung von 2D-Kurven. Skalierung und
+   Achsen liefert das PVCurvesChart des SubDisplays.
 \******************************************************************************/    
 
 class PVCurvesDisplay;
@@ -81,7 +95,8 @@ class PVCurvesFrame: public PVDataFrame<PDCurve>
     PVCurvesFrame(Display*      XDisplay, 
                   const char *  Name,
                   int           AdjustRange,
-                  SCBoolean     FixedBottom = false);
+                  SCBoolean     FixedBottom = false,
+                  SCBoolean     WholeRun = false);
 
     // Redefinierte virtuelle Funktionen
     // --------------------------------
@@ -95,68 +110,47 @@ class PVCurvesFrame: public PVDataFrame<PDCurve>
     void DrawXAxis(void);  
     void DrawYAxis(void);
      
-  private:  
     PVCurvesDisplay * GetCurvesDisplay(void) const;    
 };    
 
 
 /******************************************************************************\ 
- PVCurvesDisplay: Private Subklasse fuer PVCurvesDisplay
+ PVCurvesDisplay: Private Subklasse fuer PVCurvesFrame. Die Kurven liegen als
+   Bild im Puffer (xBuf); hat das Diagramm die X-Achse nur um ganze Pixel
+   weitergerueckt, wird das Bild verschoben und nur das Ende neu gezeichnet.
 \******************************************************************************/    
 
 class PVCurvesDisplay: public PVDataDisplay<PDCurve>
 {
   public: 
+  ~PVCurvesDisplay(void);
+
+  void AddDataType(PDCurve * ToAdd);
 
   // Redefinierte Funktionen eines Displays
   // --------------------------------------
-  void Paint(void);   // => Skalierung bleibt konstant
+  void Paint(void);   // => zeichnet alle Kurven neu
   void Resized(void); // => Skalierungsaenderung moeglich
   void Update(void);  // => Skalierungsaenderung moeglich
   
-  // Skalierungsinformation
-  // ----------------------
-  int MapX(double XPos) const {return mapX(XPos);}
-  int MapY(double YPos) const {return mapY(YPos);}
-
-  double GetMinX(void) const {return min.x;}
-  double GetMaxX(void) const {return max.x;}
-  double GetMinY(void) const {return min.y;}
-  double GetMaxY(void) const {return max.y;}
-
-  SCBoolean YAxisDirty(void) const {return yAxisDirty;}
+  PVCurvesChart * GetChart(void) const {return chart;}
 
 protected:  
 
-  PVCurvesDisplay(Display* XDisplay, int AdaptRange, SCBoolean FixedBottom);
-  friend PVCurvesFrame::PVCurvesFrame(Display*, const char *, int, SCBoolean);
+  void Render(SCBoolean Incremental); // xBuf aktualisieren, Aenderung vermerken
 
-  // Skalierungsobjekte fuer X und Y Dimension
-  // ----------------------------------------
-  PVMapper        mapX; // X-Koordinaten Abbildung
-  PVMapper        mapY; // Y-Koordinaten Abbildung
-  PDPoint         min;  // linke untere Ecke des virtuellen Koordinatensystems
-  PDPoint         max;  // obere rechte Ecke des virtuellen Koordinatensystems
-  
-  // Steuerung der Autoskalierung
-  // ----------------------------
-  const SCBoolean fixedBottom;
-  const int       adaptRange;      // Adaptionsbereich in Prozent (0..100);
-  int             leftAdaptRange;  // Linke und 
-  int             rightAdaptRange; // rechte Grenze fuer Autoskalierung
-  int             lowerBottomAdaptRange;
-  int             lowerTopAdaptRange;
-  int             upperBottomAdaptRange;
-  int             upperTopAdaptRange;
-  SCBoolean       yAxisDirty;
+  PVCurvesDisplay(Display* XDisplay, PVCurvesChart * Chart);
+  friend PVCurvesFrame::PVCurvesFrame(Display*, const char *, int, SCBoolean,
+                                      SCBoolean);
+  friend class PVGanttFrame;
+
+  PVCurvesChart * const chart; // Skalierung, Kurven und Achsen
 };
 
 /******************************************************************************\ 
- PVGanttFrame: Gantt-Diagramme nach [Klar]
+ PVGanttFrame: Gantt-Diagramme nach [Klar] (PVGanttChart)
 \******************************************************************************/    
 
-class PVGanttDisplay;
-
 class PVGanttFrame: public PVCurvesFrame
 {
   public:
@@ -166,42 +160,15 @@ class PVGanttFrame: public PVCurvesFrame
   
     void AddStateTable(const PDStateTable * StateTable);
     
-  protected:
-    void DrawYAxis(void);
-    
   private:  
-    PVGanttDisplay * GetGanttDisplay(void) const;    
-};
-
-
-/******************************************************************************\ 
- PVGanttDisplay: 
-\******************************************************************************/    
-
-class PVGanttDisplay: public PVCurvesDisplay
-{
-    friend class PVGanttFrame;
-    
-  public: 
-
-    // Redefinierte Funktionen eines Displays
-    // --------------------------------------
-    void Paint(void);   
-    void Update(void);  
-
-  protected:  
-    PVGanttDisplay(Display* XDisplay, int AdaptRange);
-
-  private:
-    SCList<PDStateTable> stateTableList;
-//    typedef SCListIter<PDNameTable> TStateIter;
+    PVGanttChart * GetGanttChart(void) const;    
 };
 
 
 /******************************************************************************\ 
  PVFreqFrame: Rahmen eine Haeufigkeitszaehlers. An der Y-Achse wird die 
    prozentuale Haeufigkeit aufgetragen, an der X-Achse die Name der Typen, deren
-   Haeufigkeit ermittelt wurden.
+   Haeufigkeit ermittelt wurden (PVFreqChart).
 \******************************************************************************/    
 
 class PVFreqDisplay;
@@ -222,8 +189,6 @@ class PVFreqFrame: public PVDataFrame<PDFrequency>
     void DrawYAxis(void);
   
   private:   
-    const SCObjectType objectType;
-
     PVFreqDisplay* GetFreqDisplay(void) const; // Cast von sub nach FreqDisplay
 };
 
@@ -236,53 +201,24 @@ class PVFreqDisplay: public PVDataDisplay<PDFrequency>
 {
   public:
 
+    void AddDataType(PDFrequency * ToAdd);
+
     // Redefinierte Funktionen eines Displays
     // --------------------------------------
     void Paint(void);   // => Skalierung bleibt konstant
     void Resized(void); // => Skalierungsaenderung
     void Update(void);  // => moegliche nderung der Balkenskalierung
 
-    // Einige Funktionen die vor allem fuer PVFreqFrame Display gedacht
-    // sind, um die Achsenbeschriftung zu implementieren
-    // ---------------------------------------------------------------
-    int       GetMaxCol(void) const   { return maxNum; }
-    int       GetColWidth(void) const { return beamColWidth; }
-    SCBoolean UpdateFrame(void) const { return updateFrame; }
-    int       MapY(double p) const    { return mapY(p); }
-    
-    PDFrequency * GetDataType (void);
+    PVFreqChart * GetChart(void) const {return chart;}
 
   protected:
   
-    PVFreqDisplay(Display* XDisplay);
+    PVFreqDisplay(Display* XDisplay, PVFreqChart * Chart);
     ~PVFreqDisplay(void);
     friend PVFreqFrame::PVFreqFrame(Display*, const char *, const SCObjectType);
 
   private:
-    const int wideTxWidth;  // Prozent Textbreite im Langformat
-    const int smallTxWidth; // Prozent Textbreite im Kurzformat
-    const int txHeight;     // Texthoehe, fuer beide Formate
-        
-    SCBoolean updateFrame; // true, wenn Frame sich neuzeichnen muss
-  
-    // Variablen zur X-Skalierung
-    // ---------------------------
-    enum
-    {
-      colDist = 5,  // Pixel-Abstand zwischen Balkenspalten
-      beamDist = 2  // Pixel-Abstand zwischen Balken in Spalten
-    };	  
-    int         numFreqs;     // Anzahl darzustellender Haeufigkeitsobjekte
-    int         maxNum;       // Max Num() aller Freq-Objekte
-    int         beamWidth;    // Pixel-Breite eines Balkens + 2
-    int         beamColWidth; // Pixel-Abstand zwischen Balken eines PDFrequency-Objekts 
-    int         numVisible;   // Anzahl sichtbarer Balken
-    
-    // Y-Skalierung
-    // ------------
-    PVMapper mapY;
-    
-    void InitWhiteOut(XRectangle* WhiteOut, int XPos, int YPos, int TxWidth);
+    PVFreqChart * const chart; // Skalierung, Balken und Achsen
 };
 
 
@@ -1,7 +1,7 @@
 /******************************************************************************\
  Datei : PVDisplay.cpp
  Inhalt: Deklaration der Basisklassen fuer die Anzeige von Leistungsdaten:
-         PVDisplay, PVSubDisplay, PVFrameDisplay 
+         PVXSurface, PVDisplay, PVSubDisplay, PVFrameDisplay
  Autor : Christian Rodemeyer, Marc Diefenbruch
  Datum : 16.08.95
  Status: Farbverwaltung muss noch genauer eingestellt werden
@@ -18,13 +18,140 @@ const char MotifBold[]   = "-adobe-helvetica-bold-r-*-*-12-*-*-*-*-*-*-*";
 const char MotifMedium[] = "-adobe-helvetica-medium-r-*-*-12-*-*-*-*-*-*-*";
 const char AxisFont[]    = "-adobe-helvetica-medium-r-*-*-10-*-*-*-*-*-*-*";
 
+/******************************************************************************\
+ PVXSurface Implementierung
+\******************************************************************************/
+
+// Linienzuege werden ohne Kopie als XPoint-Felder weitergereicht
+typedef char PVPointIsXPoint[sizeof(PVPoint) == sizeof(XPoint) ? 1 : -1];
+
+PVXSurface::PVXSurface(Display* XDisplay, Colormap XCmap, GC XGC,
+                       SCBoolean Mono) :
+  xDpy      (XDisplay),
+  xCmap     (XCmap),
+  xGC       (XGC),
+  xDrawable (None),
+  font      (NULL)
+{
+  mono = Mono;
+  for (int i = 0; i < numMotifColors; i++)
+  {
+    motif[i] = AllocColor(MotifColorName(i, mono));
+  }
+  fonts[axisFont] = fonts[boldFont] = fonts[mediumFont] = NULL;
+}
+
+
+unsigned long PVXSurface::AllocColor(const char * ColorName)
+{
+  XColor e, c;
+
+  XAllocNamedColor(xDpy, xCmap, ColorName, &e, &c);
+
+  return c.pixel;
+}
+
+
+void PVXSurface::SetColor(unsigned long Color)
+{
+  XSetForeground(xDpy, xGC, Color);
+}
+
+
+void PVXSurface::Line(int X1, int Y1, int X2, int Y2)
+{
+  XDrawLine(xDpy, xDrawable, xGC, X1, Y1, X2, Y2);
+}
+
+
+void PVXSurface::Lines(const PVPoint * Points, int Num)
+{
+  XDrawLines(xDpy, xDrawable, xGC, (XPoint *)Points, Num, CoordModeOrigin);
+}
+
+
+void PVXSurface::FillRect(int X, int Y, int Width, int Height)
+{
+  if (Width <= 0 || Height <= 0) return; // XRectangle ist vorzeichenlos
+  XFillRectangle(xDpy, xDrawable, xGC, X, Y, Width, Height);
+}
+
+
+void PVXSurface::Text(int X, int Y, const char * String, int Align)
+{
+  if (Align != left)
+  {
+    int w = TextWidth(String);
+
+    X -= (Align == center) ? w / 2 : w;
+  }
+  XDrawImageString(xDpy, xDrawable, xGC, X, Y, String, strlen(String));
+}
+
+
+void PVXSurface::Clip(int X, int Y, int Width, int Height)
+{
+  if (Width <= 0)
+  {
+    XSetClipMask(xDpy, xGC, None);
+  }
+  else
+  {
+    XRectangle r;
+
+    r.x = X;
+    r.y = Y;
+    r.width = Width;
+    r.height = Height;
+    XSetClipRectangles(xDpy, xGC, 0, 0, &r, 1, YXBanded);
+  }
+}
+
+
+void PVXSurface::SetFont(int Which)
+{
+  font = fonts[Which];
+  if (font) XSetFont(xDpy, xGC, font->fid);
+}
+
+
+int PVXSurface::TextWidth(const char * String) const
+{
+  if (!font) return PVSurface::TextWidth(String);
+  return XTextWidth(font, String, strlen(String));
+}
+
+
+int PVXSurface::Ascent(void) const
+{
+  return font ? font->ascent : (int)ascent;
+}
+
+
+int PVXSurface::Descent(void) const
+{
+  return font ? font->descent : (int)descent;
+}
+
+
+void PVXSurface::SetDashed(SCBoolean Dashed)
+{
+  if (Dashed)
+  {
+    XSetLineAttributes(xDpy, xGC, 0, LineOnOffDash, CapButt, JoinMiter);
+    XSetDashes(xDpy, xGC, 0, "\1\1", 2);
+  }
+  else
+  {
+    XSetLineAttributes(xDpy, xGC, 0, LineSolid, CapButt, JoinMiter);
+  }
+}
+
+
 /******************************************************************************\
  PVDisplay Implementierung
 \******************************************************************************/   
 
-long PVDisplay::color[numColors];
-SCBoolean PVDisplay::colorInit = true;
-
 PVDisplay::PVDisplay(Display* XDisplay, const char * Name) :
   xDpy  (XDisplay),
   xScr  (DefaultScreen(xDpy)),
@@ -33,27 +160,41 @@ PVDisplay::PVDisplay(Display* XDisplay, const char * Name) :
   xGC   (XCreateGC(xDpy, xWin, 0, NULL)),
   xCmap (DefaultColormap(xDpy, xScr)),
   xMono (DefaultDepth(xDpy, xScr) == 1),
+  xSurface (xDpy, xCmap, xGC, xMono),
   
-  mForeground   (AllocColor("Black")),
-  mBackground   (AllocColor(xMono ? "White" : "ivory3")),
-  mSelected     (AllocColor("White")),
-  mTopShadow    (AllocColor("ivory1")),
-  mBottomShadow (AllocColor(xMono ? "Black" : "ivory4")),
-  mHighlight    (AllocColor(xMono ? "Black" : "Yellow")),
+  mForeground   (xSurface.MotifColor(PVSurface::foreground)),
+  mBackground   (xSurface.MotifColor(PVSurface::background)),
+  mSelected     (xSurface.MotifColor(PVSurface::selected)),
+  mTopShadow    (xSurface.MotifColor(PVSurface::topShadow)),
+  mBottomShadow (xSurface.MotifColor(PVSurface::bottomShadow)),
+  mHighlight    (xSurface.MotifColor(PVSurface::highlight)),
   mBold         (XLoadQueryFont(xDpy, MotifBold)),
   mMedium       (XLoadQueryFont(xDpy, MotifMedium)),
+  xBuf          (None),
+  xBufValid     (false),
+  xBackground   (mBackground),
+  drawnVersion  (~0UL),
+  mapped        (false),
+  obscured      (false),
+  numDirty      (0),
   nextUnusedColor (-1)
 {
   XSetBackground(xDpy, xGC, mBackground);
   XSetForeground(xDpy, xGC, mForeground); 
+  XSetGraphicsExposures(xDpy, xGC, false); // Quelle ist immer der Puffer
+  xSurface.SetFontStruct(PVSurface::boldFont, mBold);
+  xSurface.SetFontStruct(PVSurface::mediumFont, mMedium);
 
   XStoreName(xDpy, xWin, Name);
-  XSetWindowBackground(xDpy, xWin, mBackground);
+  // Kein Hintergrund: der Server loescht das Fenster nicht mehr vor einem
+  // Expose, den Inhalt liefert ausschliesslich xBuf (kein Flackern)
+  XSetWindowBackgroundPixmap(xDpy, xWin, None);
 }
 
 
 PVDisplay::~PVDisplay(void)
 {
+  if (xBuf != None) XFreePixmap(xDpy, xBuf);
   XFreeGC(xDpy, xGC);
   XDestroyWindow(xDpy, xWin);
 }
@@ -61,17 +202,13 @@ PVDisplay::~PVDisplay(void)
 
 long PVDisplay::AllocColor(const char * ColorName)
 {
-  XColor e, c;
-
-  XAllocNamedColor(xDpy, xCmap, ColorName, &e, &c);
-
-  return c.pixel;
+  return xSurface.AllocColor(ColorName);
 }
 
 
 long PVDisplay::GetXEventMask(void) const
 {
-  return ExposureMask|StructureNotifyMask;
+  return ExposureMask|StructureNotifyMask|VisibilityChangeMask;
 }
 
 
@@ -88,129 +225,156 @@ void PVDisplay::Resized(void)
   XGetWindowAttributes(xDpy, xWin, &attrib);
   width = attrib.width;
   height = attrib.height;
+
+  // Puffer in der neuen Groesse anlegen; gezeichnet wird er beim Expose
+  if (xBuf != None) XFreePixmap(xDpy, xBuf);
+  xBuf = None;
+  xSurface.SetDrawable(None);
+  xBufValid = false;
+  numDirty = 0;
+  drawnVersion = GetDataVersion() - 1;  // Skalierung beim naechsten Update
+  if (width > 0 && height > 0)
+  {
+    xBuf = XCreatePixmap(xDpy, xWin, width, height, attrib.depth);
+    xSurface.SetDrawable(xBuf);
+    ClearArea(0, 0, width, height);
+    Repaint();
+  }
 }
 
 
 void PVDisplay::Paint(void)
 {
+  ClearArea(0, 0, width, height);
   DrawRaised(0, 0, width, height);
 }
 
 
-// Simulation einer OSF/Motif Oberflche durch eigene Draw-Funktionen
-// ------------------------------------------------------------------
-
-void PVDisplay::DrawSeparator(int Left, int Top, int Width, int Height)
+void PVDisplay::Exposed(const XExposeEvent& Event)
 {
-  int X1  = Left;
-  int X2  = Left + Width;
-  int Y1  = Top;
-  int Y2  = Top + Height;
-  int XI1 = X1 + 1;
-  int XI2 = X2 - 1;
-  int YI1 = Y1 + 1;
-  int YI2 = Y2 - 1;
-  
-  if (xMono)
+  if (xBuf == None) Resized(); // ConfigureNotify ist (noch) nicht gekommen
+  if (xBuf == None) return;
+
+  if (!xBufValid)
   {
-    XSetForeground(xDpy, xGC, mBottomShadow);
-    XSetLineAttributes(xDpy, xGC, 0, LineOnOffDash, CapButt, JoinMiter);
-    XSetDashes(xDpy, xGC, 0, "\1\1", 2);
+    if (Event.count == 0) Redraw(); // erst am Ende einer Expose-Folge
   }
   else
   {
-    XSetForeground(xDpy, xGC, mTopShadow);
+    Invalidate(Event.x, Event.y, Event.width, Event.height);
   }
-  XDrawLine(xDpy, xWin, xGC, XI1, YI1, XI1, YI2); // vert
-  XDrawLine(xDpy, xWin, xGC, XI1, YI1, XI2, YI1); // horz
-  XDrawLine(xDpy, xWin, xGC, X2, Y1, X2, Y2);     // vert
-  XDrawLine(xDpy, xWin, xGC, X1, Y2, X2, Y2);     // horz
-    
-  if (xMono)
-  {
-    XSetLineAttributes(xDpy, xGC, 0, LineSolid, CapButt, JoinMiter); 
-  }  
-  XSetForeground(xDpy, xGC, mBottomShadow);  
-  XDrawLine(xDpy, xWin, xGC, X1, Y1, X1, YI2);    // vert
-  XDrawLine(xDpy, xWin, xGC, X1, Y1, XI2, Y1);    // horz
-  XDrawLine(xDpy, xWin, xGC, XI2, YI1, XI2, YI2); // vert
-  XDrawLine(xDpy, xWin, xGC, XI1, YI2, XI2, YI2); // horz  
 }
 
- 
-void PVDisplay::DrawRaised(int Left, int Top, int Width, int Height)
+
+void PVDisplay::Redraw(void)
 {
-  int X1  = Left;
-  int X2  = Left + Width;
-  int Y1  = Top;
-  int Y2  = Top + Height;
-  int XI1 = X1 + 1;
-  int XI2 = X2 - 1;
-  int YI1 = Y1 + 1;
-  int YI2 = Y2 - 1;
-  
-  if (xMono)
-  {
-    XSetForeground(xDpy, xGC, mBottomShadow);
-    XSetLineAttributes(xDpy, xGC, 0, LineOnOffDash, CapButt, JoinMiter);
-    XSetDashes(xDpy, xGC, 0, "\1\1", 2);
-  }
-  else
+  if (xBuf == None) return;
+
+  Paint();
+  xBufValid = true;
+  numDirty = 0;
+  Invalidate(0, 0, width, height);
+}
+
+
+void PVDisplay::Repaint(void)
+{
+  xBufValid = false;
+  XClearArea(xDpy, xWin, 0, 0, 0, 0, true); // loest nur ein Expose aus
+}
+
+
+void PVDisplay::Flush(void)
+{
+  for (int i = 0; i < numDirty; i++)
   {
-    XSetForeground(xDpy, xGC, mTopShadow);
+    XCopyArea(xDpy, xBuf, xWin, xGC, dirty[i].x, dirty[i].y,
+              dirty[i].width, dirty[i].height, dirty[i].x, dirty[i].y);
   }
-  XDrawLine(xDpy, xWin, xGC, X1, Y1, X1, Y2);     // vert 1
-  XDrawLine(xDpy, xWin, xGC, XI1, YI1, XI1, YI2); // vert 2
-  XDrawLine(xDpy, xWin, xGC, X1, Y1, X2, Y1);     // horz 1
-  XDrawLine(xDpy, xWin, xGC, XI1, YI1, XI2, YI1); // horz 2
-    
-  if (xMono)
-  {
-    XSetLineAttributes(xDpy, xGC, 0, LineSolid, CapButt, JoinMiter); 
-  }  
-  XSetForeground(xDpy, xGC, mBottomShadow);  
-  XDrawLine(xDpy, xWin, xGC, XI1, YI2, XI2, YI2);  // horz 1
-  XDrawLine(xDpy, xWin, xGC, X1, Y2, X2, Y2);      // horz 2
-  XDrawLine(xDpy, xWin, xGC, XI2, YI1, XI2, YI2);  // vert 1
-  XDrawLine(xDpy, xWin, xGC, X2, Y1, X2, Y2);      // vert 2 
+  numDirty = 0;
 }
 
 
-void PVDisplay::DrawLowered(int Left, int Top, int Width, int Height)
+void PVDisplay::ClearArea(int Left, int Top, int Width, int Height)
 {
-  int X1  = Left;
-  int X2  = Left + Width - 1;
-  int Y1  = Top;
-  int Y2  = Top + Height - 1; 
-  int XI1 = X1 + 1;
-  int XI2 = X2 - 1;
-  int YI1 = Y1 + 1;
-  int YI2 = Y2 - 1;
-  
-  if (xMono)
+  XSetForeground(xDpy, xGC, xBackground);
+  XFillRectangle(xDpy, xBuf, xGC, Left, Top, Width, Height);
+}
+
+
+// Vereinigt R mit dem Rechteck (Left, Top, Width, Height)
+static void Unite(XRectangle& R, int Left, int Top, int Width, int Height)
+{
+  int right  = R.x + R.width;
+  int bottom = R.y + R.height;
+
+  if (Left + Width > right)   right = Left + Width;
+  if (Top + Height > bottom)  bottom = Top + Height;
+  if (Left < R.x) R.x = Left;
+  if (Top < R.y)  R.y = Top;
+  R.width  = right - R.x;
+  R.height = bottom - R.y;
+}
+
+
+void PVDisplay::Invalidate(int Left, int Top, int Width, int Height)
+{
+  int i;
+
+  if (Left < 0) {Width += Left; Left = 0;}
+  if (Top < 0)  {Height += Top; Top = 0;}
+  if (Left + Width > width)  Width = width - Left;
+  if (Top + Height > height) Height = height - Top;
+  if (Width <= 0 || Height <= 0) return;
+
+  // Mit einem beruehrenden oder ueberlappenden Bereich vereinigen
+  for (i = 0; i < numDirty; i++)
   {
-    XSetForeground(xDpy, xGC, mBottomShadow);
-    XSetLineAttributes(xDpy, xGC, 0, LineOnOffDash, CapButt, JoinMiter);
-    XSetDashes(xDpy, xGC, 0, "\1\1", 2);
+    if (Left <= dirty[i].x + dirty[i].width && dirty[i].x <= Left + Width &&
+        Top <= dirty[i].y + dirty[i].height && dirty[i].y <= Top + Height)
+    {
+      Unite(dirty[i], Left, Top, Width, Height);
+      return;
+    }
   }
-  else
+
+  if (numDirty == maxDirty) // alle Bereiche zusammenfassen
   {
-    XSetForeground(xDpy, xGC, mTopShadow);
+    for (i = 1; i < numDirty; i++)
+    {
+      Unite(dirty[0], dirty[i].x, dirty[i].y, dirty[i].width, dirty[i].height);
+    }
+    Unite(dirty[0], Left, Top, Width, Height);
+    numDirty = 1;
+    return;
   }
-  XDrawLine(xDpy, xWin, xGC, XI1, YI2, XI2, YI2);  // horz 1
-  XDrawLine(xDpy, xWin, xGC, X1, Y2, X2, Y2);      // horz 2
-  XDrawLine(xDpy, xWin, xGC, XI2, YI1, XI2, YI2);  // vert 1
-  XDrawLine(xDpy, xWin, xGC, X2, Y1, X2, Y2);      // vert 2 
-  
-  if (xMono)
-  {
-    XSetLineAttributes(xDpy, xGC, 0, LineSolid, CapButt, JoinMiter); 
-  }  
-  XSetForeground(xDpy, xGC, mBottomShadow);  
-  XDrawLine(xDpy, xWin, xGC, X1, Y1, X1, Y2);     // vert 1
-  XDrawLine(xDpy, xWin, xGC, XI1, YI1, XI1, YI2); // vert 2
-  XDrawLine(xDpy, xWin, xGC, X1, Y1, X2, Y1);     // horz 1
-  XDrawLine(xDpy, xWin, xGC, XI1, YI1, XI2, YI1); // horz 2
+
+  dirty[numDirty].x      = Left;
+  dirty[numDirty].y      = Top;
+  dirty[numDirty].width  = Width;
+  dirty[numDirty].height = Height;
+  numDirty++;
+}
+
+
+// Simulation einer OSF/Motif Oberflche durch eigene Draw-Funktionen
+// ------------------------------------------------------------------
+
+void PVDisplay::DrawSeparator(int Left, int Top, int Width, int Height)
+{
+  xSurface.DrawSeparator(Left, Top, Width, Height);
+}
+
+ 
+void PVDisplay::DrawRaised(int Left, int Top, int Width, int Height)
+{
+  xSurface.DrawRaised(Left, Top, Width, Height);
+}
+
+
+void PVDisplay::DrawLowered(int Left, int Top, int Width, int Height)
+{
+  xSurface.DrawLowered(Left, Top, Width, Height);
 }
 
 
@@ -220,7 +384,7 @@ int PVDisplay::DrawCenteredString(XFontStruct* Font, const char * ToDraw,
   int l = strlen(ToDraw);
   int w = XTextWidth(Font, ToDraw, l);
 
-  XDrawImageString(xDpy, xWin, xGC, CX - w / 2, Y, ToDraw, l);
+  XDrawImageString(xDpy, xBuf, xGC, CX - w / 2, Y, ToDraw, l);
 
   return w;
 }
@@ -232,7 +396,7 @@ int PVDisplay::DrawRightString(XFontStruct* Font, const char * ToDraw,
   int l = strlen(ToDraw);
   int w = XTextWidth(Font, ToDraw, l);
 
-  XDrawImageString(xDpy, xWin, xGC, RX - w, Y, ToDraw, l);
+  XDrawImageString(xDpy, xBuf, xGC, RX - w, Y, ToDraw, l);
 
   return w;
 }
@@ -241,14 +405,7 @@ int PVDisplay::DrawRightString(XFontStruct* Font, const char * ToDraw,
 long PVDisplay::GetColor(const char * ColorName)
 {
   if (xMono) return AllocColor("Black");
-  if (ColorName == NULL)
-  {
-    if (++nextUnusedColor == numColors) nextUnusedColor = 0;
-    return color[nextUnusedColor];
-  }
-  else {
-    return AllocColor(ColorName);
-  }
+  return AllocColor(PVSurface::ColorName(ColorName, nextUnusedColor));
 } 
 
 
@@ -264,46 +421,31 @@ SCStream& operator<< (SCStream& pStream, const PVDisplay&)
 PVSubDisplay::PVSubDisplay(Display* XDisplay) : 
   PVDisplay(XDisplay, "SubWindow")
 {
-  XSetWindowBackground(xDpy, xWin, mSelected);
+  xBackground = mSelected;
   XSetBackground(xDpy, xGC, mSelected);
   XSetWindowBorderWidth(xDpy, xWin, 0);
-  
-  if (colorInit)
-  {
-    colorInit = false;
-    if (xMono)
-    {
-      for (int i = numColors; i--;) color[i] = AllocColor("Black");
-    }
-    else
-    {
-      color[0] = AllocColor("DarkGoldenRod");
-      color[1] = AllocColor("Red");
-      color[2] = AllocColor("DeepSkyBlue");
-      color[3] = AllocColor("Firebrick");
-      color[4] = AllocColor("DarkSeaGreen");
-      color[5] = AllocColor("ForestGreen");
-      color[6] = AllocColor("InidianRed");
-      color[7] = AllocColor("MediumPurple");
-    }
-  }
 }
 
+// Wird der Rahmen ikonisiert, bleibt das SubFenster abgebildet, erhaelt
+// aber keine Ereignisse mehr
+SCBoolean PVSubDisplay::IsVisible(void) const
+{
+  return PVDisplay::IsVisible() && (!parent || parent->IsVisible());
+}
+
+
 void PVSubDisplay::Resized(void)
 {
   PVDisplay::Resized();
 
-  if (parent)
-  {
-    XClearArea(xDpy, parent->GetXWin(), 0, 0, 0, 0, true); // Parent aktualisieren
-    XClearWindow(xDpy, GetXWin());
-  }
   waitingForResize = false;
+  if (parent) parent->Repaint(); // Parent aktualisieren
 }
 
 void PVSubDisplay::Paint(void)
 {
   // PVDisplay::Paint() wird NICHT aufgerufen um Rahmen zu verhindern
+  ClearArea(0, 0, GetWidth(), GetHeight());
 }
 
 
@@ -321,6 +463,7 @@ PVFrameDisplay::PVFrameDisplay(Display* XDisplay, PVSubDisplay* Sub,
 {    
   XReparentWindow(xDpy, sub->GetXWin(), xWin, 0, 0);
   sub->parent = this;
+  xSurface.SetFontStruct(PVSurface::axisFont, axisFont);
   SetMargin(40, 25);
 }
 
@@ -347,6 +490,13 @@ void PVFrameDisplay::Resized(void)
 }
 
 
+// Die Achsen haengen nur von den Daten des SubDisplays ab
+unsigned long PVFrameDisplay::GetDataVersion(void) const
+{
+  return sub->GetDataVersion();
+}
+
+
 void PVFrameDisplay::Paint(void)
 {
   if (sub->IsWaitingForResize()) return;
@@ -1,7 +1,7 @@
 /******************************************************************************\
  Datei : PVDisplay.h
  Inhalt: Deklaration der Basisklassen fuer die Anzeige von Leistungsdaten:
-         PVDisplay, PVSubDisplay, PVFrameDisplay
+         PVXSurface, PVDisplay, PVSubDisplay, PVFrameDisplay
  Autor : Christian Rodemeyer, Marc Diefenbruch
  Datum : 16.08.95
  Status: Farbverwaltungsexperimente
@@ -19,11 +19,58 @@
 #ifndef _XUTIL_H_
 #include <X11/Xutil.h>
 #endif
+#ifndef __PVSURFACE_H
+#include "PVSurface.h"
+#endif
+
+/******************************************************************************\
+ PVXSurface: Zeichenflaeche auf einem X-Drawable (dem Puffer eines PVDisplay)
+  mit dessen GC. Farben sind Pixelwerte; die Motif-Farben werden bei der
+  Konstruktion reserviert. Die Schriften werden von den Displays geladen und
+  hier nur fuer SetFont eingetragen.
+\******************************************************************************/
+
+class PVXSurface: public PVSurface
+{
+  public:
+    PVXSurface(Display* XDisplay, Colormap XCmap, GC XGC, SCBoolean Mono);
+
+    void SetDrawable(Drawable XDrawable) {xDrawable = XDrawable;}
+    void SetFontStruct(int Which, XFontStruct* Font) {fonts[Which] = Font;}
+
+    void SetColor(unsigned long Color);
+    void Line(int X1, int Y1, int X2, int Y2);
+    void Lines(const PVPoint * Points, int Num);
+    void FillRect(int X, int Y, int Width, int Height);
+    void Text(int X, int Y, const char * String, int Align = left);
+    void Clip(int X, int Y, int Width, int Height);
+
+    void SetFont(int Which);
+    int  TextWidth(const char * String) const;
+    int  Ascent(void) const;
+    int  Descent(void) const;
+    void SetDashed(SCBoolean Dashed);
+
+    unsigned long AllocColor(const char * ColorName);
+
+  private:
+    Display* const xDpy;
+    const Colormap xCmap;
+    const GC       xGC;
+    Drawable       xDrawable;
+    XFontStruct*   fonts[3];   // axisFont, boldFont, mediumFont
+    XFontStruct*   font;       // aktuelle Schrift, NULL: keine geladen
+};
 
 /******************************************************************************\
  PVDisplay: Anzeige eines X-Window, dessen Ereignisse vom PVXEventDispatcher
   verwaltet werden. Der Dispatcher ruft als Antwort auf das Eintretetn von
   XEvents die entsprechenden Antwortefunktionen auf.
+    Gezeichnet wird nicht ins Fenster, sondern in eine gleich grosse Pixmap
+  auf dem Server (xBuf). Geaenderte Bereiche werden mit Invalidate vermerkt
+  und von Flush ins Fenster kopiert; ein Expose kostet damit nur eine Kopie.
+  Paint zeichnet xBuf vollstaendig neu und wird nur noch gerufen, wenn der
+  Inhalt ungueltig ist (nach Groessenaenderungen).
 \******************************************************************************/   
 
 class PVDisplay
@@ -36,9 +83,32 @@ class PVDisplay
     
     // XEvent-Antwortefunktionen
     // -------------------------
-    virtual void Paint();            // Ende eines Exposure Ereignisses
+    virtual void Paint();            // zeichnet xBuf vollstaendig neu
     virtual void Resized();          // Aufruf nach Groeennderung 
     virtual void Default(XEvent&) {} // Unbenannte Events (nicht unbekannt!)
+    void         Exposed(const XExposeEvent& Event); // Bereich neu kopieren
+
+    // Doppelpufferung
+    // ---------------
+    void      Flush();               // geaenderte Bereiche ins Fenster
+    void      Redraw();              // Paint und ganzes Fenster kopieren
+    void      Repaint();             // beim naechsten Expose neu zeichnen
+    SCBoolean HasBuffer() const {return xBuf != None;}
+
+    // Aenderungserkennung: Update ist nur noetig, wenn sich die Version der
+    // angezeigten Daten seit dem letzten Update geaendert hat. Displays
+    // ohne Datentypen sind immer veraltet.
+    // ----------------------------------------------------------------------
+    virtual unsigned long GetDataVersion() const {return drawnVersion + 1;}
+    SCBoolean IsOutdated() const {return GetDataVersion() != drawnVersion;}
+    void      Updated() {drawnVersion = GetDataVersion();}
+
+    // Sichtbarkeit (MapNotify/UnmapNotify, VisibilityNotify); unsichtbare
+    // Displays werden nicht aktualisiert
+    // --------------------------------------------------------------------
+    void              SetMapped(SCBoolean Mapped)     {mapped = Mapped;}
+    void              SetObscured(SCBoolean Obscured) {obscured = Obscured;}
+    virtual SCBoolean IsVisible() const {return mapped && !obscured;}
 
     virtual long       GetXEventMask() const;
     virtual void       GetXSizeHints(XSizeHints& Hints) const;
@@ -65,6 +135,7 @@ class PVDisplay
     const GC       xGC;   // GrafikContext
     const Colormap xCmap; // Farbtabelle
     const SCBoolean     xMono; // true bei monochromen Screen
+    PVXSurface     xSurface; // Zeichnen in xBuf (Diagramme, Motif-Rahmen)
     
     // Farben und Resourcen fr X11-OSF/Motif Simulation
     // -------------------------------------------------
@@ -86,14 +157,31 @@ class PVDisplay
     int  DrawCenteredString(XFontStruct* Font, const char * ToDraw, int CX, int Y);
     int  DrawRightString(XFontStruct* Font, const char * ToDraw, int RX, int Y);
 
+    // Zeichnen in den Puffer
+    // ----------------------
+    void ClearArea(int Left, int Top, int Width, int Height); // xBackground
+    void Invalidate(int Left, int Top, int Width, int Height);
+
+    Pixmap    xBuf;        // Puffer, None solange die Groesse unbekannt ist
+    SCBoolean xBufValid;   // false: Paint muss xBuf neu zeichnen
+    long      xBackground; // Hintergrundfarbe (ClearArea)
+
+    unsigned long drawnVersion; // GetDataVersion beim letzten Update
+    SCBoolean     mapped;       // Fenster ist abgebildet
+    SCBoolean     obscured;     // Fenster ist vollstaendig verdeckt
+
 //  private:  
     int width, height; // Tatschliche Dimensionen des Pixelfensters
 
-    // Verfgbare Farben fr Diagrammdarstellung
-    // -----------------------------------------
-    enum {numColors = 8};           // Verfgbare Standardfarben
-    static long color[numColors];   
-    static SCBoolean colorInit;
+    // Geaenderte Bereiche; sind alle Eintraege belegt, werden sie zu einem
+    // umschliessenden Rechteck zusammengefasst
+    // ---------------------------------------------------------------------
+    enum {maxDirty = 8};
+    XRectangle dirty[maxDirty];
+    int        numDirty;
+
+    // Naechste Standardfarbe fuer Diagramme (PVSurface::ColorName)
+    // ------------------------------------------------------------
     int nextUnusedColor;
 };
 
@@ -115,6 +203,7 @@ class PVFrameDisplay: public PVDisplay
     // -----------------------
     void Paint();   
     void Resized(); // bernimmt Groeennderung des SubDisplays
+    unsigned long GetDataVersion() const; // die des SubDisplays
 
     PVDisplay* GetSubDisplay() const {return (PVDisplay*)sub;}
 
@@ -156,6 +245,7 @@ class PVSubDisplay: public PVDisplay
     // Redefinierte virtuelle Funktionen
     // ---------------------------------
     SCBoolean IsSubDisplay() const {return true;}
+    SCBoolean IsVisible() const;    // nur, wenn auch der Rahmen sichtbar ist
     void Resized();
     void Paint();
 
@@ -6,6 +6,8 @@
  Status: 
 \******************************************************************************/   
 
+#include <math.h>
+
 #include "PVMapper.h"
 
 #if _SC_DMALLOC
@@ -46,3 +48,25 @@ void PVMapper::SetDistPixel(int DistPixel)
   distPixel = DistPixel;
   scaling = distPixel / distPos;
 }  
+
+int PVMapper::Marks(double Min, double Max, int Fields,
+                    double& Dist, double& First)
+{
+  if (Max == Min) return 0;
+
+  if (Fields != 0)
+  {
+    double T1 = (Max - Min) / Fields;
+    double T2 = pow(10.0, floor(log10(T1)));
+
+    Dist = ceil(T1 / T2) * T2;
+    if (Dist <= 0) return 0;
+    First = ceil(Min / Dist) * Dist;
+  }
+  else
+  { // keine Beschriftung sichtbar
+    Dist = (Max - Min) / 4;
+    First = Min + Dist / 4;
+  }
+  return 1;
+}
@@ -25,10 +25,22 @@ class PVMapper
     double ReMap(int Pixel) const // Umkehrfunktion zu operator()
       {return (Pixel - orgPixel) / scaling + orgPos;}
       
+    double GetOrgPos(void) const   {return orgPos;}
+    int    GetOrgPixel(void) const {return orgPixel;}
+    int    SameScale(const PVMapper& Other) const // gleiche Skalierung?
+      {return distPos == Other.distPos && distPixel == Other.distPixel;}
+
     void SetOrgPos(double OrgPos);    
     void SetOrgPixel(int OrgPixel);   
     void SetDistPos(double DistPos);     
     void SetDistPixel(int DistPixel);
+
+    // Markierungen einer Achse von Min bis Max mit Platz fuer Fields
+    // Beschriftungen: Abstand (1 bis 9 mal eine Zehnerpotenz) und erste
+    // Hauptmarkierung. Ohne Platz (Fields == 0) vier Markierungen ohne
+    // Beschriftung. 0: keine Markierungen
+    static int Marks(double Min, double Max, int Fields,
+                     double& Dist, double& First);
      
   private:
     double orgPos;     // virtueller Ursprung, der auf 
@@ -0,0 +1,905 @@
+/******************************************************************************\
+ Datei : PVPlot.cpp
+ Inhalt: Implementierung der Ausgabe der Displays als Bilddateien ohne
+         X-Server
+ Status:
+\******************************************************************************/
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+
+#if _PEV_ZLIB
+  #include <zlib.h>
+#endif
+
+#include "PVPlot.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+// Schrift mit 5x7 Punkten fuer die Zeichen 32 bis 126: je Zeichen 5 Spalten,
+// Bit 0 ist die oberste Zeile
+static const unsigned char font[95][5] =
+{
+  {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, // ' ' !
+  {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14}, // " #
+  {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, // $ %
+  {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00}, // & '
+  {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, // ( )
+  {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08}, // * +
+  {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, // , -
+  {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02}, // . /
+  {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, // 0 1
+  {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31}, // 2 3
+  {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, // 4 5
+  {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03}, // 6 7
+  {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, // 8 9
+  {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00}, // : ;
+  {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, // < =
+  {0x41,0x22,0x14,0x08,0x00}, {0x02,0x01,0x51,0x09,0x06}, // > ?
+  {0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, // @ A
+  {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22}, // B C
+  {0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, // D E
+  {0x7F,0x09,0x09,0x01,0x01}, {0x3E,0x41,0x41,0x51,0x32}, // F G
+  {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, // H I
+  {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, // J K
+  {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x04,0x02,0x7F}, // L M
+  {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E}, // N O
+  {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, // P Q
+  {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31}, // R S
+  {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, // T U
+  {0x1F,0x20,0x40,0x20,0x1F}, {0x7F,0x20,0x18,0x20,0x7F}, // V W
+  {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, // X Y
+  {0x61,0x51,0x49,0x45,0x43}, {0x00,0x00,0x7F,0x41,0x41}, // Z [
+  {0x02,0x04,0x08,0x10,0x20}, {0x41,0x41,0x7F,0x00,0x00}, // \ ]
+  {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40}, // ^ _
+  {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, // ` a
+  {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20}, // b c
+  {0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, // d e
+  {0x08,0x7E,0x09,0x01,0x02}, {0x08,0x14,0x54,0x54,0x3C}, // f g
+  {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, // h i
+  {0x20,0x40,0x44,0x3D,0x00}, {0x00,0x7F,0x10,0x28,0x44}, // j k
+  {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, // l m
+  {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38}, // n o
+  {0x7C,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7C}, // p q
+  {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20}, // r s
+  {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, // t u
+  {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C}, // v w
+  {0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C}, // x y
+  {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00}, // z {
+  {0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, // | }
+  {0x08,0x04,0x08,0x10,0x08}                              // ~
+};
+
+/******************************************************************************\
+ PVPlotCanvas: Implementierung
+\******************************************************************************/
+
+PVPlotCanvas::PVPlotCanvas(void) :
+  data   (NULL),
+  used   (0),
+  size   (0),
+  width  (0),
+  height (0)
+{
+  for (int i = 0; i < numMotifColors; i++)
+  {
+    RGB(MotifColorName(i, false), motif[i]);
+  }
+}
+
+
+PVPlotCanvas::~PVPlotCanvas(void)
+{
+  delete[] data;
+}
+
+
+void PVPlotCanvas::Put(const void * Data, SCNatural Length)
+{
+  if (used + Length > size)
+  {
+    char * grown;
+
+    if (!size) size = 4096;
+    while (used + Length > size) size *= 2;
+    grown = new char[size];
+    if (used) memcpy(grown, data, used);
+    delete[] data;
+    data = grown;
+  }
+  memcpy(data + used, Data, Length);
+  used += Length;
+}
+
+
+void PVPlotCanvas::Begin(int Width, int Height)
+{
+  used = 0;
+  width = Width;
+  height = Height;
+}
+
+
+void PVPlotCanvas::SetColor(unsigned long RGB)
+{
+  const char tag = cColor;
+
+  Put(&tag, 1);
+  Put(&RGB, sizeof(RGB));
+}
+
+
+void PVPlotCanvas::Line(int X1, int Y1, int X2, int Y2)
+{
+  const char tag = cLine;
+
+  Put(&tag, 1);
+  PutInt(X1); PutInt(Y1); PutInt(X2); PutInt(Y2);
+}
+
+
+void PVPlotCanvas::Lines(const PVPoint * Points, int Num)
+{
+  const char tag = cLines;
+
+  if (Num < 2) return;
+  Put(&tag, 1);
+  PutInt(Num);
+  Put(Points, Num * sizeof(PVPoint));
+}
+
+
+void PVPlotCanvas::FillRect(int X, int Y, int Width, int Height)
+{
+  const char tag = cFill;
+
+  if (Width <= 0 || Height <= 0) return;
+  Put(&tag, 1);
+  PutInt(X); PutInt(Y); PutInt(Width); PutInt(Height);
+}
+
+
+void PVPlotCanvas::Text(int X, int Y, const char * String, int Align)
+{
+  const char tag = cText;
+
+  Put(&tag, 1);
+  PutInt(X); PutInt(Y); PutInt(Align);
+  Put(String, strlen(String) + 1);
+}
+
+
+void PVPlotCanvas::Clip(int X, int Y, int Width, int Height)
+{
+  const char tag = cClip;
+
+  Put(&tag, 1);
+  PutInt(X); PutInt(Y); PutInt(Width); PutInt(Height);
+}
+
+
+void PVPlotCanvas::Replay(PVPlotImage & Target) const
+{
+  const char *  cur = data;
+  const char *  end = data + used;
+  unsigned long rgb;
+  int           v[4];
+  int           num;
+  PVPoint *     points = NULL;  // ausgerichtete Kopie der Punkte
+  int           maxPoints = 0;
+
+  Target.Begin(width, height);
+  while (cur < end)
+  {
+    switch (*cur++)
+    {
+      case cColor:
+        memcpy(&rgb, cur, sizeof(rgb));
+        cur += sizeof(rgb);
+        Target.SetColor(rgb);
+        break;
+
+      case cLine:
+        memcpy(v, cur, sizeof(v));
+        cur += sizeof(v);
+        Target.Line(v[0], v[1], v[2], v[3]);
+        break;
+
+      case cLines:
+        memcpy(&num, cur, sizeof(num));
+        cur += sizeof(num);
+        if (num > maxPoints)
+        {
+          delete[] points;
+          maxPoints = num;
+          points = new PVPoint[maxPoints];
+        }
+        memcpy(points, cur, num * sizeof(PVPoint));
+        cur += num * sizeof(PVPoint);
+        Target.Lines(points, num);
+        break;
+
+      case cFill:
+        memcpy(v, cur, sizeof(v));
+        cur += sizeof(v);
+        Target.FillRect(v[0], v[1], v[2], v[3]);
+        break;
+
+      case cText:
+        memcpy(v, cur, 3 * sizeof(int));
+        cur += 3 * sizeof(int);
+        Target.Text(v[0], v[1], cur, v[2]);
+        cur += strlen(cur) + 1;
+        break;
+
+      case cClip:
+        memcpy(v, cur, sizeof(v));
+        cur += sizeof(v);
+        Target.Clip(v[0], v[1], v[2], v[3]);
+        break;
+
+      default:
+        assert(0);
+    }
+  }
+  delete[] points;
+}
+
+/******************************************************************************\
+ PVPlotImage: Implementierung
+\******************************************************************************/
+
+SCBoolean PVPlotImage::Available(int Format)
+{
+#if _PEV_ZLIB
+  return Format >= 0 && Format < numFormats;
+#else
+  return Format == ppm || Format == svg;
+#endif
+}
+
+
+PVPlotImage * PVPlotImage::Create(int Format)
+{
+  if (!Available(Format))
+  {
+    std::cerr << "Cannot create plot format " << Format << "!\n";
+    abort();
+  }
+  switch (Format)
+  {
+    case png: return new PVRasterImage(true);
+    case svg: return new PVSVGImage;
+    default:  return new PVRasterImage(false);
+  }
+}
+
+/******************************************************************************\
+ PVRasterImage: Implementierung
+\******************************************************************************/
+
+PVRasterImage::PVRasterImage(SCBoolean PNG) :
+  png    (PNG),
+  pixels (NULL),
+  width  (0),
+  height (0),
+  size   (0),
+  color  (0)
+{
+}
+
+
+PVRasterImage::~PVRasterImage(void)
+{
+  delete[] pixels;
+}
+
+
+SCBoolean PVRasterImage::Save(const PVPlotCanvas & Canvas,
+                              const char *         FileName)
+{
+  FILE *    file;
+  SCBoolean ok;
+
+  Canvas.Replay(*this);
+  if (!(file = fopen(FileName, "wb"))) return false;
+  ok = png ? WritePNG(file) : WritePPM(file);
+  return fclose(file) == 0 && ok;
+}
+
+
+void PVRasterImage::Begin(int Width, int Height)
+{
+  const SCNatural need = 3 * (SCNatural)Width * Height;
+
+  if (need > size)
+  {
+    delete[] pixels;
+    pixels = new unsigned char[need];
+    size = need;
+  }
+  width = Width;
+  height = Height;
+  memset(pixels, 0, need);
+  Clip(0, 0, 0, 0);
+}
+
+
+void PVRasterImage::Clip(int X, int Y, int Width, int Height)
+{
+  if (Width <= 0)
+  {
+    clipX1 = clipY1 = 0;
+    clipX2 = width - 1;
+    clipY2 = height - 1;
+    return;
+  }
+  clipX1 = X < 0 ? 0 : X;
+  clipY1 = Y < 0 ? 0 : Y;
+  clipX2 = X + Width - 1 < width ? X + Width - 1 : width - 1;
+  clipY2 = Y + Height - 1 < height ? Y + Height - 1 : height - 1;
+}
+
+
+// Bresenham; die Koordinaten werden wie bei XPoint auf short begrenzt
+void PVRasterImage::Line(int X1, int Y1, int X2, int Y2)
+{
+  int dx, dy, sx, sy, err, e2;
+
+  #define Short(v) ((v) < -32768 ? -32768 : (v) > 32767 ? 32767 : (v))
+  X1 = Short(X1); Y1 = Short(Y1); X2 = Short(X2); Y2 = Short(Y2);
+  #undef Short
+
+  // ganz ausserhalb des Clip-Bereichs: nichts zu tun
+  if ((X1 < clipX1 && X2 < clipX1) || (X1 > clipX2 && X2 > clipX2) ||
+      (Y1 < clipY1 && Y2 < clipY1) || (Y1 > clipY2 && Y2 > clipY2)) return;
+
+  dx = X2 > X1 ? X2 - X1 : X1 - X2;
+  dy = Y2 > Y1 ? Y1 - Y2 : Y2 - Y1;
+  sx = X1 < X2 ? 1 : -1;
+  sy = Y1 < Y2 ? 1 : -1;
+  err = dx + dy;
+  for (;;)
+  {
+    Plot(X1, Y1);
+    if (X1 == X2 && Y1 == Y2) break;
+    e2 = 2 * err;
+    if (e2 >= dy) { err += dy; X1 += sx; }
+    if (e2 <= dx) { err += dx; Y1 += sy; }
+  }
+}
+
+
+void PVRasterImage::Lines(const PVPoint * Points, int Num)
+{
+  int i;
+
+  for (i = 1; i < Num; i++, Points++)
+  {
+    Line(Points[0].x, Points[0].y, Points[1].x, Points[1].y);
+  }
+}
+
+
+void PVRasterImage::FillRect(int X, int Y, int Width, int Height)
+{
+  int x1 = X < clipX1 ? clipX1 : X;
+  int y1 = Y < clipY1 ? clipY1 : Y;
+  int x2 = X + Width - 1 > clipX2 ? clipX2 : X + Width - 1;
+  int y2 = Y + Height - 1 > clipY2 ? clipY2 : Y + Height - 1;
+  int x, y;
+
+  if (x1 > x2 || y1 > y2) return;
+  for (x = x1; x <= x2; x++)    // erste Zeile, dann kopieren
+  {
+    Plot(x, y1);
+  }
+  for (y = y1 + 1; y <= y2; y++)
+  {
+    memcpy(pixels + 3 * (y * width + x1), pixels + 3 * (y1 * width + x1),
+           3 * (x2 - x1 + 1));
+  }
+}
+
+
+// Y ist die Grundlinie, die unterste Zeile der Zeichen liegt darauf
+void PVRasterImage::Text(int X, int Y, const char * String, int Align)
+{
+  const int             w = TextWidth(String);
+  const unsigned char * glyph;
+  int                   col, row;
+
+  if (Align == center) X -= w / 2;
+  else if (Align == right) X -= w;
+
+  for (; *String; String++, X += charWidth)
+  {
+    unsigned char c = *String;
+
+    glyph = font[(c < 32 || c > 126 ? '?' : c) - 32];
+    for (col = 0; col < 5; col++)
+    {
+      for (row = 0; row < 7; row++)
+      {
+        if (glyph[col] & (1 << row)) Plot(X + col, Y - 6 + row);
+      }
+    }
+  }
+}
+
+
+SCBoolean PVRasterImage::WritePPM(FILE * File) const
+{
+  fprintf(File, "P6\n%d %d\n255\n", width, height);
+  return fwrite(pixels, 3, width * height, File) == (size_t)(width * height);
+}
+
+
+#if _PEV_ZLIB
+
+static void PutChunk(FILE * File, const char * Type,
+                     const unsigned char * Data, unsigned long Length)
+{
+  unsigned char head[8];
+  uLong         crc;
+
+  head[0] = Length >> 24; head[1] = Length >> 16;
+  head[2] = Length >> 8;  head[3] = Length;
+  memcpy(head + 4, Type, 4);
+  crc = crc32(0L, head + 4, 4);
+  if (Length) crc = crc32(crc, Data, Length);
+
+  fwrite(head, 1, 8, File);
+  if (Length) fwrite(Data, 1, Length, File);
+  head[0] = crc >> 24; head[1] = crc >> 16; head[2] = crc >> 8; head[3] = crc;
+  fwrite(head, 1, 4, File);
+}
+
+
+// Zeilen ohne Filter; die schnellste Stufe von zlib reicht fuer Diagramme
+// mit grossen einfarbigen Flaechen
+SCBoolean PVRasterImage::WritePNG(FILE * File) const
+{
+  static const unsigned char signature[8] =
+    {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  const uLong     stride = 3 * width + 1;        // mit Filterbyte
+  const uLong     rawSize = stride * height;
+  unsigned char * raw = new unsigned char[rawSize];
+  uLongf          zSize = compressBound(rawSize);
+  unsigned char * z = new unsigned char[zSize];
+  unsigned char   ihdr[13];
+  SCBoolean       ok;
+  int             y;
+
+  for (y = 0; y < height; y++)
+  {
+    raw[y * stride] = 0;                          // Filter "None"
+    memcpy(raw + y * stride + 1, pixels + 3 * width * y, 3 * width);
+  }
+  ok = compress2(z, &zSize, raw, rawSize, Z_BEST_SPEED) == Z_OK;
+
+  if (ok)
+  {
+    ihdr[0] = width >> 24;  ihdr[1] = width >> 16;
+    ihdr[2] = width >> 8;   ihdr[3] = width;
+    ihdr[4] = height >> 24; ihdr[5] = height >> 16;
+    ihdr[6] = height >> 8;  ihdr[7] = height;
+    ihdr[8] = 8;                                  // Bits je Kanal
+    ihdr[9] = 2;                                  // RGB
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+
+    fwrite(signature, 1, 8, File);
+    PutChunk(File, "IHDR", ihdr, 13);
+    PutChunk(File, "IDAT", z, zSize);
+    PutChunk(File, "IEND", NULL, 0);
+    ok = !ferror(File);
+  }
+
+  delete[] z;
+  delete[] raw;
+
+  return ok;
+}
+
+#else
+
+SCBoolean PVRasterImage::WritePNG(FILE *) const
+{
+  return false;                                 // Create laesst png nicht zu
+}
+
+#endif
+
+/******************************************************************************\
+ PVSVGImage: Implementierung
+\******************************************************************************/
+
+PVSVGImage::PVSVGImage(void) :
+  file     (NULL),
+  color    (0),
+  numClips (0),
+  clipped  (false)
+{
+}
+
+
+SCBoolean PVSVGImage::Save(const PVPlotCanvas & Canvas, const char * FileName)
+{
+  SCBoolean ok;
+
+  if (!(file = fopen(FileName, "w"))) return false;
+  numClips = 0;
+  clipped = false;
+  Canvas.Replay(*this);
+  if (clipped) fputs("</g>\n", file);
+  fputs("</svg>\n", file);
+  ok = !ferror(file);
+  if (fclose(file)) ok = false;
+  file = NULL;
+
+  return ok;
+}
+
+
+void PVSVGImage::Begin(int Width, int Height)
+{
+  fprintf(file,
+          "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\""
+          " viewBox=\"0 0 %d %d\" font-family=\"monospace\" font-size=\"10\""
+          " shape-rendering=\"crispEdges\">\n",
+          Width, Height, Width, Height);
+}
+
+
+// Linien liegen wie bei X auf den Pixelmitten
+void PVSVGImage::Line(int X1, int Y1, int X2, int Y2)
+{
+  fprintf(file, "<line x1=\"%d.5\" y1=\"%d.5\" x2=\"%d.5\" y2=\"%d.5\""
+          " stroke=\"#%06lx\"/>\n", X1, Y1, X2, Y2, color);
+}
+
+
+void PVSVGImage::Lines(const PVPoint * Points, int Num)
+{
+  int i;
+
+  fputs("<polyline points=\"", file);
+  for (i = 0; i < Num; i++)
+  {
+    fprintf(file, i % 8 == 7 ? "%d.5,%d.5\n" : "%d.5,%d.5 ",
+            Points[i].x, Points[i].y);
+  }
+  fprintf(file, "\" fill=\"none\" stroke=\"#%06lx\"/>\n", color);
+}
+
+
+void PVSVGImage::FillRect(int X, int Y, int Width, int Height)
+{
+  fprintf(file, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\""
+          " fill=\"#%06lx\"/>\n", X, Y, Width, Height, color);
+}
+
+
+void PVSVGImage::Text(int X, int Y, const char * String, int Align)
+{
+  static const char * anchor[] = {"start", "middle", "end"};
+
+  fprintf(file, "<text x=\"%d\" y=\"%d\" text-anchor=\"%s\" fill=\"#%06lx\">",
+          X, Y, anchor[Align], color);
+  for (; *String; String++)
+  {
+    switch (*String)
+    {
+      case '&': fputs("&amp;", file); break;
+      case '<': fputs("&lt;", file); break;
+      case '>': fputs("&gt;", file); break;
+      default:  fputc(*String, file); break;
+    }
+  }
+  fputs("</text>\n", file);
+}
+
+
+void PVSVGImage::Clip(int X, int Y, int Width, int Height)
+{
+  if (clipped)
+  {
+    fputs("</g>\n", file);
+    clipped = false;
+  }
+  if (Width <= 0) return;
+
+  numClips++;
+  fprintf(file, "<clipPath id=\"c%d\"><rect x=\"%d\" y=\"%d\" width=\"%d\""
+          " height=\"%d\"/></clipPath>\n<g clip-path=\"url(#c%d)\">\n",
+          numClips, X, Y, Width, Height, numClips);
+  clipped = true;
+}
+
+/******************************************************************************\
+ PVPlot: Implementierung
+\******************************************************************************/
+
+PVPlot::PVPlot(const char * Name,
+               int          Kind,
+               int          AdaptRange,
+               SCBoolean    FixedBottom,
+               SCBoolean    WholeRun,
+               SCObjectType ObjectType) :
+  kind            (Kind),
+  nextUnusedColor (-1)
+{
+  name = new char[strlen(Name) + 1];
+  strcpy(name, Name);
+
+  // Diagramme wie PVCurvesFrame, PVGanttFrame und PVFreqFrame
+  switch (kind)
+  {
+    case curves:
+      chart = new PVCurvesChart(AdaptRange, FixedBottom, WholeRun);
+      break;
+    case gantt:
+      chart = new PVGanttChart(AdaptRange);
+      break;
+    default:
+      chart = new PVFreqChart(ObjectType);
+      break;
+  }
+}
+
+
+PVPlot::~PVPlot(void)
+{
+  delete[] name;
+  delete chart;
+}
+
+
+void PVPlot::AddCurve(const PDCurve * Curve, unsigned long RGB)
+{
+  assert(kind != freqs);
+
+  ((PVCurvesChart *)chart)->AddCurve(Curve, RGB);
+}
+
+
+void PVPlot::AddFrequency(const PDFrequency * Frequency, unsigned long RGB)
+{
+  assert(kind == freqs);
+
+  ((PVFreqChart *)chart)->AddFrequency(Frequency, RGB);
+}
+
+
+void PVPlot::AddStateTable(const PDStateTable * StateTable)
+{
+  assert(kind == gantt);
+
+  ((PVGanttChart *)chart)->AddStateTable(StateTable);
+}
+
+
+unsigned long PVPlot::GetColor(const char * ColorName)
+{
+  unsigned long rgb;
+
+  if (!PVSurface::RGB(PVSurface::ColorName(ColorName, nextUnusedColor), rgb))
+  {
+    PVSurface::RGB(PVSurface::ColorName(NULL, nextUnusedColor), rgb);
+  }
+  return rgb;
+}
+
+
+// Aufteilung wie PVFrameDisplay: Rahmen, vertiefter Datenbereich, Achsen.
+// Nach einer Groessenaenderung richtet Update die Skalierung neu aus.
+void PVPlot::Render(PVPlotCanvas & Canvas, int Width, int Height)
+{
+  const int leftMargin   = chart->LeftMargin(Canvas);
+  const int bottomMargin = chart->BottomMargin();
+  const int subWidth     = Width - leftMargin - PVChart::margin - 8;
+  const int subHeight    = Height - PVChart::margin - bottomMargin - 8;
+  const int X            = leftMargin + 4;
+  const int Y            = PVChart::margin + 4;
+  SCBoolean valid        = true;
+
+  Canvas.Begin(Width, Height);
+  Canvas.SetColor(Canvas.MotifColor(PVSurface::background));
+  Canvas.FillRect(0, 0, Width, Height);
+  Canvas.DrawRaised(0, 0, Width, Height);
+  if (subWidth < 16 || subHeight < 16) return;
+
+  Canvas.DrawLowered(leftMargin + 2, PVChart::margin + 2,
+                     subWidth + 4, subHeight + 4);
+  if (subWidth != chart->GetWidth() || subHeight != chart->GetHeight())
+  {
+    chart->Resize(subWidth, subHeight);
+    valid = false;
+  }
+  chart->Update(valid);
+
+  Canvas.Clip(X, Y, subWidth, subHeight);
+  chart->Draw(Canvas, X, Y);
+  Canvas.Clip(0, 0, 0, 0);
+  chart->DrawXAxis(Canvas, X, Y, subWidth, subHeight);
+  chart->DrawYAxis(Canvas, X, Y, subWidth, subHeight);
+}
+
+/******************************************************************************\
+ PVPlotter: Implementierung
+\******************************************************************************/
+
+PVPlotter::PVPlotter(const char * Prefix,
+                     int          Format,
+                     int          Width,
+                     int          Height,
+                     SCNatural    QueueSize) :
+  image      (PVPlotImage::Create(Format)),
+  width      (Width),
+  height     (Height),
+  numPlots   (0),
+  maxPlots   (4),
+  numReports (0),
+  numSlots   (QueueSize),
+  head       (0),
+  count      (0),
+  stop       (false)
+{
+  SCNatural i;
+
+  assert(numSlots > 0);
+  prefix = new char[strlen(Prefix) + 1];
+  strcpy(prefix, Prefix);
+  plots = new PVPlot *[maxPlots];
+  slots = new PVSlot[numSlots];
+  for (i = 0; i < numSlots; i++)
+  {
+    slots[i].fileName = NULL;
+  }
+
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&filled, NULL);
+  pthread_cond_init(&written, NULL);
+  if (pthread_create(&writer, NULL, Write, this))
+  {
+    std::cerr << "Cannot create plot thread!\n";
+    abort();
+  }
+}
+
+
+PVPlotter::~PVPlotter(void)
+{
+  SCNatural i;
+  int       p;
+
+  Flush();
+  pthread_mutex_lock(&lock);
+  stop = true;
+  pthread_cond_signal(&filled);
+  pthread_mutex_unlock(&lock);
+  pthread_join(writer, NULL);
+
+  pthread_cond_destroy(&written);
+  pthread_cond_destroy(&filled);
+  pthread_mutex_destroy(&lock);
+
+  for (i = 0; i < numSlots; i++)
+  {
+    delete[] slots[i].fileName;
+  }
+  delete[] slots;
+  for (p = 0; p < numPlots; p++)
+  {
+    delete plots[p];
+  }
+  delete[] plots;
+  delete[] prefix;
+  delete image;
+}
+
+
+void PVPlotter::Add(PVPlot * Plot)
+{
+  if (numPlots == maxPlots)
+  {
+    PVPlot ** grown = new PVPlot *[2 * maxPlots];
+
+    memcpy(grown, plots, numPlots * sizeof(PVPlot *));
+    delete[] plots;
+    plots = grown;
+    maxPlots *= 2;
+  }
+  plots[numPlots++] = Plot;
+}
+
+
+// Haelt je Plot die Grafikbefehle fest; wartet bei voller Warteschlange,
+// bis der Schreibthread einen Platz frei gibt
+void PVPlotter::Plot(void)
+{
+  PVSlot *     slot;
+  const char * name;
+  char *       s;
+  int          p;
+
+  numReports++;
+  for (p = 0; p < numPlots; p++)
+  {
+    pthread_mutex_lock(&lock);
+    while (count == numSlots)
+    {
+      pthread_cond_wait(&written, &lock);
+    }
+    slot = &slots[(head + count) % numSlots];
+    pthread_mutex_unlock(&lock);
+
+    plots[p]->Render(slot->canvas, width, height);
+
+    name = plots[p]->GetName();
+    delete[] slot->fileName;
+    slot->fileName = new char[strlen(prefix) + strlen(name) + 32];
+    s = slot->fileName + sprintf(slot->fileName, "%s", prefix);
+    for (; *name; name++)
+    {
+      *s++ = (isalnum((unsigned char)*name) || strchr("-_.", *name)) ?
+             *name : '_';
+    }
+    sprintf(s, "-%lu.%s", (unsigned long)numReports, image->Extension());
+
+    pthread_mutex_lock(&lock);
+    count++;
+    pthread_cond_signal(&filled);
+    pthread_mutex_unlock(&lock);
+  }
+}
+
+
+void PVPlotter::Flush(void)
+{
+  pthread_mutex_lock(&lock);
+  while (count)
+  {
+    pthread_cond_wait(&written, &lock);
+  }
+  pthread_mutex_unlock(&lock);
+}
+
+
+void * PVPlotter::Write(void * Plotter)
+{
+  PVPlotter * self = (PVPlotter *)Plotter;
+  PVSlot *    slot;
+
+  pthread_mutex_lock(&self->lock);
+  for (;;)
+  {
+    while (!self->count && !self->stop)
+    {
+      pthread_cond_wait(&self->filled, &self->lock);
+    }
+    if (!self->count) break;   // beendet und alles geschrieben
+    slot = &self->slots[self->head];
+    pthread_mutex_unlock(&self->lock);
+
+    if (!self->image->Save(slot->canvas, slot->fileName))
+    {
+      std::cerr << "Cannot write plot " << slot->fileName << "!\n";
+    }
+
+    pthread_mutex_lock(&self->lock);
+    self->head = (self->head + 1) % self->numSlots;
+    self->count--;
+    pthread_cond_broadcast(&self->written);
+  }
+  pthread_mutex_unlock(&self->lock);
+
+  return NULL;
+}
@@ -0,0 +1,251 @@
+/******************************************************************************\
+ Datei : PVPlot.h
+ Inhalt: Deklaration der Ausgabe der Displays als Bilddateien ohne X-Server
+         (PVPlotCanvas, PVPlotImage, PVRasterImage, PVSVGImage, PVPlot,
+         PVPlotter)
+ Status:
+\******************************************************************************/
+
+#ifndef __PVPLOT_H
+#define __PVPLOT_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+#include <SCL/SCBasicTypes.h>
+
+#ifndef __PVCHART_H
+#include "PVChart.h"
+#endif
+
+class PVPlotImage;
+
+/******************************************************************************\
+ PVPlotCanvas: Zeichenflaeche, die nicht selbst zeichnet, sondern die
+   Grafikbefehle eines Bildes als kompakte Folge festhaelt (wie
+   PEReportSnapshot die Werte eines Reports). Replay gibt sie spaeter, evtl.
+   in einem anderen Thread, an ein PVPlotImage weiter. Farben sind RGB-Werte
+   (0xrrggbb), Texte werden in der eingebauten Schrift gesetzt. Der Puffer
+   waechst nur und wird bei jedem Begin wiederverwendet.
+\******************************************************************************/
+
+class PVPlotCanvas: public PVSurface
+{
+  public:
+    PVPlotCanvas(void);
+    ~PVPlotCanvas(void);
+
+    void Begin(int Width, int Height);             // leeres Bild
+    void SetColor(unsigned long RGB);
+    void Line(int X1, int Y1, int X2, int Y2);
+    void Lines(const PVPoint * Points, int Num);
+    void FillRect(int X, int Y, int Width, int Height);
+    void Text(int X, int Y, const char * String, int Align = left);
+    void Clip(int X, int Y, int Width, int Height);
+
+    int  GetWidth(void) const  {return width;}
+    int  GetHeight(void) const {return height;}
+
+    void Replay(PVPlotImage & Target) const;
+
+  private:
+    enum {cColor, cLine, cLines, cFill, cText, cClip};
+
+    char *    data;
+    SCNatural used;
+    SCNatural size;
+    int       width;
+    int       height;
+
+    void Put(const void * Data, SCNatural Length);
+    void PutInt(int Value) {Put(&Value, sizeof(int));}
+};
+
+/******************************************************************************\
+ PVPlotImage: Ziel der Grafikbefehle eines PVPlotCanvas und Dateiformat.
+   Save spielt das Bild ab und schreibt die Datei; false bei einem Fehler.
+   PNG gibt es nur mit zlib (_PEV_ZLIB), sonst ist PPM die Voreinstellung.
+\******************************************************************************/
+
+class PVPlotImage: public PVSurface
+{
+  public:
+    enum                        // Dateiformate
+    {
+      ppm,                      // Rasterbild, binaeres PPM (P6)
+      png,                      // Rasterbild, PNG (nur mit zlib)
+      svg,                      // Vektorgrafik
+      numFormats,
+#if _PEV_ZLIB
+      defaultFormat = png
+#else
+      defaultFormat = ppm
+#endif
+    };
+
+    static SCBoolean     Available(int Format);
+    static PVPlotImage * Create(int Format);
+
+    virtual SCBoolean    Save(const PVPlotCanvas & Canvas,
+                              const char * FileName) = 0;
+    virtual const char * Extension(void) const = 0;
+
+    virtual void Begin(int Width, int Height) = 0;
+};
+
+/******************************************************************************\
+ PVRasterImage: Rasterbild im Speicher (3 Byte je Pixel). Linien nach
+   Bresenham, Texte in einer eingebauten 5x7-Punkte-Schrift. PNG komprimiert
+   zlib.
+\******************************************************************************/
+
+class PVRasterImage: public PVPlotImage
+{
+  public:
+    PVRasterImage(SCBoolean PNG);
+    ~PVRasterImage(void);
+
+    SCBoolean    Save(const PVPlotCanvas & Canvas, const char * FileName);
+    const char * Extension(void) const {return png ? "png" : "ppm";}
+
+    void Begin(int Width, int Height);
+    void SetColor(unsigned long RGB) {color = RGB;}
+    void Line(int X1, int Y1, int X2, int Y2);
+    void Lines(const PVPoint * Points, int Num);
+    void FillRect(int X, int Y, int Width, int Height);
+    void Text(int X, int Y, const char * String, int Align = left);
+    void Clip(int X, int Y, int Width, int Height);
+
+  private:
+    const SCBoolean png;
+    unsigned char * pixels;
+    int             width;
+    int             height;
+    SCNatural       size;         // Bytes in pixels
+    unsigned long   color;
+    int             clipX1, clipY1, clipX2, clipY2; // einschliesslich
+
+    void Plot(int X, int Y)
+      { if (X >= clipX1 && X <= clipX2 && Y >= clipY1 && Y <= clipY2)
+        { unsigned char * p = pixels + 3 * (Y * width + X);
+          p[0] = color >> 16; p[1] = color >> 8; p[2] = color; } }
+    SCBoolean WritePPM(FILE * File) const;
+    SCBoolean WritePNG(FILE * File) const;
+};
+
+/******************************************************************************\
+ PVSVGImage: Schreibt die Grafikbefehle beim Abspielen direkt als SVG-
+   Elemente; Clipping ueber clipPath-Gruppen.
+\******************************************************************************/
+
+class PVSVGImage: public PVPlotImage
+{
+  public:
+    PVSVGImage(void);
+
+    SCBoolean    Save(const PVPlotCanvas & Canvas, const char * FileName);
+    const char * Extension(void) const {return "svg";}
+
+    void Begin(int Width, int Height);
+    void SetColor(unsigned long RGB) {color = RGB;}
+    void Line(int X1, int Y1, int X2, int Y2);
+    void Lines(const PVPoint * Points, int Num);
+    void FillRect(int X, int Y, int Width, int Height);
+    void Text(int X, int Y, const char * String, int Align = left);
+    void Clip(int X, int Y, int Width, int Height);
+
+  private:
+    FILE *        file;
+    unsigned long color;
+    int           numClips;     // fuer eindeutige ids
+    SCBoolean     clipped;      // eine clipPath-Gruppe ist offen
+};
+
+/******************************************************************************\
+ PVPlot: Gegenstueck eines Rahmendisplays (PVCurvesFrame, PVGanttFrame,
+   PVFreqFrame) ohne X-Server. Skalierung, Datenbereich und Achsen liefert
+   dasselbe PVChart wie bei den Displays, auch die schrittweise Anpassung
+   der Skalierung: Render rechnet bei jedem Bild die Skalierung fort
+   (PVChart::Update) und zeichnet Rahmen, Daten und Achsen in ein
+   PVPlotCanvas.
+\******************************************************************************/
+
+class PVPlot
+{
+  public:
+    enum {curves, gantt, freqs};  // Art des Displays
+
+    PVPlot(const char * Name, int Kind, int AdaptRange,
+           SCBoolean FixedBottom = false, SCBoolean WholeRun = false,
+           SCObjectType ObjectType = SC_NONE);
+    ~PVPlot(void);
+
+    void AddCurve(const PDCurve * Curve, unsigned long RGB);
+    void AddFrequency(const PDFrequency * Frequency, unsigned long RGB);
+    void AddStateTable(const PDStateTable * StateTable);
+
+    // RGB-Wert einer X11-Farbe (einige Namen oder "#rrggbb"); NULL, "" oder
+    // ein unbekannter Name liefern wie PVDisplay::GetColor die naechste
+    // Standardfarbe
+    unsigned long GetColor(const char * ColorName = NULL);
+
+    const char * GetName(void) const {return name;}
+    void         Render(PVPlotCanvas & Canvas, int Width, int Height);
+
+  private:
+    char *        name;
+    const int     kind;
+    PVChart *     chart;
+    int           nextUnusedColor;
+};
+
+/******************************************************************************\
+ PVPlotter: Gibt bei jedem Report (Plot) alle Plots als Bilddateien
+   <Prefix><Name>-<n>.<Format> aus; n zaehlt die Reports, das letzte Bild
+   zeigt also das Ende der Simulation. Der Aufrufer haelt nur die
+   Grafikbefehle in einem PVPlotCanvas fest, Rastern, Kodieren und Schreiben
+   uebernimmt ein eigener Thread. Es warten hoechstens QueueSize Bilder; ist
+   die Warteschlange voll, wartet Plot auf einen freien Platz. Flush (auch
+   beim Loeschen) wartet, bis alle Bilder geschrieben sind.
+\******************************************************************************/
+
+class PVPlotter
+{
+  public:
+    PVPlotter(const char * Prefix, int Format, int Width, int Height,
+              SCNatural QueueSize = 8);
+    ~PVPlotter(void);           // loescht auch die Plots
+
+    void Add(PVPlot * Plot);
+    void Plot(void);
+    void Flush(void);
+
+  private:
+    struct PVSlot
+    {
+      PVPlotCanvas canvas;
+      char *       fileName;
+    };
+
+    char *          prefix;
+    PVPlotImage *   image;      // Rastern und Schreiben im Schreibthread
+    const int       width;
+    const int       height;
+    PVPlot **       plots;
+    int             numPlots;
+    int             maxPlots;
+    SCNatural       numReports;
+    PVSlot *        slots;
+    SCNatural       numSlots;
+    SCNatural       head;       // naechstes zu schreibendes Bild
+    SCNatural       count;      // gefuellte Plaetze
+    SCBoolean       stop;
+    pthread_mutex_t lock;
+    pthread_cond_t  filled;
+    pthread_cond_t  written;
+    pthread_t       writer;
+
+    static void * Write(void * Plotter);    // Schreibthread
+};
+
+#endif
@@ -0,0 +1,228 @@
+/******************************************************************************\
+ Datei : PVSurface.cpp
+ Inhalt: Implementierung der Zeichenflaeche PVSurface
+ Status:
+\******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "PVSurface.h"
+
+#if _SC_DMALLOC
+  #include <dmalloc.h>
+#endif
+
+// Motif-Farben in der Reihenfolge von PVSurface::foreground ... highlight,
+// farbig und monochrom
+static const char * motifColorName[PVSurface::numMotifColors][2] =
+{
+  {"Black",  "Black"},
+  {"ivory3", "White"},
+  {"White",  "White"},
+  {"ivory1", "ivory1"},
+  {"ivory4", "Black"},
+  {"Yellow", "Black"}
+};
+
+// Standardfarben der Kurven
+static const char * standardColorName[PVSurface::numColors] =
+{
+  "DarkGoldenRod", "Red", "DeepSkyBlue", "Firebrick",
+  "DarkSeaGreen", "ForestGreen", "IndianRed", "MediumPurple"
+};
+
+static const struct
+{
+  const char *  name;           // klein, ohne Leerzeichen
+  unsigned long rgb;
+} colorNames[] =
+{
+  {"black",        0x000000}, {"white",         0xFFFFFF},
+  {"red",          0xFF0000}, {"green",         0x00FF00},
+  {"blue",         0x0000FF}, {"yellow",        0xFFFF00},
+  {"cyan",         0x00FFFF}, {"magenta",       0xFF00FF},
+  {"orange",       0xFFA500}, {"gray",          0xBEBEBE},
+  {"grey",         0xBEBEBE}, {"brown",         0xA52A2A},
+  {"navy",         0x000080}, {"purple",        0xA020F0},
+  {"darkgoldenrod",0xB8860B}, {"deepskyblue",   0x00BFFF},
+  {"firebrick",    0xB22222}, {"darkseagreen",  0x8FBC8F},
+  {"forestgreen",  0x228B22}, {"indianred",     0xCD5C5C},
+  {"mediumpurple", 0x9370DB}, {"ivory1",        0xFFFFF0},
+  {"ivory3",       0xCDCDC1}, {"ivory4",        0x8B8B83},
+  {NULL,           0}
+};
+
+/******************************************************************************\
+ PVSurface Implementierung
+\******************************************************************************/
+
+PVSurface::PVSurface(void) :
+  mono (false)
+{
+  for (int i = 0; i < numMotifColors; i++) motif[i] = 0;
+}
+
+
+int PVSurface::TextWidth(const char * String) const
+{
+  return strlen(String) * charWidth;
+}
+
+
+const char * PVSurface::MotifColorName(int Which, SCBoolean Mono)
+{
+  return motifColorName[Which][Mono ? 1 : 0];
+}
+
+
+const char * PVSurface::ColorName(const char * ColorName, int & NextUnused)
+{
+  if (ColorName && *ColorName) return ColorName;
+  if (++NextUnused == numColors) NextUnused = 0;
+  return standardColorName[NextUnused];
+}
+
+
+SCBoolean PVSurface::RGB(const char * ColorName, unsigned long & RGB)
+{
+  char         key[32];
+  unsigned int rgb;
+  int          i, n;
+
+  if (ColorName[0] == '#' && strlen(ColorName) == 7 &&
+      sscanf(ColorName + 1, "%x", &rgb) == 1)
+  {
+    RGB = rgb;
+    return true;
+  }
+  for (n = 0; *ColorName && n < (int)sizeof(key) - 1; ColorName++)
+  {
+    if (*ColorName != ' ') key[n++] = tolower(*ColorName);
+  }
+  key[n] = '\0';
+  for (i = 0; colorNames[i].name; i++)
+  {
+    if (!strcmp(key, colorNames[i].name))
+    {
+      RGB = colorNames[i].rgb;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Simulation einer OSF/Motif Oberflaeche durch eigene Draw-Funktionen
+// -------------------------------------------------------------------
+
+void PVSurface::DrawSeparator(int Left, int Top, int Width, int Height)
+{
+  int X1  = Left;
+  int X2  = Left + Width;
+  int Y1  = Top;
+  int Y2  = Top + Height;
+  int XI1 = X1 + 1;
+  int XI2 = X2 - 1;
+  int YI1 = Y1 + 1;
+  int YI2 = Y2 - 1;
+
+  if (mono)
+  {
+    SetColor(motif[bottomShadow]);
+    SetDashed(true);
+  }
+  else
+  {
+    SetColor(motif[topShadow]);
+  }
+  Line(XI1, YI1, XI1, YI2); // vert
+  Line(XI1, YI1, XI2, YI1); // horz
+  Line(X2, Y1, X2, Y2);     // vert
+  Line(X1, Y2, X2, Y2);     // horz
+
+  if (mono)
+  {
+    SetDashed(false);
+  }
+  SetColor(motif[bottomShadow]);
+  Line(X1, Y1, X1, YI2);    // vert
+  Line(X1, Y1, XI2, Y1);    // horz
+  Line(XI2, YI1, XI2, YI2); // vert
+  Line(XI1, YI2, XI2, YI2); // horz
+}
+
+
+void PVSurface::DrawRaised(int Left, int Top, int Width, int Height)
+{
+  int X1  = Left;
+  int X2  = Left + Width;
+  int Y1  = Top;
+  int Y2  = Top + Height;
+  int XI1 = X1 + 1;
+  int XI2 = X2 - 1;
+  int YI1 = Y1 + 1;
+  int YI2 = Y2 - 1;
+
+  if (mono)
+  {
+    SetColor(motif[bottomShadow]);
+    SetDashed(true);
+  }
+  else
+  {
+    SetColor(motif[topShadow]);
+  }
+  Line(X1, Y1, X1, Y2);     // vert 1
+  Line(XI1, YI1, XI1, YI2); // vert 2
+  Line(X1, Y1, X2, Y1);     // horz 1
+  Line(XI1, YI1, XI2, YI1); // horz 2
+
+  if (mono)
+  {
+    SetDashed(false);
+  }
+  SetColor(motif[bottomShadow]);
+  Line(XI1, YI2, XI2, YI2); // horz 1
+  Line(X1, Y2, X2, Y2);     // horz 2
+  Line(XI2, YI1, XI2, YI2); // vert 1
+  Line(X2, Y1, X2, Y2);     // vert 2
+}
+
+
+void PVSurface::DrawLowered(int Left, int Top, int Width, int Height)
+{
+  int X1  = Left;
+  int X2  = Left + Width - 1;
+  int Y1  = Top;
+  int Y2  = Top + Height - 1;
+  int XI1 = X1 + 1;
+  int XI2 = X2 - 1;
+  int YI1 = Y1 + 1;
+  int YI2 = Y2 - 1;
+
+  if (mono)
+  {
+    SetColor(motif[bottomShadow]);
+    SetDashed(true);
+  }
+  else
+  {
+    SetColor(motif[topShadow]);
+  }
+  Line(XI1, YI2, XI2, YI2); // horz 1
+  Line(X1, Y2, X2, Y2);     // horz 2
+  Line(XI2, YI1, XI2, YI2); // vert 1
+  Line(X2, Y1, X2, Y2);     // vert 2
+
+  if (mono)
+  {
+    SetDashed(false);
+  }
+  SetColor(motif[bottomShadow]);
+  Line(X1, Y1, X1, Y2);     // vert 1
+  Line(XI1, YI1, XI1, YI2); // vert 2
+  Line(X1, Y1, X2, Y1);     // horz 1
+  Line(XI1, YI1, XI2, YI1); // horz 2
+}
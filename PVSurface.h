@@ -0,0 +1,90 @@
+/******************************************************************************\
+ Datei : PVSurface.h
+ Inhalt: Deklaration der Zeichenflaeche der Displays und Plots: PVPoint,
+         PVSurface
+ Status:
+\******************************************************************************/
+
+#ifndef __PVSURFACE_H
+#define __PVSURFACE_H
+
+#include <SCL/SCBasicTypes.h>
+
+/******************************************************************************\
+ PVPoint: Punkt eines Linienzugs, gleicher Aufbau wie XPoint (die X-Flaeche
+   reicht Linienzuege ohne Kopie an XDrawLines weiter).
+\******************************************************************************/
+
+struct PVPoint
+{
+  short x, y;
+};
+
+/******************************************************************************\
+ PVSurface: Zeichenflaeche, auf der die Diagramme (PVChart) und die Rahmen
+   gezeichnet werden. Implementiert wird sie fuer X (PVXSurface, zeichnet in
+   den Puffer eines PVDisplay) und fuer die Bilddateien (PVPlotCanvas haelt
+   die Befehle fest, PVPlotImage rastert bzw. schreibt sie). Farben sind
+   X-Pixelwerte oder RGB-Werte (0xrrggbb), je nach Flaeche; die Motif-Farben
+   und die Standardfarben der Kurven sind hier einmal als X11-Namen
+   festgelegt. Texte liegen mit der Grundlinie auf Y; ohne eigene Schriften
+   gilt die eingebaute 5x7-Schrift der Bilddateien.
+\******************************************************************************/
+
+class PVSurface
+{
+  public:
+    enum {left, center, right};                 // Ausrichtung von Text
+    enum {axisFont, boldFont, mediumFont};      // Schriften
+    enum {charWidth = 6, ascent = 7, descent = 2}; // eingebaute Schrift
+
+    enum                                        // Motif-Farben
+    {
+      foreground,                               // z.B. fuer Beschriftungen
+      background,                               // Standard 3D-Hintergrund
+      selected,                                 // Datenbereich
+      topShadow,                                // Aufhellung  (Erhebung)
+      bottomShadow,                             // Abdunkelung (Erhebung)
+      highlight,                                // Umriss um fokussiertes Element
+      numMotifColors
+    };
+    enum {numColors = 8};                       // Standardfarben der Kurven
+
+    PVSurface(void);
+    virtual ~PVSurface(void) {}
+
+    virtual void SetColor(unsigned long Color) = 0;
+    virtual void Line(int X1, int Y1, int X2, int Y2) = 0;
+    virtual void Lines(const PVPoint * Points, int Num) = 0;
+    virtual void FillRect(int X, int Y, int Width, int Height) = 0;
+    virtual void Text(int X, int Y, const char * String, int Align = left) = 0;
+    virtual void Clip(int X, int Y, int Width, int Height) = 0; // Width 0: alles
+
+    virtual void SetFont(int) {}
+    virtual int  TextWidth(const char * String) const;
+    virtual int  Ascent(void) const  {return ascent;}
+    virtual int  Descent(void) const {return descent;}
+    virtual void SetDashed(SCBoolean) {}        // nur monochrome X-Displays
+
+    unsigned long MotifColor(int Which) const {return motif[Which];}
+
+    // Rahmen im Motif-Stil (Farben topShadow und bottomShadow)
+    void DrawSeparator(int Left, int Top, int Width, int Height);
+    void DrawRaised(int Left, int Top, int Width, int Height);
+    void DrawLowered(int Left, int Top, int Width, int Height);
+
+    // X11-Namen der Farben; ColorName liefert ColorName selbst oder, bei NULL
+    // oder "", den Namen der naechsten Standardfarbe nach NextUnused
+    static const char * MotifColorName(int Which, SCBoolean Mono);
+    static const char * ColorName(const char * ColorName, int & NextUnused);
+
+    // RGB-Wert eines X11-Farbnamens (nur die hier benutzten und einige
+    // weitere Namen, gross/klein und Leerzeichen egal) oder "#rrggbb"
+    static SCBoolean RGB(const char * ColorName, unsigned long & RGB);
+
+  protected:
+    unsigned long motif[numMotifColors];  // von der Unterklasse gesetzt
+    SCBoolean     mono;                   // monochrom: Raender gestrichelt
+};
+
+#endif
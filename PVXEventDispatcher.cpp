@@ -22,8 +22,19 @@
 #endif
 
 PVXEventDispatcher::PVXEventDispatcher(void) :
-  displayList(true)
+  displayList (true),
+  revealed    (false),
+  indexSize   (64),
+  numIndexed  (0)
 {
+  SCNatural i;
+
+  index = new PVDisplay *[indexSize];
+  for (i = 0; i < indexSize; i++)
+  {
+    index[i] = NULL;
+  }
+
   xDpy = XOpenDisplay(NULL);  
   if (!xDpy)
   {
@@ -37,6 +48,7 @@ PVXEventDispatcher::~PVXEventDispatcher(void)
 {
   // remove PCController-Windows (must this be?)
   displayList.Remove(displayList.Head());
+  delete[] index;
 
   XCloseDisplay(xDpy);
 }
@@ -46,6 +58,7 @@ void PVXEventDispatcher::AddDisplay(PVDisplay* ToAdd)
 {
   if (ToAdd->GetSubDisplay()) AddDisplay(ToAdd->GetSubDisplay());
   displayList.InsertAfter(ToAdd);
+  Enter(ToAdd);
   XSelectInput(xDpy, ToAdd->GetXWin(), ToAdd->GetXEventMask());
 }  
 
@@ -59,9 +72,72 @@ void PVXEventDispatcher::RemoveDisplay(PVDisplay* ToRemove)
     RemoveDisplay(ToRemove->GetSubDisplay());
 
   displayList.Remove(ToRemove);
+  Reindex();
 }  
 
 
+SCNatural PVXEventDispatcher::Hash(Window XWin) const
+{
+  unsigned long h = (unsigned long)XWin;
+
+  h *= 0x9e3779b1UL;
+
+  return (h ^ (h >> 16)) & (indexSize - 1);
+}
+
+
+PVDisplay * PVXEventDispatcher::Lookup(Window XWin) const
+{
+  SCNatural i;
+
+  for (i = Hash(XWin); index[i]; i = (i + 1) & (indexSize - 1))
+  {
+    if (index[i]->GetXWin() == XWin) return index[i];
+  }
+  return NULL;
+}
+
+
+void PVXEventDispatcher::Enter(PVDisplay * ToEnter)
+{
+  SCNatural i;
+
+  if (2 * (numIndexed + 1) > indexSize)
+  {
+    delete[] index;
+    indexSize *= 2;
+    index = new PVDisplay *[indexSize];
+    Reindex();                  // enthaelt ToEnter schon (displayList)
+    return;
+  }
+  for (i = Hash(ToEnter->GetXWin()); index[i]; i = (i + 1) & (indexSize - 1));
+  index[i] = ToEnter;
+  numIndexed++;
+}
+
+
+// Baut den Index aus displayList neu auf (Loeschen waere bei offener
+// Adressierung aufwendiger, RemoveDisplay ist selten)
+void PVXEventDispatcher::Reindex(void)
+{
+  DispIter    diter(displayList);
+  PVDisplay * display;
+  SCNatural   i;
+
+  for (i = 0; i < indexSize; i++)
+  {
+    index[i] = NULL;
+  }
+  numIndexed = 0;
+  for (display = diter++; display; display = diter++)
+  {
+    for (i = Hash(display->GetXWin()); index[i]; i = (i + 1) & (indexSize - 1));
+    index[i] = display;
+    numIndexed++;
+  }
+}
+
+
 void PVXEventDispatcher::ArrangeDisplays(void)
 {
   assert(!displayList.IsEmpty()); // Displays muessen existieren
@@ -178,37 +254,75 @@ void PVXEventDispatcher::DoEvents(void)
 {
   PVDisplay * display;
   DispIter    diter(displayList);
-  XEvent      ev;
+  XEvent      ev, next;
+  int         x2, y2;
   
   while (XPending(xDpy))                  // solange X-Ereignisse vorliegen
   {
     XNextEvent(xDpy, &ev);                 // hole sie aus der Warteschlange 
-    for (diter.GoToFirst(), display = diter++;
-         display;
-	 display = diter++)
+    if (!(display = Lookup(ev.xany.window)))
     {
-      if (display->GetXWin() == ev.xany.window) break;
+      continue; // z.B. noch ausstehende Ereignisse entfernter Displays
     }
-    assert(display != 0); // Event fr unangemeldetes XWindow bekommen
     switch(ev.type)
     {
       case Expose:
-        if (ev.xexpose.count == 0) display->Paint();
+        // Alle vorliegenden Expose-Ereignisse des Fensters zu einem
+        // umschliessenden Rechteck zusammenfassen
+        while (XCheckTypedWindowEvent(xDpy, ev.xany.window, Expose, &next))
+        {
+          x2 = ev.xexpose.x + ev.xexpose.width;
+          y2 = ev.xexpose.y + ev.xexpose.height;
+          if (next.xexpose.x + next.xexpose.width > x2)
+            x2 = next.xexpose.x + next.xexpose.width;
+          if (next.xexpose.y + next.xexpose.height > y2)
+            y2 = next.xexpose.y + next.xexpose.height;
+          if (next.xexpose.x < ev.xexpose.x) ev.xexpose.x = next.xexpose.x;
+          if (next.xexpose.y < ev.xexpose.y) ev.xexpose.y = next.xexpose.y;
+          ev.xexpose.width = x2 - ev.xexpose.x;
+          ev.xexpose.height = y2 - ev.xexpose.y;
+        }
+        ev.xexpose.count = 0;
+        display->Exposed(ev.xexpose); // kopiert nur aus dem Puffer
         break;
 
       case ConfigureNotify:
+        // nur die letzte Groesse zaehlt
+        while (XCheckTypedWindowEvent(xDpy, ev.xany.window,
+                                      ConfigureNotify, &ev));
         if ((ev.xconfigure.width != display->GetWidth()) ||
             (ev.xconfigure.height != display->GetHeight()))
         {  
           display->Resized();
         }
         break;
+
+      // Unsichtbare Displays werden von UpdateDisplays uebergangen und
+      // beim naechsten Update nach dem Sichtbarwerden auf den aktuellen
+      // Stand gebracht (erst dort sind alle Ereignisse ausgewertet)
+      case MapNotify:
+        display->SetMapped(true);
+        revealed = true;
+        break;
+
+      case UnmapNotify:
+        display->SetMapped(false);
+        break;
+
+      case VisibilityNotify:
+        display->SetObscured(ev.xvisibility.state == VisibilityFullyObscured);
+        if (ev.xvisibility.state != VisibilityFullyObscured) revealed = true;
+        break;
       
       default: 
         display->Default(ev);
         break;
     }
   }
+  for (diter.GoToFirst(), display = diter++; display; display = diter++)
+  {
+    display->Flush();
+  }
   XFlush(xDpy);
 }
 
@@ -217,11 +331,17 @@ void PVXEventDispatcher::UpdateDisplays(void)
   DispIter    iter(displayList);
   PVDisplay * display;
 
+  revealed = false;
   for (display = iter++;
        display;
        display = iter++)
   {
+    if (!display->HasBuffer()) continue;   // Groesse noch unbekannt
+    if (!display->IsOutdated()) continue;  // Daten unveraendert
+    if (!display->IsVisible()) continue;   // ikonisiert oder verdeckt
     display->Update();
+    display->Updated();
+    display->Flush();
   }
 }
 
@@ -25,10 +25,13 @@ class PVXEventDispatcher
     void RemoveDisplay(PVDisplay* ToRemove);
     void ArrangeDisplays(void); // ordnet Displays und xmapped sie
     void UpdateDisplays(void);  // aktualisiert Anzeige (keine Expose-Ereignisse!)
+                                // und kopiert die Aenderungen ins Fenster
+    SCBoolean Pending(void) const {return XPending(xDpy) > 0;} // X-Ereignisse liegen vor
     void DoEvents(void);
     void WaitForEvent(void);
     
     Display* GetXDisplay(void) const   {return xDpy;}
+    SCBoolean Revealed(void) const     {return revealed;} // Display seit UpdateDisplays wieder sichtbar
     
   private:
     Display* xDpy;       // Verbindung zum Server
@@ -36,6 +39,18 @@ class PVXEventDispatcher
     typedef SCListIter<PVDisplay> DispIter;
       
     SCList<PVDisplay> displayList;  
+    SCBoolean         revealed;     // von DoEvents gesetzt, von UpdateDisplays geloescht
+
+    // Index Fenster -> Display fuer DoEvents (offene Adressierung, wie
+    // PEInstrument); wird bei RemoveDisplay neu aufgebaut
+    PVDisplay ** index;
+    SCNatural    indexSize;     // Zweierpotenz, hoechstens halb voll
+    SCNatural    numIndexed;
+
+    SCNatural   Hash(Window XWin) const;
+    PVDisplay * Lookup(Window XWin) const;  // NULL: unbekanntes Fenster
+    void        Enter(PVDisplay * ToEnter);
+    void        Reindex(void);
 };
 
 #endif